@@ -64,6 +64,8 @@ static void ejd_port(Dart_NativeArguments arguments);
 static void ejd_set_handle(Dart_NativeArguments args);
 static void ejd_get_handle(Dart_NativeArguments args);
 static void ejd_create_query(Dart_NativeArguments args);
+static void ejd_changes_subscribe(Dart_NativeArguments args);
+static void ejd_changes_unsubscribe(Dart_NativeArguments args);
 
 static void ejd_open_wrapped(Dart_Port receive_port, Dart_CObject *msg, Dart_Port reply_port);
 static void ejd_close_wrapped(Dart_Port receive_port, Dart_CObject *msg, Dart_Port reply_port);
@@ -88,6 +90,8 @@ static struct NativeFunctionLookup k_scoped_functions[] = {
   {"set_handle", ejd_set_handle},
   {"get_handle", ejd_get_handle},
   {"explain_rc", ejd_explain_rc},
+  {"changes_subscribe", ejd_changes_subscribe},
+  {"changes_unsubscribe", ejd_changes_unsubscribe},
   {0, 0}
 };
 
@@ -359,6 +363,7 @@ finish:
 typedef struct QCTX {
   bool aggregate_count;
   bool explain;
+  bool resume;
   bool paused;
   int pending_count;
   Dart_Port reply_port;
@@ -431,13 +436,14 @@ finish:
 
 static void ejd_exec_port_handler(Dart_Port receive_port, Dart_CObject *msg) {
   iwrc rc = 0;
-  Dart_CObject result = {.type = Dart_CObject_kNull};
+  Dart_CObject result = {.type = Dart_CObject_kNull}, rn1, rn2;
+  Dart_CObject *rn[] = {&rn1, &rn2};
   if (msg->type != Dart_CObject_kInt64 || !msg->value.as_int64)  {
     iwlog_error2("Invalid message recieved");
     return;
   }
   QCTX qctx = (void *) msg->value.as_int64;
-  IWXSTR *exlog = 0;
+  IWXSTR *exlog = 0, *next = 0;
   EJDB_EXEC ux = {0};
   EJDB2Context *dctx = qctx->dctx;
 
@@ -452,6 +458,13 @@ static void ejd_exec_port_handler(Dart_Port receive_port, Dart_CObject *msg) {
       goto finish;
     }
   }
+  if (qctx->resume) {
+    next = iwxstr_new();
+    if (!next) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      goto finish;
+    }
+  }
 
   qctx->aggregate_count = jql_has_aggregate_count(qctx->q);
 
@@ -460,6 +473,7 @@ static void ejd_exec_port_handler(Dart_Port receive_port, Dart_CObject *msg) {
   ux.visitor = qctx->aggregate_count ? 0 : ejd_exec_visitor;
   ux.opaque = qctx;
   ux.log = exlog;
+  ux.next = next;
   ux.limit = qctx->limit;
 
   rc = ejdb_exec(&ux);
@@ -485,6 +499,18 @@ static void ejd_exec_port_handler(Dart_Port receive_port, Dart_CObject *msg) {
     result.type = Dart_CObject_kString;
     result.value.as_string = iwxstr_ptr(exlog);
   }
+  if (next) { // Last message is [log or null, resume token or null]
+    rn1 = result;
+    if (iwxstr_size(next)) {
+      rn2.type = Dart_CObject_kString;
+      rn2.value.as_string = iwxstr_ptr(next);
+    } else {
+      rn2.type = Dart_CObject_kNull;
+    }
+    result.type = Dart_CObject_kArray;
+    result.value.as_array.length = sizeof(rn) / sizeof(rn[0]);
+    result.value.as_array.values = rn;
+  }
 
 finish:
   if (rc) {
@@ -492,11 +518,14 @@ finish:
     EJPORT_RC(&result, rc);
   }
   if (qctx->reply_port != ILLEGAL_PORT) {
-    Dart_PostCObject(qctx->reply_port, &result); // Last NULL or error(int)
+    Dart_PostCObject(qctx->reply_port, &result); // Last NULL, log, [log, next] or error(int)
   }
   if (exlog) {
     iwxstr_destroy(exlog);
   }
+  if (next) {
+    iwxstr_destroy(next);
+  }
   Dart_CloseNativePort(receive_port);
 }
 
@@ -505,7 +534,7 @@ static void ejd_exec(Dart_NativeArguments args) {
 
   iwrc rc = 0;
   intptr_t qptr, ptr = 0;
-  bool explain = false;
+  bool explain = false, resume = false;
   int64_t limit = 0;
   QCTX qctx = 0;
 
@@ -519,6 +548,7 @@ static void ejd_exec(Dart_NativeArguments args) {
 
   EJTH(Dart_GetNativeBooleanArgument(args, 2, &explain));
   EJTH(Dart_GetNativeIntegerArgument(args, 3, &limit));
+  EJTH(Dart_GetNativeBooleanArgument(args, 4, &resume));
   EJTH(Dart_SendPortGetId(hport, &reply_port));
 
   EJTH(Dart_GetNativeInstanceField(hdb, 0, &ptr));
@@ -557,6 +587,7 @@ static void ejd_exec(Dart_NativeArguments args) {
   qctx->q = (void *) qptr;
   qctx->dctx = dctx;
   qctx->explain = explain;
+  qctx->resume = resume;
   qctx->limit = limit;
 
   // Now post a message to the query executor
@@ -1321,6 +1352,120 @@ finish:
   Dart_PostCObject(reply_port, &result);
 }
 
+// Changes stream subscription
+typedef struct EJDCHGS {
+  Dart_Port port; /**< Dart stream port receiving change events */
+} EJDCHGS;
+
+static void ejd_changes_listener(EJDB db, EJDB_CHANGE ev, void *op) {
+  iwrc rc = 0;
+  EJDCHGS *chs = op;
+  Dart_CObject result, rv1, rv2, rv3, rv4, rv5;
+  Dart_CObject *rv[5] = {&rv1, &rv2, &rv3, &rv4, &rv5};
+
+  IWXSTR *xstr = iwxstr_new();
+  if (!xstr) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  rc = jbl_as_json(ev->doc, jbl_xstr_json_printer, xstr, 0);
+  RCGO(rc, finish);
+
+  rv1.type = Dart_CObject_kInt64;
+  rv1.value.as_int64 = (int64_t) ev->seq;
+  rv2.type = Dart_CObject_kString;
+  rv2.value.as_string = ev->op == EJDB_CHANGE_DEL ? "del" : "put";
+  rv3.type = Dart_CObject_kString;
+  rv3.value.as_string = (char *) ev->coll;
+  rv4.type = Dart_CObject_kInt64;
+  rv4.value.as_int64 = ev->id;
+  rv5.type = Dart_CObject_kString;
+  rv5.value.as_string = iwxstr_ptr(xstr);
+  result.type = Dart_CObject_kArray;
+  result.value.as_array.length = sizeof(rv) / sizeof(rv[0]);
+  result.value.as_array.values = rv;
+  // Writer is never blocked by stream consumer, lost event is seen as a gap in `seq`
+  Dart_PostCObject(chs->port, &result);
+
+finish:
+  if (rc) {
+    iwlog_ecode_error3(rc);
+  }
+  if (xstr) {
+    iwxstr_destroy(xstr);
+  }
+}
+
+// EJDB2._changes_subscribe(SendPort port) -> subscription handle
+static void ejd_changes_subscribe(Dart_NativeArguments args) {
+  iwrc rc = 0;
+  intptr_t ptr = 0;
+  EJDCHGS *chs = 0;
+  Dart_EnterScope();
+  Dart_Handle ret = Dart_Null();
+
+  Dart_Handle self = EJTH(Dart_GetNativeArgument(args, 0));
+  EJTH(Dart_GetNativeInstanceField(self, 0, &ptr));
+  EJDB2Context *ctx = (void *) ptr;
+  if (!ctx || !ctx->dbh || !ctx->dbh->db) {
+    rc = EJD_ERROR_INVALID_STATE;
+    goto finish;
+  }
+  Dart_Port port = ILLEGAL_PORT;
+  EJTH(Dart_SendPortGetId(EJTH(Dart_GetNativeArgument(args, 1)), &port));
+  chs = malloc(sizeof(*chs));
+  if (!chs) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  chs->port = port;
+  rc = ejdb_changes_subscribe(ctx->dbh->db, ejd_changes_listener, chs);
+  RCGO(rc, finish);
+  ret = Dart_NewInteger((intptr_t) chs);
+
+finish:
+  if (rc) {
+    free(chs);
+    ret = ejd_error_rc_create(rc);
+  }
+  Dart_SetReturnValue(args, ret);
+  Dart_ExitScope();
+}
+
+// EJDB2._changes_unsubscribe(int handle)
+static void ejd_changes_unsubscribe(Dart_NativeArguments args) {
+  iwrc rc = 0;
+  intptr_t ptr = 0;
+  int64_t hptr = 0;
+  Dart_EnterScope();
+  Dart_Handle ret = Dart_Null();
+
+  Dart_Handle self = EJTH(Dart_GetNativeArgument(args, 0));
+  EJTH(Dart_GetNativeInstanceField(self, 0, &ptr));
+  EJTH(Dart_GetNativeIntegerArgument(args, 1, &hptr));
+  EJDB2Context *ctx = (void *) ptr;
+  if (!ctx || !ctx->dbh || !ctx->dbh->db) {
+    rc = EJD_ERROR_INVALID_STATE;
+    goto finish;
+  }
+  if (hptr < 1) {
+    rc = EJD_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  EJDCHGS *chs = (void *) hptr;
+  // Listener is never called after unsubscribe returns so `chs` can be released
+  rc = ejdb_changes_unsubscribe(ctx->dbh->db, ejd_changes_listener, chs);
+  RCGO(rc, finish);
+  free(chs);
+
+finish:
+  if (rc) {
+    ret = ejd_error_rc_create(rc);
+  }
+  Dart_SetReturnValue(args, ret);
+  Dart_ExitScope();
+}
+
 static void ejd_info_wrapped(Dart_Port receive_port, Dart_CObject *msg, Dart_Port reply_port) {
   iwrc rc = 0;
   Dart_CObject result, rv1;
@@ -87,6 +87,25 @@ class JBDOC {
   String toString() => '$runtimeType: $id $json';
 }
 
+/// Document change event emitted by [EJDB2.changes] stream
+class JBCHG extends JBDOC {
+  JBCHG(this.seq, this.op, this.collection, int id, String json) : super(id, json);
+  JBCHG._fromList(List list)
+      : this(list[0] as int, list[1] as String, list[2] as String, list[3] as int, list[4] as String);
+
+  /// Change sequence number, gap in sequence means lost events
+  final int seq;
+
+  /// Change type: `put` or `del`
+  final String op;
+
+  /// Collection name
+  final String collection;
+
+  @override
+  String toString() => '$runtimeType: $seq $op $collection $id $json';
+}
+
 /// Represents query on ejdb collection.
 /// Instance can be reused for multiple queries reusing
 /// placeholder parameters.
@@ -103,9 +122,12 @@ class JQL extends NativeFieldWrapperClass2 {
   /// Execute query and returns a stream of matched documents.
   ///
   /// [explainCallback] Used to get query execution log.
+  /// [resumeCallback] Used to get resume token of the last visited document when result set is read till the end.
+  /// Token can be passed to the next query via `| after :placeholder` to continue from where this one stopped.
+  /// Not called if query cannot be resumed.
   /// [limit] Overrides `limit` set by query text for this execution session.
   ///
-  Stream<JBDOC> execute({void explainCallback(String log), int limit = 0}) {
+  Stream<JBDOC> execute({void explainCallback(String log), void resumeCallback(String next), int limit = 0}) {
     abort();
     var execHandle = 0;
     _controller = StreamController<JBDOC>();
@@ -116,6 +138,15 @@ class JQL extends NativeFieldWrapperClass2 {
         _replyPort.close();
         _controller.addError(EJDB2Error.fromCode(reply));
         return;
+      } else if (reply is List && reply.length == 2) { // End of result set with resume token
+        _exec_check(execHandle, true);
+        if (reply[0] is String && explainCallback != null) {
+          explainCallback(reply[0] as String);
+        }
+        if (reply[1] != null && resumeCallback != null) {
+          resumeCallback(reply[1] as String);
+        }
+        abort();
       } else if (reply is List) {
         _exec_check(execHandle, false);
         if (reply[2] != null && explainCallback != null) {
@@ -130,7 +161,7 @@ class JQL extends NativeFieldWrapperClass2 {
         abort();
       }
     };
-    execHandle = _exec(_replyPort.sendPort, explainCallback != null, limit);
+    execHandle = _exec(_replyPort.sendPort, explainCallback != null, limit, resumeCallback != null);
     return _controller.stream;
   }
 
@@ -251,7 +282,7 @@ class JQL extends NativeFieldWrapperClass2 {
 
   void _set(dynamic placeholder, dynamic value, [int type]) native 'jql_set';
 
-  int _exec(SendPort sendPort, bool explain, int limit) native 'exec';
+  int _exec(SendPort sendPort, bool explain, int limit, bool resume) native 'exec';
 
   void _exec_check(int execHandle, bool terminate) native 'check_exec';
 }
@@ -260,6 +291,9 @@ class JQL extends NativeFieldWrapperClass2 {
 class EJDB2 extends NativeFieldWrapperClass2 {
   EJDB2._();
 
+  /// Active changes streams and their unsubscribe functions
+  final _changes = <StreamController<JBCHG>, void Function()>{};
+
   static bool _checkCompleterPortError(Completer<dynamic> completer, dynamic reply) {
     if (reply is int) {
       completer.completeError(EJDB2Error(reply, ejdb2ExplainRC(reply)));
@@ -348,6 +382,11 @@ class EJDB2 extends NativeFieldWrapperClass2 {
     if (hdb == null) {
       return Future.value();
     }
+    // Changes listeners must be removed while database handle is alive
+    for (final e in _changes.entries.toList()) {
+      e.value();
+      e.key.close();
+    }
     final completer = Completer<void>();
     final replyPort = RawReceivePort();
     replyPort.handler = (dynamic reply) {
@@ -565,6 +604,50 @@ class EJDB2 extends NativeFieldWrapperClass2 {
     return completer.future;
   }
 
+  /// Returns stream of document changes made after the stream is listened.
+  /// Events are delivered asynchronously and never block writers,
+  /// lost events are seen as gaps in [JBCHG.seq].
+  /// Stream is closed when subscription is cancelled or database is closed.
+  Stream<JBCHG> changes() {
+    StreamController<JBCHG> controller;
+    RawReceivePort eventsPort;
+    int handle;
+
+    void unsubscribe() {
+      _changes.remove(controller);
+      if (handle != null) {
+        final h = handle;
+        handle = null;
+        _changes_unsubscribe(h);
+      }
+      eventsPort?.close();
+      eventsPort = null;
+    }
+
+    controller = StreamController<JBCHG>(onListen: () {
+      if (_get_handle() == null) {
+        controller.addError(EJDB2Error.invalidState());
+        controller.close();
+        return;
+      }
+      eventsPort = RawReceivePort((dynamic ev) {
+        if (handle != null) {
+          controller.add(JBCHG._fromList(ev as List));
+        }
+      });
+      try {
+        handle = _changes_subscribe(eventsPort.sendPort);
+      } catch (e) {
+        unsubscribe();
+        controller.addError(e);
+        controller.close();
+        return;
+      }
+      _changes[controller] = unsubscribe;
+    }, onCancel: unsubscribe);
+    return controller.stream;
+  }
+
   /// Create instance of [query] specified for [collection].
   /// If [collection] is not specified a [query] spec must contain collection name,
   /// eg: `@mycollection/[foo=bar]`
@@ -611,6 +694,10 @@ class EJDB2 extends NativeFieldWrapperClass2 {
   void _set_handle(int handle) native 'set_handle';
 
   int _get_handle() native 'get_handle';
+
+  int _changes_subscribe(SendPort port) native 'changes_subscribe';
+
+  void _changes_unsubscribe(int handle) native 'changes_unsubscribe';
 }
 
 String _asJsonString(Object val) {
@@ -125,6 +125,16 @@ void main() async {
         log.contains("[INDEX] SELECTED UNIQUE|STR|1 /foo EXPR1: 'foo = :?' INIT: IWKV_CURSOR_EQ"));
   });
 
+  // Test resume token
+  String next;
+  var page = await db.createQuery('@mycoll/*').execute(resumeCallback: (n) {
+    next = n;
+  }).toList();
+  assert(page.length == 1);
+  assert(next != null);
+  page = await db.createQuery('@mycoll/* | after :?').setString(0, next).execute().toList();
+  assert(page.isEmpty);
+
   doc = await db
       .createQuery('@mycoll/[foo=:?] and /[baz=:?]')
       .setString(0, 'baz')
@@ -185,6 +195,23 @@ void main() async {
   }
   assert(cnt == 10000);
 
+  // Changes stream
+  final events = <JBCHG>[];
+  final csub = db.changes().listen(events.add);
+  final cid = await db.put('cc2', {'chg': 1});
+  await db.del('cc2', cid);
+  while (events.length < 2) {
+    await Future.delayed(Duration(milliseconds: 10));
+  }
+  await csub.cancel();
+  assert(events[0].op == 'put');
+  assert(events[0].collection == 'cc2');
+  assert(events[0].id == cid);
+  assert(events[0].json == '{"chg":1}');
+  assert(events[1].op == 'del');
+  assert(events[1].id == cid);
+  assert(events[1].seq == events[0].seq + 1);
+
   final ts0 = DateTime.now().millisecondsSinceEpoch;
   final ts = await db.onlineBackup('hello-bkp.db');
   assert(ts > ts0);
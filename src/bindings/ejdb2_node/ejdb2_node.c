@@ -1294,6 +1294,194 @@ finish:
   return ret ? ret : jn_undefined(env);
 }
 
+//  ---------------- EJDB2.changes()
+
+typedef struct JNCHGS { // changes subscription
+  JBN jbn;
+  napi_threadsafe_function tsf;
+} *JNCHGS;
+
+typedef struct JNCHG { // call data to changes `tsf`
+  uint64_t seq;
+  ejdb_change_t op;
+  int64_t id;
+  char *coll;
+  IWXSTR *json;
+} *JNCHG;
+
+static void jn_chg_destroy(JNCHG *chgp) {
+  if (!chgp || !*chgp) {
+    return;
+  }
+  JNCHG chg = *chgp;
+  free(chg->coll);
+  if (chg->json) {
+    iwxstr_destroy(chg->json);
+  }
+  free(chg);
+  *chgp = 0;
+}
+
+// function (seq, op, collection, id, json)
+static void jn_changes_call_mt(napi_env env, napi_value js_cb, void *context, void *data) {
+  JNCHG chg = data;
+  napi_status ns;
+  napi_value vresult;
+  if (!env) { // shutdown pending
+    goto finish;
+  }
+  napi_value vseq = jn_create_int64(env, (int64_t) chg->seq);
+  napi_value vop = jn_create_string(env, chg->op == EJDB_CHANGE_DEL ? "del" : "put");
+  napi_value vcoll = jn_create_string(env, chg->coll);
+  napi_value vid = jn_create_int64(env, chg->id);
+  napi_value vjson = jn_create_string(env, iwxstr_ptr(chg->json));
+  napi_value vundefined = jn_undefined(env);
+  if (!vseq || !vop || !vcoll || !vid || !vjson || !vundefined) {
+    goto finish;
+  }
+  napi_value argv[] = {vseq, vop, vcoll, vid, vjson};
+  JNGO(ns, env, napi_call_function(
+         env,
+         vundefined,
+         js_cb,
+         sizeof(argv) / sizeof(argv[0]),
+         argv,
+         &vresult
+       ), finish);
+
+finish:
+  jn_chg_destroy(&chg);
+}
+
+// Called by database writer thread
+static void jn_changes_listener(EJDB db, EJDB_CHANGE ev, void *op) {
+  iwrc rc = 0;
+  JNCHGS chs = op;
+  JNCHG chg = calloc(1, sizeof(*chg));
+  if (!chg) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  chg->seq = ev->seq;
+  chg->op = ev->op;
+  chg->id = ev->id;
+  chg->coll = strdup(ev->coll);
+  chg->json = iwxstr_new();
+  if (!chg->coll || !chg->json) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  rc = jbl_as_json(ev->doc, jbl_xstr_json_printer, chg->json, 0);
+  RCGO(rc, finish);
+  // Writer is never blocked by slow consumer, dropped event is seen as a gap in `seq`
+  if (napi_call_threadsafe_function(chs->tsf, chg, napi_tsfn_nonblocking) == napi_ok) {
+    chg = 0;
+  }
+
+finish:
+  if (rc) {
+    iwlog_ecode_error3(rc);
+  }
+  jn_chg_destroy(&chg);
+}
+
+// this._impl.changes_subscribe(fn) -> subscription handle
+static napi_value jn_changes_subscribe(napi_env env, napi_callback_info info) {
+  iwrc rc = 0;
+  napi_status ns;
+  napi_value ret = 0, argv, this;
+  size_t argc = 1;
+  void *data;
+  napi_valuetype vtype;
+  JBN jbn;
+  JNCHGS chs = 0;
+
+  JNGO(ns, env, napi_get_cb_info(env, info, &argc, &argv, &this, &data), finish);
+  if (argc != 1) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  JNGO(ns, env, napi_typeof(env, argv, &vtype), finish);
+  if (vtype != napi_function) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  JNGO(ns, env, napi_unwrap(env, this, (void **) &jbn), finish);
+  if (!jbn->db) {
+    rc = JN_ERROR_INVALID_STATE;
+    goto finish;
+  }
+  chs = calloc(1, sizeof(*chs));
+  if (!chs) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  chs->jbn = jbn;
+  JNGO(ns, env, napi_create_threadsafe_function(
+         env, // napi_env env,
+         argv, // napi_value func,
+         0,   // napi_value async_resource,
+         jn_create_string(env, "jn_changes"), // napi_value async_resource_name,
+         1024, // size_t max_queue_size,
+         1,   // size_t initial_thread_count,
+         0,   // void* thread_finalize_data,
+         0,   // napi_finalize thread_finalize_cb,
+         0,   // void* context,
+         jn_changes_call_mt,  // napi_threadsafe_function_call_js call_js_cb,
+         &chs->tsf // napi_threadsafe_function* result
+       ), finish);
+  // Subscription does not keep event loop alive
+  JNGO(ns, env, napi_unref_threadsafe_function(env, chs->tsf), finish);
+  JNGO(ns, env, napi_create_external(env, chs, 0, 0, &ret), finish);
+  rc = ejdb_changes_subscribe(jbn->db, jn_changes_listener, chs);
+
+finish:
+  if (rc || jn_is_exception_pending(env)) {
+    JNRC(env, rc);
+    if (chs) {
+      if (chs->tsf) {
+        napi_release_threadsafe_function(chs->tsf, napi_tsfn_abort);
+      }
+      free(chs);
+    }
+    return jn_undefined(env);
+  }
+  return ret;
+}
+
+// this._impl.changes_unsubscribe(handle)
+static napi_value jn_changes_unsubscribe(napi_env env, napi_callback_info info) {
+  iwrc rc = 0;
+  napi_status ns;
+  napi_value argv, this;
+  size_t argc = 1;
+  void *data;
+  JNCHGS chs;
+
+  JNGO(ns, env, napi_get_cb_info(env, info, &argc, &argv, &this, &data), finish);
+  if (argc != 1) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  JNGO(ns, env, napi_get_value_external(env, argv, (void **) &chs), finish);
+  if (!chs) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  if (chs->jbn->db) {
+    // Listener is not called after return
+    rc = ejdb_changes_unsubscribe(chs->jbn->db, jn_changes_listener, chs);
+  }
+  napi_release_threadsafe_function(chs->tsf, napi_tsfn_release);
+  free(chs);
+
+finish:
+  if (rc) {
+    JNRC(env, rc);
+  }
+  return jn_undefined(env);
+}
+
 // ---------------- jql_init
 
 typedef struct JNQL {
@@ -1388,6 +1576,7 @@ typedef struct JNQS { // query stream associated data
   JNQL jnql;
   napi_ref stream_ref;      // Reference to the stream object
   napi_ref explain_cb_ref;  // Reference to the optional explain callback
+  napi_ref resume_cb_ref;   // Reference to the optional resume token callback
   int64_t limit;
   struct JNWORK work;
   pthread_mutex_t mtx;
@@ -1398,6 +1587,7 @@ typedef struct JNCS { // call data to `k_add_stream_tsfn`
   bool has_count;
   IWXSTR *log;
   IWXSTR *document;
+  IWXSTR *next;        // resume token of the last visited document, sent with stream close event
   int64_t count;
   int64_t document_id;
   napi_ref stream_ref; // copied from `JNQS`
@@ -1414,11 +1604,14 @@ static void jn_cs_destroy(JNCS *csp) {
   if (cs->log) {
     iwxstr_destroy(cs->log);
   }
+  if (cs->next) {
+    iwxstr_destroy(cs->next);
+  }
   free(cs);
   *csp = 0;
 }
 
-// function addStreamResult(stream, id, jsondoc, log)
+// function addStreamResult(stream, id, jsondoc, log, next)
 static void jn_add_stream_result_call_mt(napi_env env,
                                          napi_value js_add_stream,
                                          void *context,
@@ -1432,7 +1625,7 @@ static void jn_add_stream_result_call_mt(napi_env env,
 
   JNCS cs = data;
   napi_status ns;
-  napi_value vstream, vid, vdoc, vlog, vresult;
+  napi_value vstream, vid, vdoc, vlog, vnext, vresult;
   napi_value vglobal = jn_global(env);
   napi_value vnull = jn_null(env);
 
@@ -1464,8 +1657,13 @@ static void jn_add_stream_result_call_mt(napi_env env,
   } else {
     vlog = vnull;
   }
+  if (cs->next && iwxstr_size(cs->next)) {
+    vnext = jn_create_string(env, iwxstr_ptr(cs->next));
+  } else {
+    vnext = vnull;
+  }
 
-  napi_value argv[] = {vstream, vid, vdoc, vlog};
+  napi_value argv[] = {vstream, vid, vdoc, vlog, vnext};
   const int argc = sizeof(argv) / sizeof(argv[0]);
   JNGO(ns, env, napi_call_function(
          env,
@@ -1500,6 +1698,10 @@ static void jn_jnqs_destroy_mt(napi_env env, JNQS *qsp) {
     napi_reference_unref(env, qs->explain_cb_ref, &rcnt);
     napi_delete_reference(env, qs->explain_cb_ref);
   }
+  if (qs->resume_cb_ref) {
+    napi_reference_unref(env, qs->resume_cb_ref, &rcnt);
+    napi_delete_reference(env, qs->resume_cb_ref);
+  }
   free(qs);
 }
 
@@ -1553,6 +1755,7 @@ static iwrc jn_jql_stream_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
   cs->log = ux->log;
   cs->document_id = doc->id;
   cs->document = xstr;
+  cs->next = 0;
 
   napi_status ns = napi_call_threadsafe_function(qs->jbn->resultset_tsf, cs, napi_tsfn_blocking);
   if (ns) {
@@ -1595,6 +1798,13 @@ static void jn_jql_stream_execute(napi_env env, void *data) {
       goto finish;
     }
   }
+  if (qs->resume_cb_ref) {
+    ux.next = iwxstr_new();
+    if (!ux.next) {
+      work->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      goto finish;
+    }
+  }
 
   ux.q = q;
   ux.db = qs->jbn->db;
@@ -1619,7 +1829,9 @@ static void jn_jql_stream_execute(napi_env env, void *data) {
   cs->log = ux.log;
   cs->document_id = -1;
   cs->document = 0;
+  cs->next = ux.next;
   ux.log = 0;
+  ux.next = 0;
 
   napi_status ns = napi_call_threadsafe_function(qs->jbn->resultset_tsf, cs, napi_tsfn_blocking);
   if (ns) {
@@ -1631,6 +1843,9 @@ finish:
   if (ux.log) {
     iwxstr_destroy(ux.log);
   }
+  if (ux.next) {
+    iwxstr_destroy(ux.next);
+  }
   if (work->rc) {
     jn_cs_destroy(&cs);
   }
@@ -1732,7 +1947,7 @@ finish:
 static napi_value jn_jql_stream_attach(napi_env env, napi_callback_info info) {
   iwrc rc = 0;
   napi_status ns;
-  napi_value ret = 0, argv[3], this, vexplain;
+  napi_value ret = 0, argv[3], this, vexplain, vresume;
   size_t argc = sizeof(argv) / sizeof(argv[0]);
   void *data;
 
@@ -1774,6 +1989,16 @@ static napi_value jn_jql_stream_attach(napi_env env, napi_callback_info info) {
     }
     JNGO(ns, env, napi_create_reference(env, vexplain, 1, &qs->explain_cb_ref), finish);
   }
+  JNGO(ns, env, napi_get_element(env, argv[2], 2, &vresume), finish);
+  if (!jn_is_null_or_undefined(env, vresume)) {
+    napi_valuetype vtype;
+    JNGO(ns, env, napi_typeof(env, vresume, &vtype), finish);
+    if (vtype != napi_function) {
+      rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+      goto finish;
+    }
+    JNGO(ns, env, napi_create_reference(env, vresume, 1, &qs->resume_cb_ref), finish);
+  }
   JNGO(ns, env, napi_unwrap(env, this, (void **) &jbn), finish);
   JNGO(ns, env, napi_create_reference(env, argv[1], 1, &qs->stream_ref), finish); // Reference to stream
   JNGO(ns, env, napi_wrap(env, argv[1], qs, 0, 0, 0), finish);
@@ -2000,6 +2225,8 @@ napi_value Init(napi_env env, napi_value exports) {
     JNFUNC(index),
     JNFUNC(rmcoll),
     JNFUNC(online_backup),
+    JNFUNC(changes_subscribe),
+    JNFUNC(changes_unsubscribe),
     JNFUNC(jql_init),
     JNFUNC(jql_set),
     JNFUNC(jql_limit),
@@ -69,6 +69,28 @@ declare namespace ejdb2_node {
 
   interface JBDOCStream extends NodeJS.ReadableStream {}
 
+  /**
+   * Document change event.
+   */
+  interface JBCHG extends JBDOC {
+    /**
+     * Change sequence number, gap in sequence means dropped events
+     */
+    seq: number;
+
+    /**
+     * Change type
+     */
+    op: 'put' | 'del';
+
+    /**
+     * Collection name
+     */
+    collection: string;
+  }
+
+  interface JBCHGStream extends NodeJS.ReadableStream {}
+
   /**
    * Query execution options.
    */
@@ -82,6 +104,14 @@ declare namespace ejdb2_node {
      * Calback used to get query execution log.
      */
     explainCallback?: (log: string) => void;
+
+    /**
+     * Callback used to get resume token of the last document read from stream.
+     * Token is passed to the next query via `| after :placeholder` to continue
+     * from where result set was left off. Not called if query cannot be resumed
+     * or stream was destroyed before the end of result set.
+     */
+    resumeCallback?: (next: string) => void;
   }
 
   /**
@@ -454,6 +484,13 @@ declare namespace ejdb2_node {
      * finish time as number of milliseconds since epoch.
      */
     onlineBackup(fileName: string): Promise<number>;
+
+    /**
+     * Returns readable stream of document changes made by
+     * `put`, `patch`, `del` and queries with `apply` or `del`.
+     * Destroy stream to unsubscribe.
+     */
+    changes(): JBCHGStream;
   }
 }
 
@@ -95,6 +95,69 @@ class JBDOC {
   }
 }
 
+/**
+ * Document change event.
+ */
+class JBCHG extends JBDOC {
+
+  /**
+   * @param {number} seq Change sequence number
+   * @param {string} op Change type: `put` or `del`
+   * @param {string} collection Collection name
+   * @param {number} id Document ID
+   * @param {string} raw Stored or removed document JSON as string
+   */
+  constructor(seq, op, collection, id, raw) {
+    super(id, raw);
+    this.seq = seq;
+    this.op = op;
+    this.collection = collection;
+  }
+
+  toString() {
+    return `JBCHG: ${this.seq} ${this.op} ${this.collection} ${super.toString()}`;
+  }
+}
+
+/**
+ * Stream of document changes.
+ */
+class JBCHGStream extends Readable {
+
+  /**
+   * @param {EJDB2} db
+   */
+  constructor(db) {
+    super({
+      objectMode: true
+    });
+    this.db = db;
+    this._handle = db._impl.changes_subscribe((seq, op, collection, id, raw) => {
+      if (this._handle != null) {
+        this.push(new JBCHG(seq, op, collection, id, raw));
+      }
+    });
+    db._changes.add(this);
+  }
+
+  _read() {
+  }
+
+  _destroy(err, callback) {
+    if (this._handle != null) {
+      const handle = this._handle;
+      this._handle = null;
+      this.db._changes.delete(this);
+      try {
+        this.db._impl.changes_unsubscribe(handle);
+      } catch (e) {
+        err = err || e;
+      }
+    }
+    callback(err);
+  }
+}
+
 /**
  * EJDB Query resultset stream.
  */
@@ -123,7 +186,7 @@ class JBDOCStream extends Readable {
     this._aborted = false;
     this.jql = jql;
     this.opts = opts;
-    this.promise = this._impl.jql_stream_attach(jql, this, [opts.limit, opts.explainCallback])
+    this.promise = this._impl.jql_stream_attach(jql, this, [opts.limit, opts.explainCallback, opts.resumeCallback])
                        .catch((err) => this.destroy(err));
   }
 
@@ -186,7 +249,7 @@ class JBDOCStream extends Readable {
 }
 
 // Global module function for add results to query stream
-function addStreamResult(stream, id, jsondoc, log) {
+function addStreamResult(stream, id, jsondoc, log, next) {
   if (stream._destroyed) {
     return;
   }
@@ -194,6 +257,10 @@ function addStreamResult(stream, id, jsondoc, log) {
     stream.opts.explainCallback(log);
     delete stream.opts.explainCallback;
   }
+  if (next != null && stream.opts.resumeCallback != null) {
+    stream.opts.resumeCallback(next);
+    delete stream.opts.resumeCallback;
+  }
 
   const count = (typeof jsondoc === 'number');
   if (id >= 0 || count) {
@@ -493,6 +560,7 @@ class EJDB2 {
 
   constructor(args) {
     this._impl = new EJDB2Impl(args);
+    this._changes = new Set();
   }
 
   /**
@@ -500,6 +568,9 @@ class EJDB2 {
    * @return {Promise<void>}
    */
   close() {
+    for (const stream of Array.from(this._changes)) {
+      stream.destroy();
+    }
     return this._impl.close();
   }
 
@@ -711,6 +782,18 @@ class EJDB2 {
   onlineBackup(fileName) {
     return this._impl.online_backup(fileName);
   }
+
+  /**
+   * Returns readable stream of document changes made by
+   * `put`, `patch`, `del` and queries with `apply` or `del`.
+   * Events are delivered in order of their `seq` numbers,
+   * gap in sequence means dropped events. Destroy stream to unsubscribe.
+   *
+   * @returns {ReadableStream<JBCHG>}
+   */
+  changes() {
+    return new JBCHGStream(this);
+  }
 }
 
 module.exports = {
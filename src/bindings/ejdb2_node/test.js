@@ -166,6 +166,18 @@ test('Main', async (t) => {
   assert.isString(log);
   t.true(log.indexOf('[INDEX] MATCHED  UNIQUE|STR|1 /foo EXPR1: \'foo = :?\' INIT: IWKV_CURSOR_EQ') != -1);
 
+  // Test resume token
+  let next = null;
+  let page = await db.createQuery('@mycoll/*').list({
+    resumeCallback: (n) => {
+      next = n;
+    }
+  });
+  t.is(page.length, 1);
+  assert.isString(next);
+  page = await db.createQuery('@mycoll/* | after :?').setString(0, next).list();
+  t.is(page.length, 0);
+
 
   doc = await db.createQuery('@mycoll/[foo=:?] and /[baz=:?]')
     .setString(0, 'baz')
@@ -221,6 +233,28 @@ test('Main', async (t) => {
   doc = await db.get('cc2', id);
   t.deepEqual(doc, { 'foo': 1 });
 
+  // Changes stream
+  const changes = db.changes();
+  const events = [];
+  const received = new Promise((resolve) => {
+    changes.on('data', (chg) => {
+      events.push(chg);
+      if (events.length == 2) {
+        resolve();
+      }
+    });
+  });
+  const cid = await db.put('cc2', { 'bar': 1 });
+  await db.del('cc2', cid);
+  await received;
+  changes.destroy();
+  t.is(events[0].op, 'put');
+  t.is(events[0].collection, 'cc2');
+  t.is(events[0].id, cid);
+  t.deepEqual(events[0].json, { 'bar': 1 });
+  t.is(events[1].op, 'del');
+  t.is(events[1].seq, events[0].seq + 1);
+
   const ts0 = +new Date();
   const ts = await db.onlineBackup('hello-bkp.db');
   t.true(ts0 < ts);
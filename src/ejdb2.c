@@ -1,4 +1,5 @@
 #include "ejdb2_internal.h"
+#include "sort_r.h"
 
 // ---------------------------------------------------------------------------
 
@@ -13,18 +14,18 @@ IW_INLINE iwrc _jb_meta_nrecs_removedb(EJDB db, uint32_t dbid) {
   return iwkv_del(db->nrecdb, &key, 0);
 }
 
-IW_INLINE iwrc _jb_meta_nrecs_update(EJDB db, uint32_t dbid, int64_t delta) {
-  delta = IW_HTOILL(delta);
+IW_INLINE iwrc _jb_meta_nrecs_set(EJDB db, uint32_t dbid, int64_t num, iwkv_opflags opflags) {
+  num = IW_HTOILL(num);
   dbid = IW_HTOIL(dbid);
   IWKV_val val = {
-    .size = sizeof(delta),
-    .data = &delta
+    .size = sizeof(num),
+    .data = &num
   };
   IWKV_val key = {
     .size = sizeof(dbid),
     .data = &dbid
   };
-  return iwkv_put(db->nrecdb, &key, &val, IWKV_VAL_INCREMENT);
+  return iwkv_put(db->nrecdb, &key, &val, opflags);
 }
 
 static int64_t _jb_meta_nrecs_get(EJDB db, uint32_t dbid) {
@@ -42,6 +43,46 @@ static int64_t _jb_meta_nrecs_get(EJDB db, uint32_t dbid) {
   return (int64_t) ret;
 }
 
+/**
+ * Persists record counters of collection and its indexes changed since last sync.
+ * Called under collection write lock or when database is not shared.
+ */
+static iwrc _jb_coll_nrecs_sync(JBCOLL jbc) {
+  iwrc rc = 0;
+  EJDB db = jbc->db;
+  jbc->rnum_ops = 0;
+  if (db->oflags & IWKV_RDONLY) {
+    return 0;
+  }
+  if (jbc->rnum != jbc->rnum_synced) {
+    rc = _jb_meta_nrecs_set(db, jbc->dbid, jbc->rnum, 0);
+    RCRET(rc);
+    jbc->rnum_synced = jbc->rnum;
+  }
+  for (JBIDX idx = jbc->idx; idx; idx = idx->next) {
+    if (idx->rnum != idx->rnum_synced) {
+      rc = _jb_meta_nrecs_set(db, idx->dbid, idx->rnum, 0);
+      RCRET(rc);
+      idx->rnum_synced = idx->rnum;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Updates in-memory number of collection records.
+ * Counters are written to NUMRECSDB every `JB_NRECS_SYNC_OPS` changes and on database close.
+ */
+static void _jb_coll_rnum_add(JBCOLL jbc, int64_t delta) {
+  jbc->rnum += delta;
+  if (++jbc->rnum_ops >= JB_NRECS_SYNC_OPS) {
+    iwrc rc = _jb_coll_nrecs_sync(jbc);
+    if (rc) {
+      iwlog_ecode_error3(rc);
+    }
+  }
+}
+
 static void _jb_idx_release(JBIDX idx) {
   if (idx->idb) {
     iwkv_db_cache_release(idx->idb);
@@ -49,10 +90,55 @@ static void _jb_idx_release(JBIDX idx) {
   if (idx->ptr) {
     free(idx->ptr);
   }
+  if (idx->fq) {
+    jql_destroy(&idx->fq);
+  }
+  free(idx->filter);
   free(idx);
 }
 
+/**
+ * Compiles filter query of partial index.
+ * Filter must be a plain query without placeholders, apply, projection and options.
+ */
+static iwrc _jb_idx_filter_create(JBIDX idx, const char *coll, const char *filter) {
+  JQL q;
+  iwrc rc = jql_create(&q, coll, filter);
+  RCRET(rc);
+  JQP_AUX *aux = q->aux;
+  if (aux->num_placeholders || aux->apply || aux->apply_placeholder || aux->projection
+      || aux->skip || aux->limit || aux->after || aux->orderby || aux->groupby || aux->aggregates || aux->qmode) {
+    jql_destroy(&q);
+    return EJDB_ERROR_INVALID_INDEX_FILTER;
+  }
+  idx->filter = strdup(filter);
+  if (!idx->filter) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    jql_destroy(&q);
+    return rc;
+  }
+  idx->fq = q;
+  return 0;
+}
+
+static void _jb_kdict_release(struct _JBKDICT *kd) {
+  if (kd->map) {
+    kh_destroy(JBKDICTM, kd->map);
+    kd->map = 0;
+  }
+  if (kd->pool) {
+    iwpool_destroy(kd->pool);
+    kd->pool = 0;
+  }
+  free(kd->keys);
+  kd->keys = 0;
+  kd->num = 0;
+  kd->asz = 0;
+}
+
 static void _jb_coll_release(JBCOLL jbc) {
+  _jb_kdict_release(&jbc->kdict);
+  free(jbc->zdict);
   if (jbc->cdb) {
     iwkv_db_cache_release(jbc->cdb);
   }
@@ -71,7 +157,7 @@ static void _jb_coll_release(JBCOLL jbc) {
 
 static iwrc _jb_coll_load_index_lr(JBCOLL jbc, IWKV_val *mval) {
   binn *bn;
-  char *ptr;
+  char *ptr, *filter;
   struct _JBL imeta;
   JBIDX idx = calloc(1, sizeof(*idx));
   if (!idx) return iwrc_set_errno(IW_ERROR_ALLOC, errno);
@@ -89,11 +175,15 @@ static iwrc _jb_coll_load_index_lr(JBCOLL jbc, IWKV_val *mval) {
   }
   rc = jbl_ptr_alloc(ptr, &idx->ptr);
   RCGO(rc, finish);
+  if (binn_object_get_str(bn, "filter", &filter)) {
+    rc = _jb_idx_filter_create(idx, jbc->name, filter);
+    RCGO(rc, finish);
+  }
 
   rc = iwkv_db(jbc->db->iwkv, idx->dbid, idx->idbf, &idx->idb);
   RCGO(rc, finish);
   idx->jbc = jbc;
-  idx->rnum = _jb_meta_nrecs_get(jbc->db, idx->dbid);
+  idx->rnum = idx->rnum_synced = _jb_meta_nrecs_get(jbc->db, idx->dbid);
   idx->next = jbc->idx;
   jbc->idx = idx;
 
@@ -145,9 +235,139 @@ finish:
   return rc;
 }
 
+/** Registers `key` under the given `id` in collection keys dictionary */
+static iwrc _jb_kdict_register(struct _JBKDICT *kd, uint32_t id, const char *key, int keylen) {
+  int rci;
+  if (!id || id > JB_KDICT_MAX_KEYS || keylen < 1 || keylen > 255) {
+    return EJDB_ERROR_INVALID_COLLECTION_META;
+  }
+  if (!kd->map) {
+    kd->map = kh_init(JBKDICTM);
+    if (!kd->map) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  if (!kd->pool) {
+    kd->pool = iwpool_create(1024);
+    if (!kd->pool) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  if (id > kd->asz) {
+    uint32_t nsz = kd->asz ? kd->asz : 64;
+    while (nsz < id) nsz *= 2;
+    struct _JBKDKEY *nkeys = realloc(kd->keys, nsz * sizeof(kd->keys[0]));
+    if (!nkeys) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    memset(nkeys + kd->asz, 0, (nsz - kd->asz) * sizeof(kd->keys[0]));
+    kd->keys = nkeys;
+    kd->asz = nsz;
+  }
+  char *kc = iwpool_alloc(keylen + 1, kd->pool);
+  if (!kc) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  memcpy(kc, key, keylen);
+  kc[keylen] = '\0';
+  khiter_t k = kh_put(JBKDICTM, kd->map, kc, &rci);
+  if (rci == -1) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  kh_value(kd->map, k) = id;
+  kd->keys[id - 1].key = kc;
+  kd->keys[id - 1].len = keylen;
+  if (id > kd->num) {
+    kd->num = id;
+  }
+  return 0;
+}
+
+static iwrc _jb_kdict_load_lr(JBCOLL jbc) {
+  iwrc rc = 0;
+  IWKV_cursor cur;
+  IWKV_val kval;
+  char buf[sizeof(KEY_PREFIX_KDICT) + 2 * JBNUMBUF_SIZE];
+  // Full key format: k.<coldbid>.<keyid>
+  int sz = snprintf(buf, sizeof(buf), KEY_PREFIX_KDICT "%u.", jbc->dbid);
+  if (sz >= sizeof(buf)) {
+    return IW_ERROR_OVERFLOW;
+  }
+  kval.data = buf;
+  kval.size = sz;
+  rc = iwkv_cursor_open(jbc->db->metadb, &cur, IWKV_CURSOR_GE, &kval);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+    goto finish;
+  }
+  RCRET(rc);
+
+  do {
+    IWKV_val key, val;
+    rc = iwkv_cursor_key(cur, &key);
+    RCGO(rc, finish);
+    if (key.size > sz && key.size < sizeof(buf) && !strncmp(buf, key.data, sz)) {
+      char idbuf[JBNUMBUF_SIZE + 1];
+      size_t idlen = MIN(key.size - sz, JBNUMBUF_SIZE);
+      memcpy(idbuf, (char *) key.data + sz, idlen);
+      idbuf[idlen] = '\0';
+      iwkv_val_dispose(&key);
+      rc = iwkv_cursor_val(cur, &val);
+      RCGO(rc, finish);
+      rc = _jb_kdict_register(&jbc->kdict, (uint32_t) strtoul(idbuf, 0, 10), val.data, (int) val.size);
+      iwkv_val_dispose(&val);
+      RCBREAK(rc);
+    } else {
+      iwkv_val_dispose(&key);
+    }
+  } while (!(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV)));
+  if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
+
+finish:
+  iwkv_cursor_close(&cur);
+  return rc;
+}
+
+static iwrc _jb_zdict_load_lr(JBCOLL jbc) {
+  IWKV_val key, val;
+  char keybuf[JBNUMBUF_SIZE + sizeof(KEY_PREFIX_ZDICT)];
+  key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_ZDICT "%u", jbc->dbid);
+  if (key.size >= sizeof(keybuf)) {
+    return IW_ERROR_OVERFLOW;
+  }
+  key.data = keybuf;
+  iwrc rc = iwkv_get(jbc->db->metadb, &key, &val);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    return 0;
+  }
+  RCRET(rc);
+  jbc->zdict = val.data;
+  jbc->zdictsz = (uint32_t) val.size;
+  return 0;
+}
+
+static iwrc _jb_db_count(IWDB idb, int64_t *cntp) {
+  IWKV_cursor cur;
+  int64_t cnt = 0;
+  iwrc rc = iwkv_cursor_open(idb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    *cntp = 0;
+    return 0;
+  }
+  RCRET(rc);
+  while (!(rc = iwkv_cursor_to(cur, IWKV_CURSOR_NEXT))) {
+    ++cnt;
+  }
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+    *cntp = cnt;
+  }
+  IWRC(iwkv_cursor_close(&cur), rc);
+  return rc;
+}
+
 static iwrc _jb_coll_load_meta_lr(JBCOLL jbc) {
   JBL jbv;
-  IWKV_cursor cur;
   JBL jbm = jbc->meta;
   iwrc rc = jbl_at(jbm, "/name", &jbv);
   RCRET(rc);
@@ -163,30 +383,137 @@ static iwrc _jb_coll_load_meta_lr(JBCOLL jbc) {
   if (!jbc->dbid) {
     return EJDB_ERROR_INVALID_COLLECTION_META;
   }
-  rc = iwkv_db(jbc->db->iwkv, jbc->dbid, IWDB_VNUM64_KEYS, &jbc->cdb);
+  BOOL kdict = FALSE;
+  binn_object_get_bool(&jbm->bn, "kdict", &kdict);
+  jbc->kdict.enabled = kdict;
+  binn_object_get_uint32(&jbm->bn, "zthr", &jbc->zthreshold);
+  return rc;
+}
+
+/**
+ * Loads collection database, indexes, record counters and dictionaries.
+ * Collections are loaded on first access, caller must hold collection write lock
+ * or database write lock.
+ */
+static iwrc _jb_coll_load_lw(JBCOLL jbc) {
+  IWKV_cursor cur = 0;
+  if (jbc->loaded) {
+    return 0;
+  }
+  iwrc rc = iwkv_db(jbc->db->iwkv, jbc->dbid, IWDB_VNUM64_KEYS, &jbc->cdb);
   RCRET(rc);
 
-  jbc->rnum = _jb_meta_nrecs_get(jbc->db, jbc->dbid);
+  jbc->rnum = jbc->rnum_synced = _jb_meta_nrecs_get(jbc->db, jbc->dbid);
 
   rc = _jb_coll_load_indexes_lr(jbc);
-  RCRET(rc);
+  RCGO(rc, finish);
+  rc = _jb_kdict_load_lr(jbc);
+  RCGO(rc, finish);
+  rc = _jb_zdict_load_lr(jbc);
+  RCGO(rc, finish);
+
+  if (jbc->db->nrecs_recount) {
+    rc = _jb_db_count(jbc->cdb, &jbc->rnum);
+    RCGO(rc, finish);
+    for (JBIDX idx = jbc->idx; idx; idx = idx->next) {
+      rc = _jb_db_count(idx->idb, &idx->rnum);
+      RCGO(rc, finish);
+    }
+    rc = _jb_coll_nrecs_sync(jbc);
+    RCGO(rc, finish);
+  }
 
   rc = iwkv_cursor_open(jbc->cdb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0);
-  RCRET(rc);
+  RCGO(rc, finish);
   rc = iwkv_cursor_to(cur, IWKV_CURSOR_NEXT);
   if (rc) {
     if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
   } else {
     size_t sz;
     rc = iwkv_cursor_copy_key(cur, &jbc->id_seq, sizeof(jbc->id_seq), &sz, 0);
-    RCGO(rc, finish);
   }
 
 finish:
-  iwkv_cursor_close(&cur);
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
+  if (rc) {
+    for (JBIDX idx = jbc->idx, nidx; idx; idx = nidx) {
+      nidx = idx->next;
+      _jb_idx_release(idx);
+    }
+    jbc->idx = 0;
+    _jb_kdict_release(&jbc->kdict);
+    free(jbc->zdict);
+    jbc->zdict = 0;
+    jbc->zdictsz = 0;
+  } else {
+    jbc->loaded = true;
+  }
+  return rc;
+}
+
+/**
+ * Acquires collection lock and loads collection if it was not accessed before.
+ * Caller must hold database lock.
+ */
+static iwrc _jb_coll_lock_loaded(JBCOLL jbc, bool wl) {
+  iwrc rc = 0;
+  int rci = wl ? pthread_rwlock_wrlock(&jbc->rwl) : pthread_rwlock_rdlock(&jbc->rwl);
+  if (rci) {
+    return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+  }
+  if (jbc->loaded) {
+    return 0;
+  }
+  if (!wl) { // Relock for loading
+    pthread_rwlock_unlock(&jbc->rwl);
+    rci = pthread_rwlock_wrlock(&jbc->rwl);
+    if (rci) {
+      return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+    }
+  }
+  rc = _jb_coll_load_lw(jbc);
+  if (rc || !wl) {
+    pthread_rwlock_unlock(&jbc->rwl);
+  }
+  if (!rc && !wl) {
+    rci = pthread_rwlock_rdlock(&jbc->rwl);
+    if (rci) {
+      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+    }
+  }
+  return rc;
+}
+
+/** Loads collection if it was not accessed before, caller must hold database lock */
+static iwrc _jb_coll_ensure_loaded(JBCOLL jbc) {
+  iwrc rc = _jb_coll_lock_loaded(jbc, false);
+  RCRET(rc);
+  pthread_rwlock_unlock(&jbc->rwl);
   return rc;
 }
 
+/**
+ * Creates collection meta object stored in metadb under `c.<coldbid>` key.
+ * Collection options are taken from `jbc` if it is not zero.
+ */
+static iwrc _jb_coll_meta_create(const char *name, uint32_t dbid, JBCOLL jbc, JBL *metap) {
+  JBL meta;
+  *metap = 0;
+  iwrc rc = jbl_create_empty_object(&meta);
+  RCRET(rc);
+  if (!binn_object_set_str(&meta->bn, "name", name)
+      || !binn_object_set_uint32(&meta->bn, "id", dbid)
+      || (jbc && jbc->kdict.enabled && !binn_object_set_bool(&meta->bn, "kdict", TRUE))
+      || (jbc && jbc->zthreshold && !binn_object_set_uint32(&meta->bn, "zthr", jbc->zthreshold))) {
+    jbl_destroy(&meta);
+    return JBL_ERROR_CREATION;
+  }
+  *metap = meta;
+  return 0;
+}
+
 static iwrc _jb_coll_init(JBCOLL jbc, IWKV_val *meta) {
   int rci;
   iwrc rc = 0;
@@ -207,13 +534,19 @@ static iwrc _jb_coll_init(JBCOLL jbc, IWKV_val *meta) {
   }
   rc = _jb_coll_load_meta_lr(jbc);
   RCRET(rc);
+  if (!meta) { // New collection
+    rc = _jb_coll_load_lw(jbc);
+    RCRET(rc);
+  }
 
+  pthread_rwlock_wrlock(&jbc->db->crwl);
   khiter_t k = kh_put(JBCOLLM, jbc->db->mcolls, jbc->name, &rci);
   if (rci != -1) {
     kh_value(jbc->db->mcolls, k) = jbc;
   } else {
-    return IW_ERROR_FAIL;
+    rc = IW_ERROR_FAIL;
   }
+  pthread_rwlock_unlock(&jbc->db->crwl);
   return rc;
 }
 
@@ -236,7 +569,8 @@ static iwrc _jb_idx_add_meta_lr(JBIDX idx, binn *list) {
       !binn_object_set_uint32(meta, "mode", idx->mode) ||
       !binn_object_set_uint32(meta, "idbf", idx->idbf) ||
       !binn_object_set_uint32(meta, "dbid", idx->dbid) ||
-      !binn_object_set_int64(meta, "rnum", idx->rnum)) {
+      !binn_object_set_int64(meta, "rnum", idx->rnum) ||
+      (idx->filter && !binn_object_set_str(meta, "filter", idx->filter))) {
     rc = JBL_ERROR_CREATION;
   }
 
@@ -260,7 +594,10 @@ static iwrc _jb_coll_add_meta_lr(JBCOLL jbc, binn *list) {
   }
   if (!binn_object_set_str(meta, "name", jbc->name)
       || !binn_object_set_uint32(meta, "dbid", jbc->dbid)
-      || !binn_object_set_int64(meta, "rnum", jbc->rnum)) {
+      || !binn_object_set_int64(meta, "rnum", jbc->rnum)
+      || (jbc->kdict.enabled && !binn_object_set_bool(meta, "kdict", TRUE))
+      || (jbc->zthreshold && !binn_object_set_uint32(meta, "zthr", jbc->zthreshold))
+      || (jbc->zdict && !binn_object_set_uint32(meta, "zdict", jbc->zdictsz))) {
     rc = JBL_ERROR_CREATION;
     goto finish;
   }
@@ -334,6 +671,207 @@ finish:
   return rc;
 }
 
+/**
+ * Stores NUMRECS_DIRTY_ID marker if it was removed by `_jb_db_nrecs_flush()`.
+ * Called on database open and under collection write lock before collection data is changed.
+ */
+static iwrc _jb_db_nrecs_mark(EJDB db) {
+  iwrc rc = 0;
+  if (db->oflags & IWKV_RDONLY) {
+    return 0;
+  }
+  // Pairs with `nrecs_dirty` reset in `_jb_db_nrecs_flush_shared()`
+  __atomic_add_fetch(&db->nrecs_wgen, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&db->nrecs_dirty, __ATOMIC_SEQ_CST)) {
+    return 0;
+  }
+  pthread_mutex_lock(&db->nrecs_mtx);
+  if (!db->nrecs_dirty) {
+    rc = _jb_meta_nrecs_set(db, NUMRECS_DIRTY_ID, 1, IWKV_SYNC);
+    if (!rc) {
+      __atomic_store_n(&db->nrecs_dirty, true, __ATOMIC_SEQ_CST);
+    }
+  }
+  pthread_mutex_unlock(&db->nrecs_mtx);
+  return rc;
+}
+
+/**
+ * Record counters are kept in memory and persisted by `_jb_coll_nrecs_sync()`.
+ * While database is open NUMRECS_DIRTY_ID marker is stored in NUMRECSDB,
+ * if marker is found at open then database was not closed properly
+ * and records of collections and indexes are recounted when collections are loaded.
+ */
+static iwrc _jb_db_nrecs_open(EJDB db) {
+  if (_jb_meta_nrecs_get(db, NUMRECS_DIRTY_ID)) {
+    iwlog_warn2("Database was not closed properly, records of collections and indexes will be recounted");
+    db->nrecs_recount = true;
+  }
+  return _jb_db_nrecs_mark(db);
+}
+
+/**
+ * Persists counters of loaded collections and removes NUMRECS_DIRTY_ID marker.
+ * Called on database close when database is not shared.
+ */
+static iwrc _jb_db_nrecs_flush(EJDB db) {
+  iwrc rc = 0;
+  if (!db->nrecs_dirty) {
+    return 0;
+  }
+  bool recounted = true;
+  for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
+    if (!kh_exist(db->mcolls, k)) continue;
+    JBCOLL jbc = kh_val(db->mcolls, k);
+    if (jbc->loaded) {
+      IWRC(_jb_coll_nrecs_sync(jbc), rc);
+    } else {
+      recounted = false;
+    }
+  }
+  // Keep marker until every collection is recounted
+  if (!rc && (recounted || !db->nrecs_recount)) {
+    rc = _jb_meta_nrecs_removedb(db, NUMRECS_DIRTY_ID);
+    if (!rc) {
+      db->nrecs_dirty = false;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Persists counters of collections one by one under collection write lock.
+ * NUMRECS_DIRTY_ID marker is removed only if no collection was write locked since flush start,
+ * so writers are never stalled on the whole database. Caller must hold database read lock.
+ */
+static iwrc _jb_db_nrecs_flush_shared(EJDB db) {
+  iwrc rc = 0;
+  if ((db->oflags & IWKV_RDONLY) || !__atomic_load_n(&db->nrecs_dirty, __ATOMIC_SEQ_CST)) {
+    return 0;
+  }
+  bool recounted = true;
+  uint64_t wgen = __atomic_load_n(&db->nrecs_wgen, __ATOMIC_SEQ_CST);
+  pthread_rwlock_rdlock(&db->crwl);
+  for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
+    if (!kh_exist(db->mcolls, k)) continue;
+    JBCOLL jbc = kh_val(db->mcolls, k);
+    int rci = pthread_rwlock_wrlock(&jbc->rwl);
+    if (rci) {
+      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+      break;
+    }
+    if (jbc->loaded) {
+      IWRC(_jb_coll_nrecs_sync(jbc), rc);
+    } else {
+      recounted = false;
+    }
+    pthread_rwlock_unlock(&jbc->rwl);
+  }
+  pthread_rwlock_unlock(&db->crwl);
+  if (rc || (!recounted && db->nrecs_recount)) {
+    return rc;
+  }
+  pthread_mutex_lock(&db->nrecs_mtx);
+  // Writer which increments `nrecs_wgen` after this reset finds marker removed and stores it again
+  __atomic_store_n(&db->nrecs_dirty, false, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&db->nrecs_wgen, __ATOMIC_SEQ_CST) == wgen) {
+    rc = _jb_meta_nrecs_removedb(db, NUMRECS_DIRTY_ID);
+    if (rc) {
+      __atomic_store_n(&db->nrecs_dirty, true, __ATOMIC_SEQ_CST);
+    }
+  } else {
+    __atomic_store_n(&db->nrecs_dirty, true, __ATOMIC_SEQ_CST); // Collections were changed meanwhile
+  }
+  pthread_mutex_unlock(&db->nrecs_mtx);
+  return rc;
+}
+
+// Records document change, called under collection write lock
+static void _jb_changes_add(JBCOLL jbc, ejdb_change_t op, int64_t id, JBL jbl) {
+  struct _JBCHGS *chgs = &jbc->db->chgs;
+  if (!__atomic_load_n(&chgs->active, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+  size_t clen = strlen(jbc->name) + 1;
+  size_t size = jbl->bn.size;
+  char *buf = malloc(clen + size);
+  if (!buf) {
+    iwlog_ecode_error3(iwrc_set_errno(IW_ERROR_ALLOC, errno));
+  } else {
+    memcpy(buf, jbc->name, clen);
+    memcpy(buf + clen, jbl->bn.ptr, size);
+  }
+  pthread_mutex_lock(&chgs->mtx);
+  ++chgs->seq; // Lost change is seen by listeners as a sequence gap
+  if (!buf || !chgs->active) {
+    pthread_mutex_unlock(&chgs->mtx);
+    free(buf);
+    return;
+  }
+  if (chgs->num == chgs->cap) { // Drop the oldest change
+    free(chgs->ring[chgs->head].coll);
+    chgs->head = (chgs->head + 1) % chgs->cap;
+    --chgs->num;
+  }
+  chgs->ring[(chgs->head + chgs->num) % chgs->cap] = (struct _JBCHG) {
+    .seq = chgs->seq,
+    .op = op,
+    .id = id,
+    .coll = buf,
+    .data = buf + clen,
+    .size = size
+  };
+  ++chgs->num;
+  pthread_mutex_unlock(&chgs->mtx);
+}
+
+// Delivers buffered changes to listeners, must be called without database locks held
+static void _jb_changes_dispatch(EJDB db) {
+  struct _JBCHGS *chgs = &db->chgs;
+  if (!__atomic_load_n(&chgs->active, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+  pthread_mutex_lock(&chgs->mtx);
+  if (chgs->dispatching) { // Changes will be delivered by another thread
+    pthread_mutex_unlock(&chgs->mtx);
+    return;
+  }
+  chgs->dispatching = true;
+  while (chgs->num) {
+    struct _JBCHG chg = chgs->ring[chgs->head];
+    chgs->head = (chgs->head + 1) % chgs->cap;
+    --chgs->num;
+    pthread_mutex_unlock(&chgs->mtx);
+
+    struct _JBL jbl;
+    if (!jbl_from_buf_keep_onstack(&jbl, chg.data, chg.size)) {
+      struct _EJDB_CHANGE ev = {
+        .seq = chg.seq,
+        .op = chg.op,
+        .coll = chg.coll,
+        .id = chg.id,
+        .doc = &jbl
+      };
+      pthread_rwlock_rdlock(&chgs->rwl);
+      for (struct _JBCHGL *l = chgs->listeners; l; l = l->next) {
+        l->listener(db, &ev, l->op);
+      }
+      pthread_rwlock_unlock(&chgs->rwl);
+    }
+    free(chg.coll);
+    pthread_mutex_lock(&chgs->mtx);
+  }
+  chgs->dispatching = false;
+  pthread_mutex_unlock(&chgs->mtx);
+}
+
+static void _jb_changes_clear(struct _JBCHGS *chgs) {
+  for (; chgs->num; --chgs->num) {
+    free(chgs->ring[chgs->head].coll);
+    chgs->head = (chgs->head + 1) % chgs->cap;
+  }
+}
+
 static iwrc _jb_db_release(EJDB *dbp) {
   iwrc rc = 0;
   EJDB db = *dbp;
@@ -344,6 +882,7 @@ static iwrc _jb_db_release(EJDB *dbp) {
   }
 #endif
   if (db->mcolls) {
+    IWRC(_jb_db_nrecs_flush(db), rc);
     for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
       if (!kh_exist(db->mcolls, k)) continue;
       JBCOLL jbc = kh_val(db->mcolls, k);
@@ -356,6 +895,27 @@ static iwrc _jb_db_release(EJDB *dbp) {
     IWRC(iwkv_close(&db->iwkv), rc);
   }
   pthread_rwlock_destroy(&db->rwl);
+  pthread_rwlock_destroy(&db->crwl);
+  pthread_mutex_destroy(&db->cmtx);
+  pthread_mutex_destroy(&db->nrecs_mtx);
+
+  struct _JBCHGS *chgs = &db->chgs;
+  if (chgs->ring) {
+    _jb_changes_clear(chgs);
+    free(chgs->ring);
+  }
+  for (struct _JBCHGL *l = chgs->listeners, *n; l; l = n) {
+    n = l->next;
+    free(l);
+  }
+  pthread_mutex_destroy(&chgs->mtx);
+  pthread_rwlock_destroy(&chgs->rwl);
+  pthread_mutex_destroy(&db->ttl.mtx);
+  pthread_cond_destroy(&db->ttl.cond);
+  pthread_mutex_destroy(&db->snap.mtx);
+  pthread_mutex_destroy(&db->snap.wmtx);
+  pthread_cond_destroy(&db->snap.cond);
+  free((void *) db->opts.snapshot_path);
 
   EJDB_HTTP *http = &db->opts.http;
   if (http->bind) free((void *) http->bind);
@@ -374,31 +934,31 @@ static iwrc _jb_coll_acquire_keeplock2(EJDB db, const char *coll, jb_coll_acquir
   JBCOLL jbc = 0;
   bool wl = acm & JB_COLL_ACQUIRE_WRITE;
   API_RLOCK(db, rci);
+  pthread_rwlock_rdlock(&db->crwl);
   khiter_t k = kh_get(JBCOLLM, db->mcolls, coll);
   if (k != kh_end(db->mcolls)) {
     jbc = kh_value(db->mcolls, k);
-    assert(jbc);
-    rci = wl ? pthread_rwlock_wrlock(&jbc->rwl) : pthread_rwlock_rdlock(&jbc->rwl);
-    if (rci) {
-      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
-      goto finish;
-    }
+  }
+  pthread_rwlock_unlock(&db->crwl);
+  if (jbc) {
+    rc = _jb_coll_lock_loaded(jbc, wl);
+    RCGO(rc, finish);
     *jbcp = jbc;
   } else {
-    pthread_rwlock_unlock(&db->rwl); // relock
     if ((db->oflags & IWKV_RDONLY) || (acm & JB_COLL_ACQUIRE_EXISTING)) {
+      pthread_rwlock_unlock(&db->rwl);
       return IW_ERROR_NOT_EXISTS;
     }
-    API_WLOCK(db, rci);
+    // New collection is created under main read lock so operations on other collections
+    // are not stalled, creators are serialized by `cmtx`.
+    pthread_mutex_lock(&db->cmtx);
     k = kh_get(JBCOLLM, db->mcolls, coll);
     if (k != kh_end(db->mcolls)) {
       jbc = kh_value(db->mcolls, k);
       assert(jbc);
-      rci = pthread_rwlock_rdlock(&jbc->rwl);
-      if (rci) {
-        rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
-        goto finish;
-      }
+      pthread_mutex_unlock(&db->cmtx);
+      rc = _jb_coll_lock_loaded(jbc, wl);
+      RCGO(rc, finish);
       *jbcp = jbc;
     } else {
       JBL meta = 0;
@@ -414,16 +974,8 @@ static iwrc _jb_coll_acquire_keeplock2(EJDB db, const char *coll, jb_coll_acquir
         rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
         goto create_finish;
       }
-      rc = jbl_create_empty_object(&meta);
+      rc = _jb_coll_meta_create(coll, dbid, 0, &meta);
       RCGO(rc, create_finish);
-      if (!binn_object_set_str(&meta->bn, "name", coll)) {
-        rc = JBL_ERROR_CREATION;
-        goto create_finish;
-      }
-      if (!binn_object_set_uint32(&meta->bn, "id", dbid)) {
-        rc = JBL_ERROR_CREATION;
-        goto create_finish;
-      }
       rc = jbl_as_buf(meta, &val.data, &val.size);
       RCGO(rc, create_finish);
 
@@ -445,6 +997,7 @@ static iwrc _jb_coll_acquire_keeplock2(EJDB db, const char *coll, jb_coll_acquir
       }
 
 create_finish:
+      pthread_mutex_unlock(&db->cmtx);
       if (rc) {
         if (meta) jbl_destroy(&meta);
         if (cdb) iwkv_db_destroy(&cdb);
@@ -462,6 +1015,14 @@ create_finish:
       }
     }
   }
+  if (!rc && wl) {
+    // Marked under collection write lock, see `_jb_db_nrecs_flush_shared()`
+    rc = _jb_db_nrecs_mark(db);
+    if (rc) {
+      pthread_rwlock_unlock(&jbc->rwl);
+      *jbcp = 0;
+    }
+  }
 
 finish:
   if (rc) {
@@ -474,13 +1035,311 @@ IW_INLINE iwrc _jb_coll_acquire_keeplock(EJDB db, const char *coll, bool wl, JBC
   return _jb_coll_acquire_keeplock2(db, coll, wl ? JB_COLL_ACQUIRE_WRITE : 0, jbcp);
 }
 
-static iwrc _jb_idx_record_add(JBIDX idx, int64_t id, JBL jbl, JBL jblprev) {
-  IWKV_val key;
-  uint8_t step;
-  char vnbuf[IW_VNUMBUFSZ];
-  char numbuf[JBNUMBUF_SIZE];
+/** Replaces string key of `EJDB_IDX_ICASE` index by its case folded copy allocated in pool */
+static iwrc _jb_idx_key_casefold(IWKV_val *key, IWPOOL **poolp) {
+  if (!*poolp) {
+    *poolp = iwpool_create(1024);
+    if (!*poolp) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  char *buf = iwpool_alloc(key->size + 1, *poolp);
+  if (!buf) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  key->size = ftstok_casefold(key->data, key->size, buf);
+  key->data = buf;
+  return 0;
+}
 
-  bool jbv_found, jbvprev_found;
+/** Sorted set of full text index terms of document field */
+struct _JBFTSTERMS {
+  IWPOOL *pool;
+  char **terms;
+  size_t num;
+  size_t asz;
+  iwrc rc;
+};
+
+static bool _jb_fts_terms_visitor(const FTSTOK *tok, void *op) {
+  struct _JBFTSTERMS *tt = op;
+  if (tt->num >= tt->asz) {
+    size_t nsz = tt->asz ? tt->asz * 2 : 32;
+    char **nterms = realloc(tt->terms, nsz * sizeof(*tt->terms));
+    if (!nterms) {
+      tt->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      return false;
+    }
+    tt->terms = nterms;
+    tt->asz = nsz;
+  }
+  char *term = iwpool_strdup(tt->pool, tok->term, &tt->rc);
+  if (!term) {
+    return false;
+  }
+  tt->terms[tt->num++] = term;
+  return true;
+}
+
+static int _jb_fts_terms_cmp(const void *v1, const void *v2) {
+  return strcmp(*(char **) v1, *(char **) v2);
+}
+
+static iwrc _jb_fts_terms_collect(JBIDX idx, JBL jbl, struct _JBFTSTERMS *tt) {
+  struct _JBL jbv;
+  if (!jbl || !_jbl_at(jbl, idx->ptr, &jbv)) {
+    return 0;
+  }
+  jbl_type_t jbvt = jbl_type(&jbv);
+  if (jbvt == JBV_STR) {
+    const char *str = jbl_get_str(&jbv);
+    ftstok_tokenize(str, strlen(str), _jb_fts_terms_visitor, tt);
+  } else if (jbvt == JBV_ARRAY) {
+    JBL_NODE n;
+    iwrc rc = jbl_to_node(&jbv, &n, tt->pool);
+    RCRET(rc);
+    for (n = n->child; n && !tt->rc; n = n->next) {
+      if (n->type == JBV_STR) {
+        ftstok_tokenize(n->vptr, n->vsize, _jb_fts_terms_visitor, tt);
+      }
+    }
+  }
+  RCRET(tt->rc);
+  if (tt->num > 1) { // Sort and remove duplicated terms
+    size_t i, j;
+    qsort(tt->terms, tt->num, sizeof(tt->terms[0]), _jb_fts_terms_cmp);
+    for (i = 1, j = 1; i < tt->num; ++i) {
+      if (strcmp(tt->terms[i], tt->terms[j - 1])) {
+        tt->terms[j++] = tt->terms[i];
+      }
+    }
+    tt->num = j;
+  }
+  return 0;
+}
+
+/**
+ * Updates postings of full text index: `<term>.<document id>` compound keys.
+ * Only terms which differ in the previous and the new document versions are touched.
+ */
+static iwrc _jb_idx_fts_record_add(JBIDX idx, int64_t id, JBL jbl, JBL jblprev) {
+  iwrc rc;
+  size_t i = 0, j = 0;
+  int64_t delta = 0;
+  IWPOOL *pool = iwpool_create(1024);
+  if (!pool) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  struct _JBFTSTERMS tt = {.pool = pool}, ttprev = {.pool = pool};
+
+  rc = _jb_fts_terms_collect(idx, jbl, &tt);
+  RCGO(rc, finish);
+  rc = _jb_fts_terms_collect(idx, jblprev, &ttprev);
+  RCGO(rc, finish);
+
+  while (i < tt.num || j < ttprev.num) {
+    int cmp = (i == tt.num) ? 1 : (j == ttprev.num) ? -1 : strcmp(tt.terms[i], ttprev.terms[j]);
+    if (cmp == 0) {
+      ++i, ++j;
+      continue;
+    }
+    IWKV_val key = {.compound = id};
+    if (cmp < 0) { // New term
+      key.data = tt.terms[i];
+      key.size = strlen(tt.terms[i]);
+      rc = iwkv_put(idx->idb, &key, &EMPTY_VAL, IWKV_NO_OVERWRITE);
+      if (!rc) {
+        ++delta;
+      } else if (rc == IWKV_ERROR_KEY_EXISTS) {
+        rc = 0;
+      }
+      ++i;
+    } else { // Term removed
+      key.data = ttprev.terms[j];
+      key.size = strlen(ttprev.terms[j]);
+      rc = iwkv_del(idx->idb, &key, 0);
+      if (!rc) {
+        --delta;
+      } else if (rc == IWKV_ERROR_NOTFOUND) {
+        rc = 0;
+      }
+      ++j;
+    }
+    RCGO(rc, finish);
+  }
+
+finish:
+  free(tt.terms);
+  free(ttprev.terms);
+  iwpool_destroy(pool);
+  idx->rnum += delta;
+  return rc;
+}
+
+/** Index key of array element stored in `_JBIKEYS` buffer */
+struct _JBIKEY {
+  size_t off;
+  size_t size;
+};
+
+/** Sorted set of index keys of array field elements */
+struct _JBIKEYS {
+  char *data;               /**< Keys data buffer */
+  size_t dsz;               /**< Size of keys data */
+  size_t dasz;              /**< Allocated size of keys data buffer */
+  struct _JBIKEY *keys;     /**< Keys */
+  size_t num;               /**< Number of keys */
+  size_t asz;               /**< Allocated number of keys */
+};
+
+static iwrc _jb_idx_keys_add(JBIDX idx, JBL jbv, struct _JBIKEYS *ks) {
+  IWKV_val key;
+  char numbuf[JBNUMBUF_SIZE];
+  jbi_jbl_fill_ikey(idx, jbv, &key, numbuf);
+  if (!key.size) {
+    return 0;
+  }
+  if (ks->num >= ks->asz) {
+    size_t nsz = ks->asz ? ks->asz * 2 : 16;
+    struct _JBIKEY *nkeys = realloc(ks->keys, nsz * sizeof(*ks->keys));
+    if (!nkeys) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    ks->keys = nkeys;
+    ks->asz = nsz;
+  }
+  if (ks->dsz + key.size + 1 > ks->dasz) {
+    size_t nsz = MAX(ks->dsz + key.size + 1, ks->dasz ? ks->dasz * 2 : 256);
+    char *ndata = realloc(ks->data, nsz);
+    if (!ndata) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    ks->data = ndata;
+    ks->dasz = nsz;
+  }
+  struct _JBIKEY *k = &ks->keys[ks->num++];
+  k->off = ks->dsz;
+  if (idx->mode & EJDB_IDX_ICASE) {
+    k->size = ftstok_casefold(key.data, key.size, ks->data + ks->dsz);
+  } else {
+    memcpy(ks->data + ks->dsz, key.data, key.size);
+    k->size = key.size;
+  }
+  ks->dsz += k->size;
+  return 0;
+}
+
+static int _jb_idx_key_cmp(const struct _JBIKEY *k1, const char *d1, const struct _JBIKEY *k2, const char *d2) {
+  int ret = memcmp(d1 + k1->off, d2 + k2->off, MIN(k1->size, k2->size));
+  if (!ret) {
+    ret = k1->size < k2->size ? -1 : k1->size > k2->size ? 1 : 0;
+  }
+  return ret;
+}
+
+static int _jb_idx_keys_sort_cmp(const void *v1, const void *v2, void *op) {
+  return _jb_idx_key_cmp(v1, op, v2, op);
+}
+
+/**
+ * Collects index keys of `jbv` array elements or `jbv` value itself
+ * into sorted set `ks`. Duplicated keys are removed.
+ */
+static iwrc _jb_idx_keys_collect(JBIDX idx, JBL jbv, struct _JBIKEYS *ks) {
+  iwrc rc = 0;
+  if (jbl_type(jbv) == JBV_ARRAY) {
+    JBL_iterator it;
+    struct _JBL holder = { 0 };
+    rc = jbl_iterator_init(jbv, &it);
+    RCRET(rc);
+    while (jbl_iterator_next(&it, &holder, 0, 0)) {
+      rc = _jb_idx_keys_add(idx, &holder, ks);
+      RCRET(rc);
+    }
+  } else {
+    rc = _jb_idx_keys_add(idx, jbv, ks);
+    RCRET(rc);
+  }
+  if (ks->num > 1) {
+    size_t i, j;
+    sort_r(ks->keys, ks->num, sizeof(ks->keys[0]), _jb_idx_keys_sort_cmp, ks->data);
+    for (i = 1, j = 1; i < ks->num; ++i) {
+      if (_jb_idx_key_cmp(&ks->keys[i], ks->data, &ks->keys[j - 1], ks->data)) {
+        ks->keys[j++] = ks->keys[i];
+      }
+    }
+    ks->num = j;
+  }
+  return rc;
+}
+
+/**
+ * Updates compound index records of array field.
+ * Only keys of added and removed array elements are touched.
+ */
+static iwrc _jb_idx_array_record_add(JBIDX idx, int64_t id, JBL jbv, JBL jbvprev) {
+  iwrc rc = 0;
+  size_t i = 0, j = 0;
+  int64_t delta = 0;
+  struct _JBIKEYS ks = { 0 }, ksprev = { 0 };
+
+  if (jbv) {
+    rc = _jb_idx_keys_collect(idx, jbv, &ks);
+    RCGO(rc, finish);
+  }
+  if (jbvprev) {
+    rc = _jb_idx_keys_collect(idx, jbvprev, &ksprev);
+    RCGO(rc, finish);
+  }
+
+  while (i < ks.num || j < ksprev.num) {
+    int cmp = (i == ks.num) ? 1 : (j == ksprev.num) ? -1
+              : _jb_idx_key_cmp(&ks.keys[i], ks.data, &ksprev.keys[j], ksprev.data);
+    if (cmp == 0) {
+      ++i, ++j;
+      continue;
+    }
+    IWKV_val key = {.compound = id};
+    if (cmp < 0) { // New element
+      key.data = ks.data + ks.keys[i].off;
+      key.size = ks.keys[i].size;
+      rc = iwkv_put(idx->idb, &key, &EMPTY_VAL, IWKV_NO_OVERWRITE);
+      if (!rc) {
+        ++delta;
+      } else if (rc == IWKV_ERROR_KEY_EXISTS) {
+        rc = 0;
+      }
+      ++i;
+    } else { // Element removed
+      key.data = ksprev.data + ksprev.keys[j].off;
+      key.size = ksprev.keys[j].size;
+      rc = iwkv_del(idx->idb, &key, 0);
+      if (!rc) {
+        --delta;
+      } else if (rc == IWKV_ERROR_NOTFOUND) {
+        rc = 0;
+      }
+      ++j;
+    }
+    RCGO(rc, finish);
+  }
+
+finish:
+  free(ks.data);
+  free(ks.keys);
+  free(ksprev.data);
+  free(ksprev.keys);
+  idx->rnum += delta;
+  return rc;
+}
+
+static iwrc _jb_idx_record_add(JBIDX idx, int64_t id, JBL jbl, JBL jblprev) {
+  IWKV_val key;
+  uint8_t step;
+  char vnbuf[IW_VNUMBUFSZ];
+  char numbuf[JBNUMBUF_SIZE];
+
+  bool jbv_found, jbvprev_found;
   struct _JBL jbv = {0}, jbvprev = {0};
   jbl_type_t jbv_type, jbvprev_type;
 
@@ -489,6 +1348,29 @@ static iwrc _jb_idx_record_add(JBIDX idx, int64_t id, JBL jbl, JBL jblprev) {
   int64_t delta = 0; // delta of added/removed index records
   bool compound = idx->idbf & IWDB_COMPOUND_KEYS;
 
+  if (idx->fq) {
+    // Documents not matched by filter of partial index are not indexed
+    bool matched;
+    if (jbl) {
+      rc = jql_matched(idx->fq, jbl, &matched);
+      RCRET(rc);
+      if (!matched) {
+        jbl = 0;
+      }
+    }
+    if (jblprev) {
+      rc = jql_matched(idx->fq, jblprev, &matched);
+      RCRET(rc);
+      if (!matched) {
+        jblprev = 0;
+      }
+    }
+  }
+
+  if (idx->mode & EJDB_IDX_FTS) {
+    return _jb_idx_fts_record_add(idx, id, jbl, jblprev);
+  }
+
   jbvprev_found = jblprev ? _jbl_at(jblprev, idx->ptr, &jbvprev) : false;
   jbv_found = jbl ? _jbl_at(jbl, idx->ptr, &jbv) : false;
 
@@ -505,118 +1387,57 @@ static iwrc _jb_idx_record_add(JBIDX idx, int64_t id, JBL jbl, JBL jblprev) {
     jbv_found = false;
   }
 
-  if (compound
-      && jbv_type == jbvprev_type
-      && jbvprev_type == JBV_ARRAY) { // compare next/prev obj arrays
-    pool = iwpool_create(1024);
-    if (!pool) {
-      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-      goto finish;
-    }
-    JBL_NODE jbvprev_node, jbv_node;
-    rc = jbl_to_node(&jbv, &jbv_node, pool);
-    RCGO(rc, finish);
-    jbv.node = jbv_node;
-
-    rc = jbl_to_node(&jbvprev, &jbvprev_node, pool);
-    RCGO(rc, finish);
-    jbvprev.node = jbvprev_node;
-
-    if (_jbl_compare_nodes(jbv_node, jbvprev_node, &rc) == 0) {
-      goto finish; // Arrays are equal or error
-    }
+  if ((jbv_found && jbv_type == JBV_ARRAY) || (jbvprev_found && jbvprev_type == JBV_ARRAY)) {
+    return _jb_idx_array_record_add(idx, id, jbv_found ? &jbv : 0, jbvprev_found ? &jbvprev : 0);
   } else if (_jbl_is_eq_atomic_values(&jbv, &jbvprev)) {
     return 0;
   }
 
-  if (jbvprev_found) { // Remove old index elements
-    if (jbvprev_type == JBV_ARRAY) { // TODO: array modification delta?
-      JBL_NODE n;
-      if (!pool) {
-        pool = iwpool_create(1024);
-        if (!pool) {
-          rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-        }
-      }
-      rc = jbl_to_node(&jbvprev, &n, pool);
+  if (jbvprev_found) { // Remove old index element
+    jbi_jbl_fill_ikey(idx, &jbvprev, &key, numbuf);
+    if (key.size && (idx->mode & EJDB_IDX_ICASE)) {
+      rc = _jb_idx_key_casefold(&key, &pool);
       RCGO(rc, finish);
-      for (n = n->child; n; n = n->next) {
-        jbi_node_fill_ikey(idx, n, &key, numbuf);
-        if (key.size) {
-          key.compound = id;
-          rc = iwkv_del(idx->idb, &key, 0);
-          if (!rc) {
-            --delta;
-          } else if (rc == IWKV_ERROR_NOTFOUND) {
-            rc = 0;
-          }
-          RCGO(rc, finish);
-        }
-      }
-    } else {
-      jbi_jbl_fill_ikey(idx, &jbvprev, &key, numbuf);
-      if (key.size) {
-        key.compound = id;
-        rc = iwkv_del(idx->idb, &key, 0);
-        if (!rc) {
-          --delta;
-        } else if (rc == IWKV_ERROR_NOTFOUND) {
-          rc = 0;
-        }
-        RCGO(rc, finish);
+    }
+    if (key.size) {
+      key.compound = id;
+      rc = iwkv_del(idx->idb, &key, 0);
+      if (!rc) {
+        --delta;
+      } else if (rc == IWKV_ERROR_NOTFOUND) {
+        rc = 0;
       }
+      RCGO(rc, finish);
     }
   }
 
   if (jbv_found) { // Add index record
-    if (jbv_type == JBV_ARRAY) { // TODO: array modification delta?
-      JBL_NODE n;
-      if (!pool) {
-        pool = iwpool_create(1024);
-        if (!pool) {
-          rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-        }
-      }
-      rc = jbl_to_node(&jbv, &n, pool);
+    jbi_jbl_fill_ikey(idx, &jbv, &key, numbuf);
+    if (key.size && (idx->mode & EJDB_IDX_ICASE)) {
+      rc = _jb_idx_key_casefold(&key, &pool);
       RCGO(rc, finish);
-      for (n = n->child; n; n = n->next) {
-        jbi_node_fill_ikey(idx, n, &key, numbuf);
-        if (key.size) {
-          key.compound = id;
-          rc = iwkv_put(idx->idb, &key, &EMPTY_VAL, IWKV_NO_OVERWRITE);
-          if (!rc) {
-            ++delta;
-          } else if (rc == IWKV_ERROR_KEY_EXISTS) {
-            rc = 0;
-          } else {
-            goto finish;
-          }
+    }
+    if (key.size) {
+      if (compound) {
+        key.compound = id;
+        rc = iwkv_put(idx->idb, &key, &EMPTY_VAL, IWKV_NO_OVERWRITE);
+        if (!rc) {
+          ++delta;
+        } else if (rc == IWKV_ERROR_KEY_EXISTS) {
+          rc = 0;
         }
-      }
-    } else {
-      jbi_jbl_fill_ikey(idx, &jbv, &key, numbuf);
-      if (key.size) {
-        if (compound) {
-          key.compound = id;
-          rc = iwkv_put(idx->idb, &key, &EMPTY_VAL, IWKV_NO_OVERWRITE);
-          if (!rc) {
-            ++delta;
-          } else if (rc == IWKV_ERROR_KEY_EXISTS) {
-            rc = 0;
-          }
-        } else {
-          IW_SETVNUMBUF64(step, vnbuf, id);
-          IWKV_val idval = {
-            .data = vnbuf,
-            .size = step
-          };
-          rc = iwkv_put(idx->idb, &key, &idval, IWKV_NO_OVERWRITE);
-          if (!rc) {
-            ++delta;
-          } else if (rc == IWKV_ERROR_KEY_EXISTS) {
-            rc = EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED;
-            goto finish;
-          }
+      } else {
+        IW_SETVNUMBUF64(step, vnbuf, id);
+        IWKV_val idval = {
+          .data = vnbuf,
+          .size = step
+        };
+        rc = iwkv_put(idx->idb, &key, &idval, IWKV_NO_OVERWRITE);
+        if (!rc) {
+          ++delta;
+        } else if (rc == IWKV_ERROR_KEY_EXISTS) {
+          rc = EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED;
+          goto finish;
         }
       }
     }
@@ -626,9 +1447,7 @@ finish:
   if (pool) {
     iwpool_destroy(pool);
   }
-  if (delta && !_jb_meta_nrecs_update(idx->jbc->db, idx->dbid, delta)) {
-    idx->rnum += delta;
-  }
+  idx->rnum += delta;
   return rc;
 }
 
@@ -652,7 +1471,13 @@ static iwrc _jb_idx_fill(JBIDX idx) {
     }
     rc = iwkv_cursor_get(cur, &key, &val);
     RCBREAK(rc);
+    rc = jb_doc_val_decode(idx->jbc, &val);
+    if (rc) {
+      iwkv_kv_dispose(&key, &val);
+      break;
+    }
     if (!binn_load(val.data, &jbs.bn)) {
+      iwkv_kv_dispose(&key, &val);
       rc = JBL_ERROR_CREATION;
       break;
     }
@@ -664,6 +1489,84 @@ static iwrc _jb_idx_fill(JBIDX idx) {
   return rc;
 }
 
+/**
+ * Checks unique index constraints for document `jbl` to be stored under `id`.
+ * Performed before collection db is touched, so a conflicting put costs one index lookup
+ * instead of the document write followed by rollback.
+ */
+static iwrc _jb_idx_unique_check(JBCOLL jbc, JBL jbl, int64_t id) {
+  iwrc rc = 0;
+  IWPOOL *pool = 0;
+  for (JBIDX idx = jbc->idx; idx; idx = idx->next) {
+    size_t sz;
+    int64_t vid;
+    IWKV_val key;
+    struct _JBL jbv = {0};
+    char numbuf[JBNUMBUF_SIZE];
+    char vnbuf[IW_VNUMBUFSZ];
+    if (!(idx->mode & EJDB_IDX_UNIQUE) || (idx->mode & EJDB_IDX_FTS) || !_jbl_at(jbl, idx->ptr, &jbv)) {
+      continue;
+    }
+    jbl_type_t jbv_type = jbl_type(&jbv);
+    if (jbv_type == JBV_OBJECT || jbv_type == JBV_ARRAY || jbv_type <= JBV_NULL) { // Not indexed
+      continue;
+    }
+    if (idx->fq) {
+      bool matched;
+      rc = jql_matched(idx->fq, jbl, &matched);
+      RCGO(rc, finish);
+      if (!matched) {
+        continue;
+      }
+    }
+    jbi_jbl_fill_ikey(idx, &jbv, &key, numbuf);
+    if (key.size && (idx->mode & EJDB_IDX_ICASE)) {
+      rc = _jb_idx_key_casefold(&key, &pool);
+      RCGO(rc, finish);
+    }
+    if (!key.size) {
+      continue;
+    }
+    rc = iwkv_get_copy(idx->idb, &key, vnbuf, sizeof(vnbuf), &sz);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      rc = 0;
+      continue;
+    }
+    RCGO(rc, finish);
+    IW_READVNUMBUF64_2(vnbuf, vid);
+    if (vid != id) {
+      rc = EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED;
+      goto finish;
+    }
+  }
+
+finish:
+  if (pool) {
+    iwpool_destroy(pool);
+  }
+  return rc;
+}
+
+/**
+ * Returns `false` if value at index `idx` path cannot be changed by update
+ * touching only `ctx->mptrs` document parts.
+ * Partial indexes are always affected since any field of filter query may be changed.
+ */
+static bool _jb_idx_affected(JBIDX idx, const struct _JBPHCTX *ctx) {
+  if (!ctx->mptrs || idx->fq) {
+    return true;
+  }
+  for (int i = 0; i < ctx->mptrs_num; ++i) {
+    JBL_PTR mptr = ctx->mptrs[i];
+    int cnt = MIN(mptr->cnt, idx->ptr->cnt), j = 0;
+    for (; j < cnt && !strcmp(mptr->n[j], idx->ptr->n[j]); ++j);
+    if (j == cnt) { // One pointer is a prefix of another
+      return true;
+    }
+  }
+  return false;
+}
+
 // Used to avoid deadlocks within a `iwkv_put` context
 static iwrc _jb_put_handler_after(iwrc rc, struct _JBPHCTX *ctx) {
   IWKV_val *oldval = &ctx->oldval;
@@ -677,14 +1580,23 @@ static iwrc _jb_put_handler_after(iwrc rc, struct _JBPHCTX *ctx) {
   struct _JBL jblprev;
   JBCOLL jbc = ctx->jbc;
   if (oldval->size) {
-    rc = jbl_from_buf_keep_onstack(&jblprev, oldval->data, oldval->size);
-    RCRET(rc);
+    rc = jb_doc_val_decode(jbc, oldval);
+    if (!rc) {
+      rc = jbl_from_buf_keep_onstack(&jblprev, oldval->data, oldval->size);
+    }
+    if (rc) {
+      iwkv_val_dispose(oldval);
+      return rc;
+    }
     prev = &jblprev;
   } else {
     prev = 0;
   }
   JBIDX fail_idx = 0;
   for (JBIDX idx = jbc->idx; idx; idx = idx->next) {
+    if (prev && !_jb_idx_affected(idx, ctx)) {
+      continue;
+    }
     rc = _jb_idx_record_add(idx, ctx->id, ctx->jbl, prev);
     if (rc) {
       fail_idx = idx;
@@ -692,9 +1604,9 @@ static iwrc _jb_put_handler_after(iwrc rc, struct _JBPHCTX *ctx) {
     }
   }
   if (!prev) {
-    _jb_meta_nrecs_update(jbc->db, jbc->dbid, 1);
-    jbc->rnum += 1;
+    _jb_coll_rnum_add(jbc, 1);
   }
+  _jb_changes_add(jbc, EJDB_CHANGE_PUT, ctx->id, ctx->jbl);
 
 finish:
   if (oldval->size) {
@@ -729,6 +1641,14 @@ static iwrc _jb_exec_scan_init(JBEXEC *ctx) {
   }
   iwrc rc = jbi_selection(ctx);
   RCRET(rc);
+  if (ctx->ux->q->aux->apply || ctx->ux->q->aux->apply_placeholder) {
+    ctx->mpool = iwpool_create(256);
+    if (!ctx->mpool) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    rc = jql_apply_ptrs(ctx->ux->q, &ctx->mptrs, &ctx->mptrs_num, ctx->mpool);
+    RCRET(rc);
+  }
   if (ctx->midx.idx) {
     if (ctx->midx.idx->idbf & IWDB_COMPOUND_KEYS) {
       ctx->scanner = jbi_dup_scanner;
@@ -741,48 +1661,842 @@ static iwrc _jb_exec_scan_init(JBEXEC *ctx) {
       iwxstr_cat2(ctx->ux->log, "[INDEX] NO");
     }
   }
-  return 0;
-}
+  return 0;
+}
+
+static void _jb_exec_scan_release(JBEXEC *ctx) {
+  if (ctx->jblbuf) {
+    free(ctx->jblbuf);
+  }
+  if (ctx->jbldbuf) {
+    free(ctx->jbldbuf);
+  }
+  if (ctx->batch.ids) {
+    free(ctx->batch.ids);
+  }
+  free(ctx->rsm.key);
+  free(ctx->rsm.after_key);
+  if (ctx->mpool) {
+    iwpool_destroy(ctx->mpool);
+  }
+}
+
+IW_INLINE int _jb_hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static iwrc _jb_rsm_init(JBEXEC *ctx, const char *token) {
+  char *ep;
+  const char *p = token;
+  struct _JBRSM *rsm = &ctx->rsm;
+  JBIDX idx = ctx->midx.idx;
+
+  if (ctx->sorting) { // Result set is not ordered by scan
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  if (idx) {
+    errno = 0;
+    unsigned long dbid = strtoul(p, &ep, 10);
+    if (ep == p || errno || dbid != idx->dbid) {
+      return EJDB_ERROR_INVALID_RESUME_TOKEN;
+    }
+  } else if (*p == 'c') {
+    ep = (char *) p + 1;
+  } else {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  p = ep;
+  if (p[0] != '.' || (p[1] != 'n' && p[1] != 'p') || p[2] != '.') {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  rsm->step = (p[1] == 'n') ? IWKV_CURSOR_NEXT : IWKV_CURSOR_PREV;
+  p += 3;
+  errno = 0;
+  rsm->after_id = strtoll(p, &ep, 10);
+  if (ep == p || errno || rsm->after_id < 1) {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  p = ep;
+  if (idx) {
+    size_t len;
+    if (*p++ != '.' || !(len = strlen(p)) || (len & 1)) {
+      return EJDB_ERROR_INVALID_RESUME_TOKEN;
+    }
+    rsm->after_key = malloc(len / 2);
+    if (!rsm->after_key) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    for (size_t i = 0; i < len; i += 2) {
+      int h = _jb_hex_digit(p[i]), l = _jb_hex_digit(p[i + 1]);
+      if (h < 0 || l < 0) {
+        return EJDB_ERROR_INVALID_RESUME_TOKEN;
+      }
+      rsm->after_key[rsm->after_keysz++] = (uint8_t) ((h << 4) | l);
+    }
+  } else if (*p) {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  rsm->after = true;
+  return 0;
+}
+
+static iwrc _jb_rsm_token(JBEXEC *ctx, IWXSTR *xstr) {
+  iwrc rc;
+  struct _JBRSM *rsm = &ctx->rsm;
+  JBIDX idx = ctx->midx.idx;
+  IWKV_cursor_op step = idx ? ctx->midx.cursor_step : ctx->cursor_step;
+  char dir = (step == IWKV_CURSOR_NEXT) ? 'n' : 'p';
+  if (idx) {
+    rc = iwxstr_printf(xstr, "%u.%c.%lld.", idx->dbid, dir, (long long) rsm->id);
+    RCRET(rc);
+    for (size_t i = 0; i < rsm->keysz; ++i) {
+      rc = iwxstr_printf(xstr, "%02x", rsm->key[i]);
+      RCRET(rc);
+    }
+  } else {
+    rc = iwxstr_printf(xstr, "c.%c.%lld", dir, (long long) rsm->id);
+  }
+  return rc;
+}
+
+static iwrc _jb_exec_scan(JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  if (ctx->scanner != jbi_full_scanner
+      && (ctx->sorting
+          || ((aux->qmode & JQP_QRY_GROUP) && !ctx->grp.ordered)
+          || ((aux->qmode & JQP_QRY_AGGREGATE)
+              && !(aux->qmode & JQP_QRY_APPLY_DEL)
+              && !aux->apply && !aux->apply_placeholder))) {
+    // Order of index scan is not significant here so documents
+    // are fetched in batches sorted by id avoiding random reads of collection db
+    ctx->batch.consumer = consumer;
+    return ctx->scanner(ctx, jbi_batch_consumer);
+  }
+  return ctx->scanner(ctx, consumer);
+}
+
+static iwrc _jb_noop_visitor(struct _EJDB_EXEC *ctx, EJDB_DOC doc, int64_t *step) {
+  return 0;
+}
+
+/**
+ * Counts matched documents without reading them if query filter is served entirely
+ * by selected index or matches all documents of collection.
+ */
+static bool _jb_exec_count_init(JBEXEC *ctx, const char *after) {
+  EJDB_EXEC *ux = ctx->ux;
+  struct JQP_AUX *aux = ux->q->aux;
+  if (after || ux->next || jql_has_apply(ux->q) || (aux->qmode & JQP_QRY_GROUP)) {
+    return false;
+  }
+  if (!(aux->qmode & JQP_QRY_AGGREGATE) && ux->visitor != _jb_noop_visitor) {
+    return false;
+  }
+  return jbi_count_covered(ctx);
+}
+
+static iwrc _jb_exec_count(JBEXEC *ctx) {
+  EJDB_EXEC *ux = ctx->ux;
+  if (!ctx->midx.idx) {
+    int64_t cnt = ctx->jbc->rnum - ux->skip;
+    if (cnt > ux->limit) {
+      cnt = ux->limit;
+    }
+    if (cnt > 0) {
+      ux->cnt += cnt;
+    }
+    return 0;
+  }
+  return ctx->scanner(ctx, jbi_count_consumer);
+}
+
+IW_INLINE int _jb_doc_vnum_write(uint32_t v, unsigned char *out) {
+  int len = 0;
+  do {
+    out[len] = v & 0x7fU;
+    v >>= 7;
+    if (v) out[len] |= 0x80U;
+    ++len;
+  } while (v);
+  return len;
+}
+
+/** Reads varint written by `_jb_doc_vnum_write()`, returns pointer to the next byte or zero on error */
+IW_INLINE unsigned char *_jb_doc_vnum_read(unsigned char *p, const unsigned char *plimit, uint32_t *vp) {
+  uint32_t v = 0;
+  for (int s = 0; ; s += 7) {
+    if (p >= plimit || s > 28) {
+      return 0;
+    }
+    v |= (uint32_t) (*p & 0x7fU) << s;
+    if (!(*p++ & 0x80U)) break;
+  }
+  *vp = v;
+  return p;
+}
+
+struct _JBKDWCTX {
+  JBCOLL jbc;
+  iwrc rc;
+};
+
+/**
+ * Gets dictionary id of the given `key`, new keys are persisted in metadb.
+ * Sets `*idp` to zero if dictionary is full.
+ */
+static iwrc _jb_kdict_key_id(JBCOLL jbc, const char *key, int keylen, uint32_t *idp) {
+  struct _JBKDICT *kd = &jbc->kdict;
+  char kbuf[256];
+  *idp = 0;
+  memcpy(kbuf, key, keylen);
+  kbuf[keylen] = '\0';
+  if (kd->map) {
+    khiter_t k = kh_get(JBKDICTM, kd->map, kbuf);
+    if (k != kh_end(kd->map)) {
+      *idp = kh_value(kd->map, k);
+      return 0;
+    }
+  }
+  if (kd->num >= JB_KDICT_MAX_KEYS) {
+    return 0;
+  }
+  uint32_t id = kd->num + 1;
+  char keybuf[sizeof(KEY_PREFIX_KDICT) + 2 * JBNUMBUF_SIZE];
+  IWKV_val mkey, mval = {
+    .data = kbuf,
+    .size = keylen
+  };
+  mkey.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_KDICT "%u" "." "%u", jbc->dbid, id);
+  if (mkey.size >= sizeof(keybuf)) {
+    return IW_ERROR_OVERFLOW;
+  }
+  mkey.data = keybuf;
+  iwrc rc = iwkv_put(jbc->db->metadb, &mkey, &mval, 0);
+  RCRET(rc);
+  rc = _jb_kdict_register(kd, id, kbuf, keylen);
+  RCRET(rc);
+  *idp = id;
+  return rc;
+}
+
+/**
+ * Writes object key as varint: `(id << 1) | 1` for dictionary keys
+ * or `keylen << 1` followed by key bytes for keys stored as is.
+ */
+static int _jb_kdict_key_write(const unsigned char *key, int keylen, unsigned char *out, void *op) {
+  struct _JBKDWCTX *wctx = op;
+  uint32_t id = 0;
+  if (keylen > 0 && !memchr(key, '\0', keylen)) {
+    wctx->rc = _jb_kdict_key_id(wctx->jbc, (const char *) key, keylen, &id);
+    if (wctx->rc) {
+      return -1;
+    }
+  }
+  if (id) {
+    return _jb_doc_vnum_write((id << 1) | 1U, out);
+  }
+  int len = _jb_doc_vnum_write((uint32_t) keylen << 1, out);
+  memcpy(out + len, key, keylen);
+  return len + keylen;
+}
+
+static unsigned char *_jb_kdict_key_read(unsigned char *p, unsigned char *plimit,
+                                         const unsigned char **pkey, int *pkeylen, void *op) {
+  JBCOLL jbc = op;
+  struct _JBKDICT *kd = &jbc->kdict;
+  uint32_t v;
+  p = _jb_doc_vnum_read(p, plimit, &v);
+  if (!p) {
+    return 0;
+  }
+  if (v & 1) {
+    v >>= 1;
+    if (!v || v > kd->num || !kd->keys[v - 1].key) {
+      return 0;
+    }
+    *pkey = (const unsigned char *) kd->keys[v - 1].key;
+    *pkeylen = kd->keys[v - 1].len;
+    return p;
+  }
+  v >>= 1;
+  if (v > 255 || p + v >= plimit) {
+    return 0;
+  }
+  *pkey = p;
+  *pkeylen = (int) v;
+  return p + v;
+}
+
+/**
+ * Decodes single encoding layer of stored document `data` placing result at `off` of reallocatable `*pbuf` buffer.
+ */
+static iwrc _jb_doc_decode(JBCOLL jbc, void *data, size_t size, void **pbuf, size_t *pbufsz, size_t off,
+                           size_t *psize) {
+  uint8_t *rp = data;
+  if (size < 2 || off > INT_MAX) {
+    return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+  }
+  if (*rp == JB_DOC_KDICT) {
+    int sz, alloc = (int) MIN(*pbufsz, INT_MAX);
+    uint32_t threshold = jbc->db->opts.keys_dir_threshold;
+    binn_rewrite_spec spec = {
+      .min_keys = threshold > INT_MAX ? INT_MAX : (int) threshold,
+      .key_read = _jb_kdict_key_read,
+      .op = jbc
+    };
+    BOOL ret = binn_rewrite(rp + 1, &spec, pbuf, &alloc, (int) off, &sz);
+    *pbufsz = alloc;
+    if (!ret) {
+      return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+    }
+    *psize = sz;
+  } else if (*rp == JB_DOC_LZ || *rp == JB_DOC_LZDICT) {
+    uint32_t sz;
+    const uint8_t *dict = 0;
+    uint8_t *ep = rp + size;
+    if (*rp == JB_DOC_LZDICT) {
+      if (!jbc->zdict) {
+        return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+      }
+      dict = jbc->zdict;
+    }
+    rp = _jb_doc_vnum_read(rp + 1, ep, &sz);
+    if (!rp || sz > INT_MAX) {
+      return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+    }
+    if (*pbufsz < off + sz) {
+      void *nbuf = realloc(*pbuf, off + sz);
+      if (!nbuf) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      *pbuf = nbuf;
+      *pbufsz = off + sz;
+    }
+    if (lzb_decompress(dict, jbc->zdictsz, rp, ep - rp, (uint8_t *) *pbuf + off, sz) != sz) {
+      return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+    }
+    *psize = sz;
+  } else {
+    return EJDB_ERROR_INVALID_DOCUMENT_ENCODING;
+  }
+  return 0;
+}
+
+iwrc jb_doc_val_decode(JBCOLL jbc, IWKV_val *val) {
+  while (jb_doc_is_encoded(val->data, val->size)) {
+    void *buf = 0;
+    size_t bufsz = 0, sz;
+    iwrc rc = _jb_doc_decode(jbc, val->data, val->size, &buf, &bufsz, 0, &sz);
+    if (rc) {
+      free(buf);
+      return rc;
+    }
+    iwkv_val_dispose(val);
+    val->data = buf;
+    val->size = sz;
+  }
+  return 0;
+}
+
+iwrc jb_exec_doc_decode(struct _JBEXEC *ctx, size_t off, size_t *vszp) {
+  while (jb_doc_is_encoded(ctx->jblbuf + off, *vszp)) {
+    size_t sz, bufsz;
+    void *buf = ctx->jbldbuf;
+    iwrc rc = _jb_doc_decode(ctx->jbc, ctx->jblbuf + off, *vszp, &buf, &ctx->jbldbufsz, off, &sz);
+    ctx->jbldbuf = buf;
+    RCRET(rc);
+    memcpy(ctx->jbldbuf, ctx->jblbuf, off);
+    // Decoded document buffer becomes current
+    buf = ctx->jblbuf;
+    bufsz = ctx->jblbufsz;
+    ctx->jblbuf = ctx->jbldbuf;
+    ctx->jblbufsz = ctx->jbldbufsz;
+    ctx->jbldbuf = buf;
+    ctx->jbldbufsz = bufsz;
+    *vszp = sz;
+  }
+  return 0;
+}
+
+/**
+ * Compresses document data `val` if it exceeds collection compression threshold.
+ * `*bufp` holds buffer of `val` data to be replaced by compressed document buffer.
+ */
+static iwrc _jb_doc_compress(JBCOLL jbc, IWKV_val *val, void **bufp) {
+  if (!jbc->zthreshold || val->size < jbc->zthreshold || val->size > INT_MAX) {
+    return 0;
+  }
+  size_t cap = 1 + IW_VNUMBUFSZ + LZB_COMPRESS_BOUND(val->size);
+  uint8_t *buf = malloc(cap);
+  if (!buf) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  buf[0] = jbc->zdict ? JB_DOC_LZDICT : JB_DOC_LZ;
+  size_t hsz = 1 + _jb_doc_vnum_write((uint32_t) val->size, buf + 1);
+  size_t sz = lzb_compress(jbc->zdict, jbc->zdictsz, val->data, val->size, buf + hsz, cap - hsz);
+  if (!sz || hsz + sz >= val->size) { // Not compressible
+    free(buf);
+    return 0;
+  }
+  free(*bufp);
+  *bufp = buf;
+  val->data = buf;
+  val->size = hsz + sz;
+  return 0;
+}
+
+/**
+ * Gets serialized document to be stored.
+ * Object keys are replaced by ids of collection keys dictionary if it is enabled for collection.
+ * Wide objects are stored along with sorted keys directory if `EJDB_OPTS.keys_dir_threshold` is set.
+ * Large documents are compressed if compression is enabled for collection.
+ * In these cases `*bufp` is set to allocated buffer which must be freed by caller.
+ */
+static iwrc _jb_doc_as_buf(JBCOLL jbc, JBL jbl, IWKV_val *val, void **bufp) {
+  *bufp = 0;
+  iwrc rc = jbl_as_buf(jbl, &val->data, &val->size);
+  RCRET(rc);
+  uint32_t threshold = jbc->db->opts.keys_dir_threshold;
+  if (jbc->kdict.enabled && jbl->bn.type == BINN_OBJECT) {
+    void *buf = 0;
+    int sz, alloc = 0;
+    struct _JBKDWCTX wctx = {
+      .jbc = jbc
+    };
+    binn_rewrite_spec spec = {
+      .key_write = _jb_kdict_key_write,
+      .op = &wctx
+    };
+    if (!binn_rewrite(val->data, &spec, &buf, &alloc, 1, &sz)) {
+      free(buf);
+      return wctx.rc ? wctx.rc : JBL_ERROR_CREATION;
+    }
+    *(uint8_t *) buf = JB_DOC_KDICT;
+    *bufp = buf;
+    val->data = buf;
+    val->size = sz + 1;
+  } else if (threshold && jbl->bn.type == BINN_OBJECT) {
+    int sz;
+    void *buf = binn_keys_dir_copy(val->data, threshold > INT_MAX ? INT_MAX : (int) threshold, &sz);
+    if (!buf) {
+      return JBL_ERROR_CREATION;
+    }
+    *bufp = buf;
+    val->data = buf;
+    val->size = sz;
+  }
+  return _jb_doc_compress(jbc, val, bufp);
+}
+
+IW_INLINE iwrc _jb_put_impl(JBCOLL jbc, JBL jbl, int64_t id, JBL_PTR *mptrs, int mptrs_num) {
+  void *buf;
+  IWKV_val val, key = {
+    .data = &id,
+    .size = sizeof(id)
+  };
+  struct _JBPHCTX pctx = {
+    .id = id,
+    .jbc = jbc,
+    .jbl = jbl,
+    .mptrs = mptrs,
+    .mptrs_num = mptrs_num
+  };
+  iwrc rc = _jb_idx_unique_check(jbc, jbl, id);
+  RCRET(rc);
+  rc = _jb_doc_as_buf(jbc, jbl, &val, &buf);
+  RCRET(rc);
+  rc = _jb_put_handler_after(iwkv_puth(jbc->cdb, &key, &val, 0, _jb_put_handler, &pctx), &pctx);
+  free(buf);
+  return rc;
+}
+
+iwrc jb_put(JBCOLL jbc, JBL jbl, int64_t id, JBL_PTR *mptrs, int mptrs_num) {
+  return _jb_put_impl(jbc, jbl, id, mptrs, mptrs_num);
+}
+
+iwrc jb_cursor_set(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl, JBL_PTR *mptrs, int mptrs_num) {
+  void *buf;
+  IWKV_val val;
+  struct _JBPHCTX pctx = {
+    .id = id,
+    .jbc = jbc,
+    .jbl = jbl,
+    .mptrs = mptrs,
+    .mptrs_num = mptrs_num
+  };
+  iwrc rc = _jb_idx_unique_check(jbc, jbl, id);
+  RCRET(rc);
+  rc = _jb_doc_as_buf(jbc, jbl, &val, &buf);
+  RCRET(rc);
+  rc = _jb_put_handler_after(iwkv_cursor_seth(cur, &val, 0, _jb_put_handler, &pctx), &pctx);
+  free(buf);
+  return rc;
+}
+
+//----------------------- TTL indexes
+
+// Collects ids of documents expired at `now` walking TTL index from the oldest timestamps
+static iwrc _jb_ttl_collect(JBIDX idx, int64_t now, int64_t ids[static JB_TTL_BATCH_SIZE], int *nump) {
+  IWKV_cursor cur;
+  int num = *nump;
+  iwrc rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_AFTER_LAST, 0);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    return 0;
+  }
+  RCRET(rc);
+  while (num < JB_TTL_BATCH_SIZE && !(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV))) {
+    size_t sz;
+    int64_t ts, id = 0;
+    rc = iwkv_cursor_copy_key(cur, &ts, sizeof(ts), &sz, &id);
+    RCBREAK(rc);
+    if (ts > now) {
+      break;
+    }
+    if (!(idx->idbf & IWDB_COMPOUND_KEYS)) { // Unique index keeps document id as value
+      char numbuf[IW_VNUMBUFSZ];
+      rc = iwkv_cursor_copy_val(cur, numbuf, IW_VNUMBUFSZ, &sz);
+      RCBREAK(rc);
+      if (sz > IW_VNUMBUFSZ) {
+        rc = IWKV_ERROR_CORRUPTED;
+        iwlog_ecode_error3(rc);
+        break;
+      }
+      IW_READVNUMBUF64_2(numbuf, id);
+    }
+    ids[num++] = id;
+  }
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  iwkv_cursor_close(&cur);
+  *nump = num;
+  return rc;
+}
+
+// Removes a batch of expired documents, `more` is set if the next batch may exist
+static iwrc _jb_ttl_expire_batch(EJDB db, const char *coll, int64_t now, bool *more) {
+  int rci, num = 0;
+  JBCOLL jbc;
+  int64_t ids[JB_TTL_BATCH_SIZE];
+  *more = false;
+  iwrc rc = _jb_coll_acquire_keeplock2(db, coll, JB_COLL_ACQUIRE_WRITE | JB_COLL_ACQUIRE_EXISTING, &jbc);
+  if (rc == IW_ERROR_NOT_EXISTS) {
+    return 0;
+  }
+  RCRET(rc);
+  for (JBIDX idx = jbc->idx; idx && num < JB_TTL_BATCH_SIZE; idx = idx->next) {
+    if (idx->mode & EJDB_IDX_TTL) {
+      rc = _jb_ttl_collect(idx, now, ids, &num);
+      RCGO(rc, finish);
+    }
+  }
+  for (int i = 0; i < num; ++i) {
+    struct _JBL jbl;
+    IWKV_val val = {0};
+    IWKV_val key = {.data = &ids[i], .size = sizeof(ids[i])};
+    rc = iwkv_get(jbc->cdb, &key, &val);
+    if (rc == IWKV_ERROR_NOTFOUND) { // Removed already, document has many keys in TTL indexes
+      rc = 0;
+      continue;
+    }
+    RCGO(rc, finish);
+    rc = jb_doc_val_decode(jbc, &val);
+    if (!rc) {
+      rc = jbl_from_buf_keep_onstack(&jbl, val.data, val.size);
+    }
+    if (!rc) {
+      rc = jb_del(jbc, &jbl, ids[i]);
+    }
+    if (val.data) {
+      iwkv_val_dispose(&val);
+    }
+    RCGO(rc, finish);
+  }
+  *more = (num == JB_TTL_BATCH_SIZE);
+
+finish:
+  API_COLL_UNLOCK(jbc, rci, rc);
+  _jb_changes_dispatch(db);
+  return rc;
+}
+
+static iwrc _jb_ttl_expire(EJDB db, int64_t now) {
+  int rci, num = 0;
+  char **names = 0;
+  API_RLOCK(db, rci);
+  iwrc rc = 0;
+  pthread_rwlock_rdlock(&db->crwl);
+  names = calloc(kh_size(db->mcolls) + 1, sizeof(*names));
+  if (!names) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    pthread_rwlock_unlock(&db->crwl);
+    API_UNLOCK(db, rci, rc);
+    return rc;
+  }
+  for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
+    if (!kh_exist(db->mcolls, k)) continue;
+    JBCOLL jbc = kh_val(db->mcolls, k);
+    // Indexes are added, removed and loaded under collection write lock
+    pthread_rwlock_rdlock(&jbc->rwl);
+    for (JBIDX idx = jbc->idx; idx; idx = idx->next) {
+      if (idx->mode & EJDB_IDX_TTL) {
+        names[num] = strdup(jbc->name);
+        if (!names[num]) {
+          rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        } else {
+          ++num;
+        }
+        break;
+      }
+    }
+    pthread_rwlock_unlock(&jbc->rwl);
+  }
+  pthread_rwlock_unlock(&db->crwl);
+  API_UNLOCK(db, rci, rc);
+
+  // Collection lock is released between batches allowing other writers to proceed
+  for (int i = 0; !rc && i < num && !db->ttl.stop; ++i) {
+    bool more;
+    do {
+      rc = _jb_ttl_expire_batch(db, names[i], now, &more);
+    } while (!rc && more && !db->ttl.stop);
+  }
+  for (int i = 0; i < num; ++i) {
+    free(names[i]);
+  }
+  free(names);
+  return rc;
+}
+
+static void *_jb_ttl_thread(void *op) {
+  EJDB db = op;
+  struct timespec ts;
+  struct _JBTTL *ttl = &db->ttl;
+  long interval = db->opts.ttl_interval_ms;
+  pthread_mutex_lock(&ttl->mtx);
+  while (!ttl->stop) {
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += interval / 1000;
+    ts.tv_nsec += (interval % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec += 1;
+      ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&ttl->cond, &ttl->mtx, &ts);
+    if (ttl->stop) {
+      break;
+    }
+    pthread_mutex_unlock(&ttl->mtx);
+    clock_gettime(CLOCK_REALTIME, &ts);
+    iwrc rc = _jb_ttl_expire(db, (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+    if (rc) {
+      iwlog_ecode_error3(rc);
+    }
+    pthread_mutex_lock(&ttl->mtx);
+  }
+  pthread_mutex_unlock(&ttl->mtx);
+  return 0;
+}
+
+// Starts expiry thread once the first TTL index is known
+static iwrc _jb_ttl_start(EJDB db) {
+  iwrc rc = 0;
+  struct _JBTTL *ttl = &db->ttl;
+  if (db->oflags & IWKV_RDONLY) {
+    return 0;
+  }
+  pthread_mutex_lock(&ttl->mtx);
+  if (!ttl->started && !ttl->stop) {
+    int rci = pthread_create(&ttl->thread, 0, _jb_ttl_thread, db);
+    if (rci) {
+      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+    } else {
+      ttl->started = true;
+    }
+  }
+  pthread_mutex_unlock(&ttl->mtx);
+  return rc;
+}
+
+static void _jb_ttl_shutdown(EJDB db) {
+  struct _JBTTL *ttl = &db->ttl;
+  pthread_mutex_lock(&ttl->mtx);
+  ttl->stop = true;
+  pthread_cond_broadcast(&ttl->cond);
+  bool started = ttl->started;
+  pthread_mutex_unlock(&ttl->mtx);
+  if (started) {
+    pthread_join(ttl->thread, 0);
+    ttl->started = false;
+  }
+}
+
+/**
+ * Loads collections having TTL indexes at database open and starts expiry thread,
+ * other collections are loaded on first access.
+ */
+static iwrc _jb_ttl_load(EJDB db) {
+  IWKV_cursor cur;
+  IWKV_val kval = {
+    .data = KEY_PREFIX_IDXMETA,
+    .size = sizeof(KEY_PREFIX_IDXMETA) - 1
+  };
+  bool matched = false;
+  iwrc rc = iwkv_cursor_open(db->metadb, &cur, IWKV_CURSOR_GE, &kval);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    return 0;
+  }
+  RCRET(rc);
+  do {
+    IWKV_val key, val;
+    struct _JBL imeta;
+    uint8_t mode = 0;
+    char buf[sizeof(KEY_PREFIX_IDXMETA) + 2 * JBNUMBUF_SIZE];
+    rc = iwkv_cursor_get(cur, &key, &val);
+    RCBREAK(rc);
+    // Full key format: i.<coldbid>.<idxdbid>
+    if (key.size < kval.size || key.size >= sizeof(buf) || strncmp(key.data, KEY_PREFIX_IDXMETA, kval.size)) {
+      iwkv_kv_dispose(&key, &val);
+      if (matched) {
+        break; // Index meta keys are passed
+      }
+      continue;
+    }
+    matched = true;
+    memcpy(buf, key.data, key.size);
+    buf[key.size] = '\0';
+    if (!jbl_from_buf_keep_onstack(&imeta, val.data, val.size)
+        && binn_object_get_uint8(&imeta.bn, "mode", &mode)
+        && (mode & EJDB_IDX_TTL)) {
+      uint32_t dbid = (uint32_t) strtoul(buf + kval.size, 0, 10);
+      for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
+        if (!kh_exist(db->mcolls, k)) continue;
+        JBCOLL jbc = kh_val(db->mcolls, k);
+        if (jbc->dbid == dbid) {
+          rc = _jb_coll_load_lw(jbc);
+          if (!rc) {
+            rc = _jb_ttl_start(db);
+          }
+          break;
+        }
+      }
+    }
+    iwkv_kv_dispose(&key, &val);
+  } while (!rc && !(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV)));
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  IWRC(iwkv_cursor_close(&cur), rc);
+  return rc;
+}
+
+//----------------------- Snapshots
+
+/**
+ * Writes database backup into `<target_file>.tmp` then renames it to `target_file`.
+ * Record counters are flushed before backup, but any write between the flush and the backup
+ * stores NUMRECS_DIRTY_ID marker again, so such snapshot is recounted when opened.
+ */
+static iwrc _jb_snapshot(EJDB db, uint64_t *ts, const char *target_file) {
+  int rci;
+  iwrc rc = 0;
+  uint64_t lts;
+  size_t len = strlen(target_file);
+  char *tmp = malloc(len + sizeof(".tmp"));
+  if (!tmp) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  memcpy(tmp, target_file, len);
+  memcpy(tmp + len, ".tmp", sizeof(".tmp"));
+
+  // Temporary file name is fixed so snapshots are written one by one
+  pthread_mutex_lock(&db->snap.wmtx);
+  rci = pthread_rwlock_rdlock(&db->rwl);
+  if (rci) {
+    rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+    goto finish;
+  }
+  rc = _jb_db_nrecs_flush_shared(db);
+  API_UNLOCK(db, rci, rc);
+  RCGO(rc, finish);
 
-static void _jb_exec_scan_release(JBEXEC *ctx) {
-  if (ctx->jblbuf) {
-    free(ctx->jblbuf);
+  unlink(tmp); // Leftover of failed snapshot
+  rc = iwkv_online_backup(db->iwkv, ts ? ts : &lts, tmp);
+  if (!rc && rename(tmp, target_file) == -1) {
+    rc = iwrc_set_errno(IW_ERROR_IO_ERRNO, errno);
+  }
+  if (rc) {
+    unlink(tmp);
   }
-}
 
-static iwrc _jb_noop_visitor(struct _EJDB_EXEC *ctx, EJDB_DOC doc, int64_t *step) {
-  return 0;
+finish:
+  pthread_mutex_unlock(&db->snap.wmtx);
+  free(tmp);
+  return rc;
 }
 
-IW_INLINE iwrc _jb_put_impl(JBCOLL jbc, JBL jbl, int64_t id) {
-  IWKV_val val, key = {
-    .data = &id,
-    .size = sizeof(id)
-  };
-  struct _JBPHCTX pctx = {
-    .id = id,
-    .jbc = jbc,
-    .jbl = jbl
-  };
-  iwrc rc = jbl_as_buf(jbl, &val.data, &val.size);
-  RCRET(rc);
-  return _jb_put_handler_after(iwkv_puth(jbc->cdb, &key, &val, 0, _jb_put_handler, &pctx), &pctx);
+static void *_jb_snapshot_thread(void *op) {
+  EJDB db = op;
+  struct timespec ts;
+  struct _JBSNAP *snap = &db->snap;
+  long interval = db->opts.snapshot_interval_ms;
+  pthread_mutex_lock(&snap->mtx);
+  while (!snap->stop) {
+    pthread_mutex_unlock(&snap->mtx);
+    iwrc rc = _jb_snapshot(db, 0, db->opts.snapshot_path);
+    if (rc) {
+      iwlog_ecode_error3(rc);
+    }
+    pthread_mutex_lock(&snap->mtx);
+    if (snap->stop) {
+      break;
+    }
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += interval / 1000;
+    ts.tv_nsec += (interval % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec += 1;
+      ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&snap->cond, &snap->mtx, &ts);
+  }
+  pthread_mutex_unlock(&snap->mtx);
+  return 0;
 }
 
-iwrc jb_put(JBCOLL jbc, JBL jbl, int64_t id) {
-  return _jb_put_impl(jbc, jbl, id);
+static iwrc _jb_snapshot_start(EJDB db) {
+  iwrc rc = 0;
+  struct _JBSNAP *snap = &db->snap;
+  if (!db->opts.snapshot_path || (db->oflags & IWKV_RDONLY)) {
+    return 0;
+  }
+  pthread_mutex_lock(&snap->mtx);
+  if (!snap->started && !snap->stop) {
+    int rci = pthread_create(&snap->thread, 0, _jb_snapshot_thread, db);
+    if (rci) {
+      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+    } else {
+      snap->started = true;
+    }
+  }
+  pthread_mutex_unlock(&snap->mtx);
+  return rc;
 }
 
-iwrc jb_cursor_set(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl) {
-  IWKV_val val;
-  struct _JBPHCTX pctx = {
-    .id = id,
-    .jbc = jbc,
-    .jbl = jbl
-  };
-  iwrc rc = jbl_as_buf(jbl, &val.data, &val.size);
-  RCRET(rc);
-  return _jb_put_handler_after(iwkv_cursor_seth(cur, &val, 0, _jb_put_handler, &pctx), &pctx);
+static void _jb_snapshot_shutdown(EJDB db) {
+  struct _JBSNAP *snap = &db->snap;
+  pthread_mutex_lock(&snap->mtx);
+  snap->stop = true;
+  pthread_cond_broadcast(&snap->cond);
+  bool started = snap->started;
+  pthread_mutex_unlock(&snap->mtx);
+  if (started) {
+    pthread_join(snap->thread, 0);
+    snap->started = false;
+  }
 }
 
 //----------------------- Public API
@@ -815,6 +2529,17 @@ iwrc ejdb_exec(EJDB_EXEC *ux) {
     rc = jql_get_skip(ux->q, &ux->skip);
     RCRET(rc);
   }
+  const char *after = ux->after;
+  if (!after) {
+    rc = jql_get_after(ux->q, &after);
+    RCRET(rc);
+  }
+  if (after && (ux->q->aux->qmode & JQP_QRY_GROUP)) {
+    return JQL_ERROR_INVALID_AGGREGATE;
+  }
+  if (ux->next) {
+    iwxstr_clear(ux->next);
+  }
   rc = _jb_coll_acquire_keeplock2(ux->db, ux->q->coll,
                                   jql_has_apply(ux->q) ? JB_COLL_ACQUIRE_WRITE : JB_COLL_ACQUIRE_EXISTING,
                                   &ctx.jbc);
@@ -824,22 +2549,49 @@ iwrc ejdb_exec(EJDB_EXEC *ux) {
 
   rc = _jb_exec_scan_init(&ctx);
   RCGO(rc, finish);
-  if (ctx.sorting) {
+  if (after) {
+    rc = _jb_rsm_init(&ctx, after);
+    RCGO(rc, finish);
+  }
+  if (_jb_exec_count_init(&ctx, after)) {
+    if (ux->log) {
+      iwxstr_cat2(ux->log, " [COLLECTOR] COUNT\n");
+    }
+    rc = _jb_exec_count(&ctx);
+  } else if (ux->q->aux->qmode & JQP_QRY_GROUP) {
+    JBIDX gidx = jbi_group_index_covered(&ctx);
+    if (gidx) {
+      if (ux->log) {
+        iwxstr_cat2(ux->log, " [COLLECTOR] GROUP INDEX\n");
+      }
+      rc = jbi_group_index_scan(&ctx, gidx);
+    } else {
+      if (ux->log) {
+        iwxstr_cat2(ux->log, ctx.grp.ordered ? " [COLLECTOR] GROUP ORDERED\n" : " [COLLECTOR] GROUP\n");
+      }
+      rc = _jb_exec_scan(&ctx, jbi_group_consumer);
+    }
+  } else if (ctx.sorting) {
     if (ux->log) {
       iwxstr_cat2(ux->log, " [COLLECTOR] SORTER\n");
     }
-    rc = ctx.scanner(&ctx, jbi_sorter_consumer);
+    rc = _jb_exec_scan(&ctx, jbi_sorter_consumer);
   } else {
     if (ux->log) {
       iwxstr_cat2(ux->log, " [COLLECTOR] PLAIN\n");
     }
-    rc = ctx.scanner(&ctx, jbi_consumer);
+    ctx.rsm.track = (ux->next != 0);
+    rc = _jb_exec_scan(&ctx, jbi_consumer);
+    if (!rc && ctx.rsm.id) {
+      rc = _jb_rsm_token(&ctx, ux->next);
+    }
   }
 
 finish:
   _jb_exec_scan_release(&ctx);
   API_COLL_UNLOCK(ctx.jbc, rci, rc);
   jql_reset(ux->q, true, false);
+  _jb_changes_dispatch(ux->db);
   return rc;
 }
 
@@ -1051,6 +2803,10 @@ finish:
 }
 
 iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mode_t mode) {
+  return ejdb_ensure_index2(db, coll, path, mode, 0);
+}
+
+iwrc ejdb_ensure_index2(EJDB db, const char *coll, const char *path, ejdb_idx_mode_t mode, const char *filter) {
   if (!db || !coll || !path) {
     return IW_ERROR_INVALID_ARGS;
   }
@@ -1063,14 +2819,26 @@ iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mod
   JBL_PTR ptr = 0;
   binn *imeta = 0;
 
-  switch (mode & (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64)) {
+  switch (mode & (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64 | EJDB_IDX_FTS)) {
     case EJDB_IDX_STR:
+      break;
     case EJDB_IDX_I64:
     case EJDB_IDX_F64:
+      if (mode & EJDB_IDX_ICASE) {
+        return EJDB_ERROR_INVALID_INDEX_MODE;
+      }
+      break;
+    case EJDB_IDX_FTS:
+      if (mode & (EJDB_IDX_UNIQUE | EJDB_IDX_ICASE)) {
+        return EJDB_ERROR_INVALID_INDEX_MODE;
+      }
       break;
     default:
       return EJDB_ERROR_INVALID_INDEX_MODE;
   }
+  if ((mode & EJDB_IDX_TTL) && !(mode & EJDB_IDX_I64)) {
+    return EJDB_ERROR_INVALID_INDEX_MODE;
+  }
 
   iwrc rc = _jb_coll_acquire_keeplock(db, coll, true, &jbc);
   RCRET(rc);
@@ -1082,6 +2850,9 @@ iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mod
       if (idx->mode != mode) {
         rc = EJDB_ERROR_MISMATCHED_INDEX_UNIQUENESS_MODE;
         idx = 0;
+      } else if (filter ? (!idx->filter || strcmp(idx->filter, filter) != 0) : idx->filter != 0) {
+        rc = EJDB_ERROR_MISMATCHED_INDEX_FILTER;
+        idx = 0;
       }
       goto finish;
     }
@@ -1096,11 +2867,13 @@ iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mod
   idx->jbc = jbc;
   idx->ptr = ptr;
   ptr = 0;
+  if (filter) {
+    rc = _jb_idx_filter_create(idx, coll, filter);
+    RCGO(rc, finish);
+  }
   idx->idbf = 0;
   if (mode & EJDB_IDX_I64) {
     idx->idbf |= IWDB_VNUM64_KEYS;
-  } else if (mode & EJDB_IDX_F64) {
-    idx->idbf |= IWDB_REALNUM_KEYS;
   }
   if (!(mode & EJDB_IDX_UNIQUE)) {
     idx->idbf |= IWDB_COMPOUND_KEYS;
@@ -1108,6 +2881,11 @@ iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mod
   rc = iwkv_new_db(db->iwkv, idx->idbf, &idx->dbid, &idx->idb);
   RCGO(rc, finish);
 
+  if (mode & EJDB_IDX_TTL) {
+    rc = _jb_ttl_start(db);
+    RCGO(rc, finish);
+  }
+
   rc = _jb_idx_fill(idx);
   RCGO(rc, finish);
 
@@ -1121,7 +2899,8 @@ iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mod
   if (!binn_object_set_str(imeta, "ptr", path) ||
       !binn_object_set_uint32(imeta, "mode", idx->mode) ||
       !binn_object_set_uint32(imeta, "idbf", idx->idbf) ||
-      !binn_object_set_uint32(imeta, "dbid", idx->dbid)) {
+      !binn_object_set_uint32(imeta, "dbid", idx->dbid) ||
+      (filter && !binn_object_set_str(imeta, "filter", filter))) {
     rc = JBL_ERROR_CREATION;
     goto finish;
   }
@@ -1163,10 +2942,12 @@ static iwrc _jb_patch(EJDB db, const char *coll, const char *patchjson, int64_t
   if (!patchjson) {
     return IW_ERROR_INVALID_ARGS;
   }
-  int rci;
+  int rci, mptrs_num;
+  bool applied;
   JBCOLL jbc;
   struct _JBL sjbl;
   JBL_NODE root, patch;
+  JBL_PTR *mptrs;
   JBL ujbl = 0;
   IWPOOL *pool = 0;
   IWKV_val val = {0};
@@ -1186,13 +2967,15 @@ static iwrc _jb_patch(EJDB db, const char *coll, const char *patchjson, int64_t
       rc = EJDB_ERROR_PATCH_JSON_NOT_OBJECT;
       goto finish;
     }
-    rc = _jb_put_impl(jbc, ujbl, id);
+    rc = _jb_put_impl(jbc, ujbl, id, 0, 0);
     if (!rc && jbc->id_seq < id) {
       jbc->id_seq = id;
     }
     goto finish;
   } else RCGO(rc, finish);
 
+  rc = jb_doc_val_decode(jbc, &val);
+  RCGO(rc, finish);
   rc = jbl_from_buf_keep_onstack(&sjbl, val.data, val.size);
   RCGO(rc, finish);
 
@@ -1202,10 +2985,22 @@ static iwrc _jb_patch(EJDB db, const char *coll, const char *patchjson, int64_t
     goto finish;
   }
 
-  rc = jbl_to_node(&sjbl, &root, pool);
+  rc = jbl_node_from_json(patchjson, &patch, pool);
   RCGO(rc, finish);
 
-  rc = jbl_node_from_json(patchjson, &patch, pool);
+  // Collected before patching, merge patch nodes are moved into the document tree
+  rc = jbl_patch_auto_ptrs(patch, &mptrs, &mptrs_num, pool);
+  RCGO(rc, finish);
+
+  // Fixed size values are patched right in the fetched document buffer
+  rc = jbl_patch_auto_inplace(&sjbl, patch, pool, &applied);
+  RCGO(rc, finish);
+  if (applied) {
+    rc = _jb_put_impl(jbc, &sjbl, id, mptrs, mptrs_num);
+    goto finish;
+  }
+
+  rc = jbl_to_node(&sjbl, &root, pool);
   RCGO(rc, finish);
 
   rc = jbl_patch_auto(root, patch, pool);
@@ -1224,13 +3019,14 @@ static iwrc _jb_patch(EJDB db, const char *coll, const char *patchjson, int64_t
   rc = jbl_fill_from_node(ujbl, root);
   RCGO(rc, finish);
 
-  rc = _jb_put_impl(jbc, ujbl, id);
+  rc = _jb_put_impl(jbc, ujbl, id, mptrs, mptrs_num);
 
 finish:
   API_COLL_UNLOCK(jbc, rci, rc);
   if (ujbl) jbl_destroy(&ujbl);
   if (pool) iwpool_destroy(pool);
   if (val.data) iwkv_val_dispose(&val);
+  _jb_changes_dispatch(db);
   return rc;
 }
 
@@ -1263,11 +3059,12 @@ iwrc ejdb_put(EJDB db, const char *coll, JBL jbl, int64_t id) {
   JBCOLL jbc;
   iwrc rc = _jb_coll_acquire_keeplock(db, coll, true, &jbc);
   RCRET(rc);
-  rc = _jb_put_impl(jbc, jbl, id);
+  rc = _jb_put_impl(jbc, jbl, id, 0, 0);
   if (!rc && jbc->id_seq < id) {
     jbc->id_seq = id;
   }
   API_COLL_UNLOCK(jbc, rci, rc);
+  _jb_changes_dispatch(db);
   return rc;
 }
 
@@ -1277,6 +3074,7 @@ iwrc ejdb_put_new(EJDB db, const char *coll, JBL jbl, int64_t *id) {
   }
   int rci;
   JBCOLL jbc;
+  void *buf = 0;
   if (id) *id = 0;
   iwrc rc = _jb_coll_acquire_keeplock(db, coll, true, &jbc);
   RCRET(rc);
@@ -1292,7 +3090,9 @@ iwrc ejdb_put_new(EJDB db, const char *coll, JBL jbl, int64_t *id) {
     .jbl = jbl
   };
 
-  rc = jbl_as_buf(jbl, &val.data, &val.size);
+  rc = _jb_idx_unique_check(jbc, jbl, oid);
+  RCGO(rc, finish);
+  rc = _jb_doc_as_buf(jbc, jbl, &val, &buf);
   RCGO(rc, finish);
 
   rc = _jb_put_handler_after(iwkv_puth(jbc->cdb, &key, &val, 0, _jb_put_handler, &pctx), &pctx);
@@ -1304,7 +3104,9 @@ iwrc ejdb_put_new(EJDB db, const char *coll, JBL jbl, int64_t *id) {
   }
 
 finish:
+  free(buf);
   API_COLL_UNLOCK(jbc, rci, rc);
+  _jb_changes_dispatch(db);
   return rc;
 }
 
@@ -1322,6 +3124,8 @@ iwrc ejdb_get(EJDB db, const char *coll, int64_t id, JBL *jblp) {
   RCRET(rc);
   rc = iwkv_get(jbc->cdb, &key, &val);
   RCGO(rc, finish);
+  rc = jb_doc_val_decode(jbc, &val);
+  RCGO(rc, finish);
   rc = jbl_from_buf_keep(&jbl, val.data, val.size, false);
   RCGO(rc, finish);
   *jblp = jbl;
@@ -1350,6 +3154,8 @@ iwrc ejdb_del(EJDB db, const char *coll, int64_t id) {
   rc = iwkv_get(jbc->cdb, &key, &val);
   RCGO(rc, finish);
 
+  rc = jb_doc_val_decode(jbc, &val);
+  RCGO(rc, finish);
   rc = jbl_from_buf_keep_onstack(&jbl, val.data, val.size);
   RCGO(rc, finish);
 
@@ -1358,14 +3164,15 @@ iwrc ejdb_del(EJDB db, const char *coll, int64_t id) {
   }
   rc = iwkv_del(jbc->cdb, &key, 0);
   RCGO(rc, finish);
-  _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
-  jbc->rnum -= 1;
+  _jb_coll_rnum_add(jbc, -1);
+  _jb_changes_add(jbc, EJDB_CHANGE_DEL, id, &jbl);
 
 finish:
   if (val.data) {
     iwkv_val_dispose(&val);
   }
   API_COLL_UNLOCK(jbc, rci, rc);
+  _jb_changes_dispatch(db);
   return rc;
 }
 
@@ -1377,8 +3184,8 @@ iwrc jb_del(JBCOLL jbc, JBL jbl, int64_t id) {
   }
   rc = iwkv_del(jbc->cdb, &key, 0);
   RCRET(rc);
-  _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
-  jbc->rnum -= 1;
+  _jb_coll_rnum_add(jbc, -1);
+  _jb_changes_add(jbc, EJDB_CHANGE_DEL, id, jbl);
   return rc;
 }
 
@@ -1389,8 +3196,8 @@ iwrc jb_cursor_del(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl) {
   }
   rc = iwkv_cursor_del(cur, 0);
   RCRET(rc);
-  _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
-  jbc->rnum -= 1;
+  _jb_coll_rnum_add(jbc, -1);
+  _jb_changes_add(jbc, EJDB_CHANGE_DEL, id, jbl);
   return rc;
 }
 
@@ -1418,6 +3225,8 @@ iwrc ejdb_remove_collection(EJDB db, const char *coll) {
   if (k != kh_end(db->mcolls)) {
 
     jbc = kh_value(db->mcolls, k);
+    rc = _jb_coll_ensure_loaded(jbc);
+    RCGO(rc, finish);
     key.data = keybuf;
     key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_COLLMETA "%u", jbc->dbid);
     rc = iwkv_del(jbc->db->metadb, &key, IWKV_SYNC);
@@ -1432,6 +3241,19 @@ iwrc ejdb_remove_collection(EJDB db, const char *coll) {
       RCGO(rc, finish);
       _jb_meta_nrecs_removedb(db, idx->dbid);
     }
+    for (uint32_t id = 1; id <= jbc->kdict.num; ++id) {
+      if (!jbc->kdict.keys[id - 1].key) continue;
+      key.data = keybuf;
+      key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_KDICT "%u" "." "%u", jbc->dbid, id);
+      rc = iwkv_del(jbc->db->metadb, &key, 0);
+      RCGO(rc, finish);
+    }
+    if (jbc->zdict) {
+      key.data = keybuf;
+      key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_ZDICT "%u", jbc->dbid);
+      rc = iwkv_del(jbc->db->metadb, &key, 0);
+      RCGO(rc, finish);
+    }
     for (JBIDX idx = jbc->idx, nidx; idx; idx = nidx) {
       IWRC(iwkv_db_destroy(&idx->idb), rc);
       idx->idb = 0;
@@ -1477,18 +3299,9 @@ iwrc ejdb_rename_collection(EJDB db, const char *coll, const char *new_coll) {
 
   JBCOLL jbc = kh_value(db->mcolls, k);
 
-  rc = jbl_create_empty_object(&nmeta);
+  rc = _jb_coll_meta_create(new_coll, jbc->dbid, jbc, &nmeta);
   RCGO(rc, finish);
 
-  if (!binn_object_set_str(&nmeta->bn, "name", new_coll)) {
-    rc = JBL_ERROR_CREATION;
-    goto finish;
-  }
-  if (!binn_object_set_uint32(&nmeta->bn, "id", jbc->dbid)) {
-    rc = JBL_ERROR_CREATION;
-    goto finish;
-  }
-
   rc = jbl_as_buf(nmeta, &val.data, &val.size);
   RCGO(rc, finish);
   key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_COLLMETA "%u", jbc->dbid);
@@ -1532,6 +3345,169 @@ finish:
   return rc;
 }
 
+/** Stores collection meta reflecting current collection options, caller must hold database write lock */
+static iwrc _jb_coll_meta_save_lw(JBCOLL jbc) {
+  JBL nmeta, jbv;
+  IWKV_val key, val;
+  EJDB db = jbc->db;
+  char keybuf[JBNUMBUF_SIZE + sizeof(KEY_PREFIX_COLLMETA)];
+  khiter_t k = kh_get(JBCOLLM, db->mcolls, jbc->name);
+  if (k == kh_end(db->mcolls)) {
+    return EJDB_ERROR_COLLECTION_NOT_FOUND;
+  }
+  iwrc rc = _jb_coll_meta_create(jbc->name, jbc->dbid, jbc, &nmeta);
+  RCRET(rc);
+  rc = jbl_as_buf(nmeta, &val.data, &val.size);
+  RCGO(rc, finish);
+  key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_COLLMETA "%u", jbc->dbid);
+  if (key.size >= sizeof(keybuf)) {
+    rc = IW_ERROR_OVERFLOW;
+    goto finish;
+  }
+  key.data = keybuf;
+  rc = jbl_at(nmeta, "/name", &jbv);
+  RCGO(rc, finish);
+  const char *name = jbl_get_str(jbv);
+  jbl_destroy(&jbv);
+
+  rc = iwkv_put(db->metadb, &key, &val, IWKV_SYNC);
+  RCGO(rc, finish);
+
+  // Collection name is kept by meta object
+  jbc->name = name;
+  kh_key(db->mcolls, k) = name;
+  jbl_destroy(&jbc->meta);
+  jbc->meta = nmeta;
+  nmeta = 0;
+
+finish:
+  if (nmeta) {
+    jbl_destroy(&nmeta);
+  }
+  return rc;
+}
+
+iwrc ejdb_set_keys_dict(EJDB db, const char *coll, bool enabled) {
+  if (!coll) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  int rci;
+  iwrc rc = ejdb_ensure_collection(db, coll);
+  RCRET(rc);
+  API_WLOCK(db, rci);
+  khiter_t k = kh_get(JBCOLLM, db->mcolls, coll);
+  if (k == kh_end(db->mcolls)) {
+    rc = EJDB_ERROR_COLLECTION_NOT_FOUND;
+    goto finish;
+  }
+  JBCOLL jbc = kh_value(db->mcolls, k);
+  if (jbc->kdict.enabled != enabled) {
+    jbc->kdict.enabled = enabled;
+    rc = _jb_coll_meta_save_lw(jbc);
+    if (rc) {
+      jbc->kdict.enabled = !enabled;
+    }
+  }
+
+finish:
+  API_UNLOCK(db, rci, rc);
+  return rc;
+}
+
+/** Builds compression dictionary from the parts of up to `JB_ZDICT_SAMPLE_DOCS` collection documents */
+static iwrc _jb_zdict_build_lw(JBCOLL jbc) {
+  IWKV_cursor cur;
+  size_t dsz = 0;
+  int docs = 0;
+  uint8_t *dict = malloc(JB_ZDICT_MAX_SIZE);
+  if (!dict) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  iwrc rc = iwkv_cursor_open(jbc->cdb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0);
+  RCGO(rc, finish);
+  while (dsz < JB_ZDICT_MAX_SIZE && docs < JB_ZDICT_SAMPLE_DOCS
+         && !(rc = iwkv_cursor_to(cur, IWKV_CURSOR_NEXT))) {
+    IWKV_val val;
+    rc = iwkv_cursor_val(cur, &val);
+    RCBREAK(rc);
+    // Dictionary is applied to documents encoded by keys dictionary but not compressed yet
+    while (!rc && val.size && (*(uint8_t *) val.data == JB_DOC_LZ || *(uint8_t *) val.data == JB_DOC_LZDICT)) {
+      void *buf = 0;
+      size_t bufsz = 0, sz;
+      rc = _jb_doc_decode(jbc, val.data, val.size, &buf, &bufsz, 0, &sz);
+      iwkv_val_dispose(&val);
+      val.data = buf;
+      val.size = sz;
+    }
+    if (!rc) {
+      size_t sz = MIN(MIN(val.size, JB_ZDICT_SAMPLE_MAX_SIZE), JB_ZDICT_MAX_SIZE - dsz);
+      memcpy(dict + dsz, val.data, sz);
+      dsz += sz;
+      ++docs;
+    }
+    iwkv_val_dispose(&val);
+  }
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  RCGO(rc, finish);
+  if (dsz) {
+    char keybuf[JBNUMBUF_SIZE + sizeof(KEY_PREFIX_ZDICT)];
+    IWKV_val key, val = {
+      .data = dict,
+      .size = dsz
+    };
+    key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_ZDICT "%u", jbc->dbid);
+    if (key.size >= sizeof(keybuf)) {
+      rc = IW_ERROR_OVERFLOW;
+      goto finish;
+    }
+    key.data = keybuf;
+    rc = iwkv_put(jbc->db->metadb, &key, &val, IWKV_SYNC);
+    RCGO(rc, finish);
+    jbc->zdict = dict;
+    jbc->zdictsz = (uint32_t) dsz;
+    dict = 0;
+  }
+
+finish:
+  iwkv_cursor_close(&cur);
+  free(dict);
+  return rc;
+}
+
+iwrc ejdb_set_compression(EJDB db, const char *coll, uint32_t threshold, bool build_dict) {
+  if (!coll) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  int rci;
+  iwrc rc = ejdb_ensure_collection(db, coll);
+  RCRET(rc);
+  API_WLOCK(db, rci);
+  khiter_t k = kh_get(JBCOLLM, db->mcolls, coll);
+  if (k == kh_end(db->mcolls)) {
+    rc = EJDB_ERROR_COLLECTION_NOT_FOUND;
+    goto finish;
+  }
+  JBCOLL jbc = kh_value(db->mcolls, k);
+  if (build_dict && !jbc->zdict) {
+    rc = _jb_zdict_build_lw(jbc);
+    RCGO(rc, finish);
+  }
+  if (jbc->zthreshold != threshold) {
+    uint32_t old = jbc->zthreshold;
+    jbc->zthreshold = threshold;
+    rc = _jb_coll_meta_save_lw(jbc);
+    if (rc) {
+      jbc->zthreshold = old;
+    }
+  }
+
+finish:
+  API_UNLOCK(db, rci, rc);
+  return rc;
+}
+
 iwrc ejdb_get_meta(EJDB db, JBL *jblp) {
   int rci;
   *jblp = 0;
@@ -1557,12 +3533,17 @@ iwrc ejdb_get_meta(EJDB db, JBL *jblp) {
     rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
     goto finish;
   }
+  pthread_rwlock_rdlock(&db->crwl);
   for (khiter_t k = kh_begin(db->mcolls); k != kh_end(db->mcolls); ++k) {
     if (!kh_exist(db->mcolls, k)) continue;
     JBCOLL jbc = kh_val(db->mcolls, k);
+    rc = _jb_coll_ensure_loaded(jbc);
+    RCBREAK(rc);
     rc = _jb_coll_add_meta_lr(jbc, clist);
-    RCGO(rc, finish);
+    RCBREAK(rc);
   }
+  pthread_rwlock_unlock(&db->crwl);
+  RCGO(rc, finish);
   if (!binn_object_set_list(&jbl->bn, "collections", clist)) {
     rc = JBL_ERROR_CREATION;
     goto finish;
@@ -1586,6 +3567,85 @@ iwrc ejdb_online_backup(EJDB db, uint64_t *ts, const char *target_file) {
   return iwkv_online_backup(db->iwkv, ts, target_file);
 }
 
+iwrc ejdb_snapshot(EJDB db, uint64_t *ts, const char *target_file) {
+  if (!target_file) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  ENSURE_OPEN(db);
+  return _jb_snapshot(db, ts, target_file);
+}
+
+iwrc ejdb_changes_subscribe(EJDB db, EJDB_CHANGE_LISTENER listener, void *op) {
+  if (!listener) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  ENSURE_OPEN(db);
+  iwrc rc = 0;
+  struct _JBCHGS *chgs = &db->chgs;
+  struct _JBCHGL *l = malloc(sizeof(*l));
+  if (!l) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  l->listener = listener;
+  l->op = op;
+  int rci = pthread_rwlock_wrlock(&chgs->rwl);
+  if (rci) {
+    free(l);
+    return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+  }
+  pthread_mutex_lock(&chgs->mtx);
+  if (!chgs->ring) { // Ring is kept until database is closed
+    chgs->ring = calloc(db->opts.changes_buffer_sz, sizeof(*chgs->ring));
+    if (!chgs->ring) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      free(l);
+      goto finish;
+    }
+    chgs->cap = db->opts.changes_buffer_sz;
+  }
+  l->next = chgs->listeners;
+  chgs->listeners = l;
+  __atomic_store_n(&chgs->active, true, __ATOMIC_RELEASE);
+
+finish:
+  pthread_mutex_unlock(&chgs->mtx);
+  pthread_rwlock_unlock(&chgs->rwl);
+  return rc;
+}
+
+iwrc ejdb_changes_unsubscribe(EJDB db, EJDB_CHANGE_LISTENER listener, void *op) {
+  if (!listener) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  ENSURE_OPEN(db);
+  iwrc rc = IW_ERROR_NOT_EXISTS;
+  struct _JBCHGS *chgs = &db->chgs;
+  int rci = pthread_rwlock_wrlock(&chgs->rwl);
+  if (rci) {
+    return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
+  }
+  for (struct _JBCHGL *l = chgs->listeners, *prev = 0; l; prev = l, l = l->next) {
+    if (l->listener == listener && l->op == op) {
+      if (prev) {
+        prev->next = l->next;
+      } else {
+        chgs->listeners = l->next;
+      }
+      free(l);
+      rc = 0;
+      break;
+    }
+  }
+  if (!chgs->listeners) {
+    pthread_mutex_lock(&chgs->mtx);
+    __atomic_store_n(&chgs->active, false, __ATOMIC_RELEASE);
+    _jb_changes_clear(chgs);
+    pthread_mutex_unlock(&chgs->mtx);
+  }
+  pthread_rwlock_unlock(&chgs->rwl);
+  return rc;
+}
+
 iwrc ejdb_get_iwkv(EJDB db, IWKV *kvp) {
   if (!db || !kvp) {
     return IW_ERROR_INVALID_ARGS;
@@ -1621,6 +3681,18 @@ iwrc ejdb_open(const EJDB_OPTS *_opts, EJDB *ejdbp) {
   if (db->opts.document_buffer_sz < 16 * 1024) { // Min 16Kb
     db->opts.document_buffer_sz = 16 * 1024;
   }
+  if (!db->opts.changes_buffer_sz) {
+    db->opts.changes_buffer_sz = 1024;
+  }
+  if (!db->opts.ttl_interval_ms) {
+    db->opts.ttl_interval_ms = 1000;
+  }
+  if (!db->opts.snapshot_interval_ms) {
+    db->opts.snapshot_interval_ms = 60 * 1000;
+  }
+  if (db->opts.snapshot_path) {
+    db->opts.snapshot_path = strdup(db->opts.snapshot_path);
+  }
   EJDB_HTTP *http = &db->opts.http;
   if (http->bind) http->bind = strdup(http->bind);
   if (http->access_token) {
@@ -1639,6 +3711,16 @@ iwrc ejdb_open(const EJDB_OPTS *_opts, EJDB *ejdbp) {
     free(db);
     return rc;
   }
+  pthread_rwlock_init(&db->crwl, 0);
+  pthread_mutex_init(&db->cmtx, 0);
+  pthread_mutex_init(&db->nrecs_mtx, 0);
+  pthread_mutex_init(&db->chgs.mtx, 0);
+  pthread_rwlock_init(&db->chgs.rwl, 0);
+  pthread_mutex_init(&db->ttl.mtx, 0);
+  pthread_cond_init(&db->ttl.cond, 0);
+  pthread_mutex_init(&db->snap.mtx, 0);
+  pthread_mutex_init(&db->snap.wmtx, 0);
+  pthread_cond_init(&db->snap.cond, 0);
   db->mcolls = kh_init(JBCOLLM);
   if (!db->mcolls) {
     rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
@@ -1657,6 +3739,12 @@ iwrc ejdb_open(const EJDB_OPTS *_opts, EJDB *ejdbp) {
   db->oflags = kvopts.oflags;
   rc = _jb_db_meta_load(db);
   RCGO(rc, finish);
+  rc = _jb_db_nrecs_open(db);
+  RCGO(rc, finish);
+  rc = _jb_ttl_load(db);
+  RCGO(rc, finish);
+  rc = _jb_snapshot_start(db);
+  RCGO(rc, finish);
 
   if (db->opts.http.enabled) {
     // Maximum WS/HTTP API body size. Default: 64Mb, Min: 512K
@@ -1676,6 +3764,8 @@ iwrc ejdb_open(const EJDB_OPTS *_opts, EJDB *ejdbp) {
 
 finish:
   if (rc) {
+    _jb_ttl_shutdown(db);
+    _jb_snapshot_shutdown(db);
     _jb_db_release(&db);
   } else {
     db->open = true;
@@ -1693,12 +3783,21 @@ iwrc ejdb_close(EJDB *ejdbp) {
   if (!ejdbp || !*ejdbp) {
     return IW_ERROR_INVALID_ARGS;
   }
+  iwrc rc = 0;
   EJDB db = *ejdbp;
+  _jb_ttl_shutdown(db); // Expiry thread uses database API
+  _jb_snapshot_shutdown(db);
+#ifdef JB_HTTP
+  if (db->jbr) {
+    // HTTP server unsubscribes its changes listener so database must be still open
+    IWRC(jbr_shutdown(&db->jbr), rc);
+  }
+#endif
   if (!__sync_bool_compare_and_swap(&db->open, 1, 0)) {
     iwlog_error2("Database is closed already");
     return IW_ERROR_INVALID_STATE;
   }
-  iwrc rc = _jb_db_release(ejdbp);
+  IWRC(_jb_db_release(ejdbp), rc);
   return rc;
 }
 
@@ -1745,6 +3844,14 @@ static const char *_ejdb_ecodefn(locale_t locale, uint32_t ecode) {
       return "Target collection exists (EJDB_ERROR_TARGET_COLLECTION_EXISTS)";
     case EJDB_ERROR_PATCH_JSON_NOT_OBJECT:
       return "Patch JSON must be an object (map) (EJDB_ERROR_PATCH_JSON_NOT_OBJECT)";
+    case EJDB_ERROR_INVALID_DOCUMENT_ENCODING:
+      return "Invalid encoding of stored document (EJDB_ERROR_INVALID_DOCUMENT_ENCODING)";
+    case EJDB_ERROR_INVALID_RESUME_TOKEN:
+      return "Invalid query resume token (EJDB_ERROR_INVALID_RESUME_TOKEN)";
+    case EJDB_ERROR_INVALID_INDEX_FILTER:
+      return "Invalid index filter query (EJDB_ERROR_INVALID_INDEX_FILTER)";
+    case EJDB_ERROR_MISMATCHED_INDEX_FILTER:
+      return "Index exists but mismatched filter (EJDB_ERROR_MISMATCHED_INDEX_FILTER)";
   }
   return 0;
 }
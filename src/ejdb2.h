@@ -57,6 +57,10 @@ typedef enum {
   EJDB_ERROR_COLLECTION_NOT_FOUND,                /**< Collection not found */
   EJDB_ERROR_TARGET_COLLECTION_EXISTS,            /**< Target collection exists */
   EJDB_ERROR_PATCH_JSON_NOT_OBJECT,               /**< Patch JSON must be an object (map) */
+  EJDB_ERROR_INVALID_DOCUMENT_ENCODING,           /**< Invalid encoding of stored document */
+  EJDB_ERROR_INVALID_RESUME_TOKEN,                /**< Invalid query resume token */
+  EJDB_ERROR_INVALID_INDEX_FILTER,                /**< Invalid index filter query */
+  EJDB_ERROR_MISMATCHED_INDEX_FILTER,             /**< Index exists but mismatched filter */
   _EJDB_ERROR_END
 } ejdb_ecode_t;
 
@@ -75,11 +79,30 @@ typedef uint8_t ejdb_idx_mode_t;
 #define EJDB_IDX_I64        ((ejdb_idx_mode_t) 0x08U)
 
 /** Index value have floating point type.
- *  @note Internally floating point numbers are converted to string
+ *  @note Index keys are stored in order preserving 8 bytes binary form
+ *        without loss of precision. Indexes created by previous versions
+ *        keep floating point numbers converted to string
  *        with precision of 6 digits after decimal point.
  */
 #define EJDB_IDX_F64        ((ejdb_idx_mode_t) 0x10U)
 
+/** Full text index of words contained in string values.
+ *  Used by `fts` query operator. Cannot be combined with `EJDB_IDX_UNIQUE`.
+ */
+#define EJDB_IDX_FTS        ((ejdb_idx_mode_t) 0x20U)
+
+/** Case insensitive string index, can be used only along with `EJDB_IDX_STR`.
+ *  Index keys are case folded and used by `ieq`, `iin`, `ire` query operators.
+ */
+#define EJDB_IDX_ICASE      ((ejdb_idx_mode_t) 0x40U)
+
+/** Time-to-live index, can be used only along with `EJDB_IDX_I64`.
+ *  Indexed values are expiration times in milliseconds since epoch,
+ *  expired documents are removed by database background thread.
+ *  @see EJDB_OPTS.ttl_interval_ms
+ */
+#define EJDB_IDX_TTL        ((ejdb_idx_mode_t) 0x80U)
+
 /**
  * @brief Database handler.
  */
@@ -112,6 +135,21 @@ typedef struct _EJDB_OPTS {
                                      Default 16Mb, min: 1Mb */
   uint32_t document_buffer_sz;  /**< Initial size of buffer in bytes used to process/store document during query execution.
                                      Default 64Kb, min: 16Kb */
+  uint32_t keys_dir_threshold;  /**< Objects having at least this number of fields are stored
+                                     along with sorted keys directory allowing fast fields lookup in wide documents.
+                                     Documents stored this way cannot be read by previous versions of ejdb.
+                                     Default: 0 (disabled) */
+  uint32_t changes_buffer_sz;   /**< Max number of document change events buffered until delivered to listeners.
+                                     The oldest events are dropped on overflow. @see ejdb_changes_subscribe()
+                                     Default: 1024 */
+  uint32_t ttl_interval_ms;     /**< Interval in milliseconds between checks of documents expired by `EJDB_IDX_TTL` indexes.
+                                     Default: 1000 */
+  const char *snapshot_path;    /**< If set, database snapshot is written to this file by background thread
+                                     every `snapshot_interval_ms`. Snapshot file can be opened with `IWKV_RDONLY`
+                                     by other processes while this database is written. @see ejdb_snapshot()
+                                     Default: 0 (disabled) */
+  uint32_t snapshot_interval_ms; /**< Interval in milliseconds between database snapshots.
+                                     Default: 60000 */
 } EJDB_OPTS;
 
 /**
@@ -176,6 +214,14 @@ typedef struct _EJDB_EXEC {
   int64_t cnt;                /**< Number of result documents processed by `visitor` */
   IWXSTR *log;                /**< Optional query execution log buffer. If set major query execution/index selection steps will be logged into */
   IWPOOL *pool;               /**< Optional pool which can be used in query apply  */
+  const char *after;          /**< Optional resume token returned in `next` by the previous execution of the same query.
+                                   Query execution will be resumed right after the last visited document
+                                   by positioning of scan cursor, so it's a cheap replacement for `skip`
+                                   in pagination over large result sets.
+                                   Takes precedence over `after` encoded in query. */
+  IWXSTR *next;               /**< Optional buffer to receive resume token of the last document visited by `visitor`.
+                                   Buffer is left empty if nothing visited or query
+                                   cannot be resumed: result set sorted not by index or `in` index scan used. */
 } EJDB_EXEC;
 
 /**
@@ -439,6 +485,52 @@ IW_EXPORT iwrc ejdb_rename_collection(EJDB db, const char *coll, const char *new
  */
 IW_EXPORT iwrc ejdb_ensure_collection(EJDB db, const char *coll);
 
+/**
+ * @brief Enable or disable object keys dictionary for collection `coll`.
+ *
+ * When enabled object keys of stored documents are replaced by compact numeric ids
+ * of per-collection keys dictionary. It considerably reduces size of stored
+ * documents sharing the same set of keys. Documents are transparently decoded on read.
+ * Already stored documents are kept untouched, only documents put after this call are affected.
+ * Collection will be created if it has not existed before.
+ *
+ * @note Documents stored with keys dictionary cannot be read by previous versions of ejdb.
+ *
+ * @param db      Database handle. Not zero.
+ * @param coll    Collection name. Not zero.
+ * @param enabled Enable keys dictionary.
+ *
+ * @return `0` on success.
+ *          Any non zero error codes.
+ */
+IW_EXPORT iwrc ejdb_set_keys_dict(EJDB db, const char *coll, bool enabled);
+
+/**
+ * @brief Set compression options of collection `coll`.
+ *
+ * Stored documents having size of at least `threshold` bytes are compressed
+ * in LZ4 block format and transparently decompressed on read.
+ * Documents are kept uncompressed if compression does not reduce their size.
+ * Already stored documents are kept untouched, only documents put after this call are affected.
+ * Collection will be created if it has not existed before.
+ *
+ * If `build_dict` is set compression dictionary is built from a sample of documents
+ * stored in collection. Dictionary improves compression ratio of small documents
+ * similar to the sampled ones. Dictionary is built only once and kept
+ * for the whole lifetime of collection.
+ *
+ * @note Compressed documents cannot be read by previous versions of ejdb.
+ *
+ * @param db          Database handle. Not zero.
+ * @param coll        Collection name. Not zero.
+ * @param threshold   Min size of compressed documents in bytes. Zero disables compression.
+ * @param build_dict  Build compression dictionary if collection has no dictionary.
+ *
+ * @return `0` on success.
+ *          Any non zero error codes.
+ */
+IW_EXPORT iwrc ejdb_set_compression(EJDB db, const char *coll, uint32_t threshold, bool build_dict);
+
 /**
  * @brief Create index with specified parameters if it has not existed before.
  *
@@ -475,6 +567,38 @@ IW_EXPORT iwrc ejdb_ensure_collection(EJDB db, const char *coll);
  */
 IW_EXPORT iwrc ejdb_ensure_index(EJDB db, const char *coll, const char *path, ejdb_idx_mode_t mode);
 
+/**
+ * @brief Create partial index with specified parameters if it has not existed before.
+ *
+ * Only documents matched by `filter` query are stored in partial index.
+ * Index is used by query only if query filter implies index `filter`,
+ * that is every top level `and` filter of index `filter` is present in query filter as is.
+ * Filter must not contain placeholders, apply, projection and query options.
+ *
+ * Create index over amounts of active orders only:
+ *
+ * @code {.c}
+ * iwrc rc = ejdb_ensure_index2(db, "orders", "/amount", EJDB_IDX_I64, "/[status = active]");
+ * @endcode
+ *
+ * Query `/[status = active] and /[amount > 100]` can be served by this index.
+ *
+ * @param db      Database handle. Not zero.
+ * @param coll    Collection name. Not zero.
+ * @param path    rfc6901 JSON pointer to indexed field.
+ * @param mode    Index mode.
+ * @param filter  Optional JQL filter of indexed documents. If zero all documents are indexed.
+ *
+ * @return `0` on success.
+ *         `EJDB_ERROR_INVALID_INDEX_MODE` Invalid `mode` specified
+ *         `EJDB_ERROR_INVALID_INDEX_FILTER` Invalid `filter` specified
+ *         `EJDB_ERROR_MISMATCHED_INDEX_UNIQUENESS_MODE` trying to create non unique index over existing unique or vice versa.
+ *         `EJDB_ERROR_MISMATCHED_INDEX_FILTER` index exists with other filter.
+ *          Any non zero error codes.
+ */
+IW_EXPORT iwrc ejdb_ensure_index2(EJDB db, const char *coll, const char *path, ejdb_idx_mode_t mode,
+                                  const char *filter);
+
 /**
  * @brief Remove index if it has existed before.
  *
@@ -544,6 +668,79 @@ IW_EXPORT iwrc ejdb_get_meta(EJDB db, JBL *jblp);
  */
 IW_EXPORT iwrc ejdb_online_backup(EJDB db, uint64_t *ts, const char *target_file);
 
+/**
+ * @brief Writes consistent snapshot of database to `target_file`.
+ *
+ * Snapshot is created by online backup into `<target_file>.tmp`
+ * which is then atomically renamed to `target_file`. Processes reading
+ * previous snapshot are not affected, they see the new one when reopened.
+ * Snapshot can be opened by any number of processes with `IWKV_RDONLY` flag,
+ * so readers scan data locally without access to database being written.
+ *
+ * @note In order to avoid deadlocks: close all opened database cursors
+ * before calling this method or do call in separate thread.
+ *
+ * @param Database handle. Not zero.
+ * @param [out] ts Snapshot completion timestamp, optional
+ * @param target_file Snapshot file path
+ */
+IW_EXPORT iwrc ejdb_snapshot(EJDB db, uint64_t *ts, const char *target_file);
+
+/** Type of document change. @see ejdb_changes_subscribe() */
+typedef enum {
+  EJDB_CHANGE_PUT = 1,  /**< Document inserted or updated */
+  EJDB_CHANGE_DEL,      /**< Document removed */
+} ejdb_change_t;
+
+/**
+ * @brief Document change event.
+ * @see ejdb_changes_subscribe()
+ */
+typedef struct _EJDB_CHANGE {
+  uint64_t seq;         /**< Change sequence number, starts from 1.
+                             Gaps in sequence mean events dropped because of changes buffer overflow */
+  ejdb_change_t op;     /**< Change type */
+  const char *coll;     /**< Collection name */
+  int64_t id;           /**< Document id */
+  JBL doc;              /**< Stored document for `EJDB_CHANGE_PUT` or removed document for `EJDB_CHANGE_DEL`.
+                             Valid only during listener call */
+} *EJDB_CHANGE;
+
+/**
+ * @brief Document changes listener.
+ *
+ * @param db  Database handle.
+ * @param chg Change event.
+ * @param op  Listener opaque data given to `ejdb_changes_subscribe()`
+ */
+typedef void (*EJDB_CHANGE_LISTENER)(EJDB db, EJDB_CHANGE chg, void *op);
+
+/**
+ * @brief Registers listener of document changes made by
+ *        `put`, `patch`, `del` operations and queries with `apply` or `del`.
+ *
+ * Changes are buffered in bounded ring (see `EJDB_OPTS.changes_buffer_sz`)
+ * and delivered in order of sequence numbers by writer thread right
+ * after the database locks are released, so a listener can call database API.
+ * Only one thread delivers changes at a time.
+ *
+ * @note Listener must not call `ejdb_changes_subscribe()` or `ejdb_changes_unsubscribe()`.
+ *
+ * @param db        Database handle. Not zero.
+ * @param listener  Changes listener. Not zero.
+ * @param op        Listener opaque data.
+ */
+IW_EXPORT iwrc ejdb_changes_subscribe(EJDB db, EJDB_CHANGE_LISTENER listener, void *op);
+
+/**
+ * @brief Removes changes listener registered by `ejdb_changes_subscribe()`.
+ *
+ * @param db        Database handle. Not zero.
+ * @param listener  Changes listener. Not zero.
+ * @param op        Listener opaque data.
+ */
+IW_EXPORT iwrc ejdb_changes_unsubscribe(EJDB db, EJDB_CHANGE_LISTENER listener, void *op);
+
 /**
  * @brief Get access to underlying IWKV storage.
  *        Use it with caution.
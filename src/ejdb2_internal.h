@@ -44,14 +44,28 @@
 #include <assert.h>
 #include <setjmp.h>
 #include "khash.h"
+#include "ftstok.h"
+#include "lzb.h"
 #include "ejdb2cfg.h"
 
 static_assert(JBNUMBUF_SIZE >= IWFTOA_BUFSIZE, "JBNUMBUF_SIZE >= IWFTOA_BUFSIZE");
 
 #define METADB_ID 1
 #define NUMRECSDB_ID 2  // DB for number of records per index/collection
+#define NUMRECS_DIRTY_ID 0 // NUMRECSDB key set while database is open: stored counters may be behind
 #define KEY_PREFIX_COLLMETA   "c." // Full key format: c.<coldbid>
 #define KEY_PREFIX_IDXMETA    "i." // Full key format: i.<coldbid>.<idxdbid>
+#define KEY_PREFIX_KDICT      "k." // Full key format: k.<coldbid>.<keyid>
+#define KEY_PREFIX_ZDICT      "z." // Full key format: z.<coldbid>
+
+// Stored document encodings, plain binn documents are started with container type byte (0xE0-0xE3)
+#define JB_DOC_KDICT  0x01U // Binn document with object keys replaced by collection keys dictionary ids
+#define JB_DOC_LZ     0x02U // Compressed document: varint size of data followed by LZ4 block
+#define JB_DOC_LZDICT 0x03U // Compressed document: the same as JB_DOC_LZ, collection dictionary is used
+#define JB_KDICT_MAX_KEYS 0xFFFFU
+#define JB_ZDICT_MAX_SIZE (32 * 1024)     // Max size of collection compression dictionary
+#define JB_ZDICT_SAMPLE_DOCS 64           // Max number of documents sampled to build compression dictionary
+#define JB_ZDICT_SAMPLE_MAX_SIZE 2048     // Max part of sample document included into compression dictionary
 
 #define ENSURE_OPEN(db_)                  \
   if (!(db_) || !((db_)->open)) {         \
@@ -87,6 +101,24 @@ static_assert(JBNUMBUF_SIZE >= IWFTOA_BUFSIZE, "JBNUMBUF_SIZE >= IWFTOA_BUFSIZE"
 struct _JBIDX;
 typedef struct _JBIDX *JBIDX;
 
+KHASH_MAP_INIT_STR(JBKDICTM, uint32_t)
+
+/** Object key registered in collection keys dictionary */
+struct _JBKDKEY {
+  const char *key;          /**< Zero terminated key */
+  int len;                  /**< Key length */
+};
+
+/** Collection keys dictionary */
+struct _JBKDICT {
+  bool enabled;             /**< New documents are stored with keys replaced by dictionary ids */
+  uint32_t num;             /**< Max registered key id */
+  uint32_t asz;             /**< Allocated size of keys array */
+  struct _JBKDKEY *keys;    /**< Keys array, key id is an index + 1 */
+  khash_t(JBKDICTM) *map;   /**< Key to id mapping */
+  IWPOOL *pool;             /**< Keys memory pool */
+};
+
 /** Database collection */
 typedef struct _JBCOLL {
   uint32_t dbid;            /**< IWKV collection database ID */
@@ -96,8 +128,15 @@ typedef struct _JBCOLL {
   JBL meta;                 /**< Collection meta object */
   JBIDX idx;                /**< First index in chain */
   int64_t rnum;             /**< Number of records stored in collection */
+  int64_t rnum_synced;      /**< Value of `rnum` persisted in NUMRECSDB */
+  uint32_t rnum_ops;        /**< Number of collection records changes since counters sync */
   pthread_rwlock_t rwl;
   int64_t id_seq;
+  struct _JBKDICT kdict;    /**< Object keys dictionary */
+  uint32_t zthreshold;      /**< Stored documents of at least this size are compressed, zero if disabled */
+  uint32_t zdictsz;         /**< Size of compression dictionary */
+  uint8_t *zdict;           /**< Compression dictionary built from collection documents, optional */
+  bool loaded;              /**< Collection database, indexes and dictionaries are loaded */
 } *JBCOLL;
 
 /** Database collection index */
@@ -106,14 +145,71 @@ struct _JBIDX {
   iwdb_flags_t idbf;        /**< Index database flags */
   JBCOLL jbc;               /**< Owner document collection */
   JBL_PTR ptr;              /**< Indexed JSON path poiner 0*/
+  char *filter;             /**< Filter query of partial index, documents not matched by filter are not indexed */
+  JQL fq;                   /**< Compiled `filter` query */
   IWDB idb;                 /**< KV database for this index */
   uint32_t dbid;            /**< IWKV collection database ID */
   int64_t rnum;             /**< Number of records stored in index */
+  int64_t rnum_synced;      /**< Value of `rnum` persisted in NUMRECSDB */
   struct _JBIDX *next;      /**< Next index in chain */
 };
 
 KHASH_MAP_INIT_STR(JBCOLLM, JBCOLL)
 
+/** Document change event buffered until delivered to listeners */
+struct _JBCHG {
+  uint64_t seq;               /**< Change sequence number */
+  ejdb_change_t op;           /**< Change type */
+  int64_t id;                 /**< Document id */
+  char *coll;                 /**< Collection name, allocated along with document data */
+  void *data;                 /**< Document binn data */
+  size_t size;                /**< Size of document data */
+};
+
+/** Registered changes listener */
+struct _JBCHGL {
+  EJDB_CHANGE_LISTENER listener;
+  void *op;
+  struct _JBCHGL *next;
+};
+
+/**
+ * @brief Document changes feed.
+ *
+ * Changes are recorded into the bounded ring under collection write lock
+ * and delivered to listeners after database locks are released.
+ */
+struct _JBCHGS {
+  pthread_mutex_t mtx;        /**< Guards ring of buffered changes */
+  pthread_rwlock_t rwl;       /**< Guards listeners list, read locked during delivery */
+  struct _JBCHGL *listeners;  /**< Registered listeners */
+  bool active;                /**< At least one listener registered, changed under `mtx`, read atomically */
+  bool dispatching;           /**< Buffered changes are being delivered by some thread */
+  struct _JBCHG *ring;        /**< Ring of buffered changes */
+  uint32_t cap;               /**< Ring capacity */
+  uint32_t head;              /**< Position of the oldest buffered change */
+  uint32_t num;               /**< Number of buffered changes */
+  uint64_t seq;               /**< Sequence number of the last recorded change */
+};
+
+/** Background removal of documents expired by TTL indexes */
+struct _JBTTL {
+  pthread_t thread;           /**< Expiry thread */
+  pthread_mutex_t mtx;        /**< Guards `started`, `stop` */
+  pthread_cond_t cond;        /**< Signalled on database close */
+  bool started;               /**< Expiry thread started */
+  volatile bool stop;         /**< Expiry thread must exit */
+};
+
+struct _JBSNAP {
+  pthread_t thread;           /**< Snapshot thread */
+  pthread_mutex_t mtx;        /**< Guards `started`, `stop` */
+  pthread_mutex_t wmtx;       /**< Serializes writing of snapshot files */
+  pthread_cond_t cond;        /**< Signalled on database close */
+  bool started;               /**< Snapshot thread started */
+  volatile bool stop;         /**< Snapshot thread must exit */
+};
+
 struct _EJDB {
   IWKV iwkv;
   IWDB metadb;
@@ -124,7 +220,16 @@ struct _EJDB {
   khash_t(JBCOLLM) *mcolls;
   iwkv_openflags oflags;
   pthread_rwlock_t rwl;       /**< Main RWL */
+  pthread_rwlock_t crwl;      /**< Guards `mcolls` while collection is created under main read lock */
+  pthread_mutex_t cmtx;       /**< Serializes creation of collections */
+  pthread_mutex_t nrecs_mtx;  /**< Serializes setting of NUMRECS_DIRTY_ID marker */
+  struct _JBCHGS chgs;        /**< Document changes feed */
+  struct _JBTTL ttl;          /**< TTL indexes expiry */
+  struct _JBSNAP snap;        /**< Periodic database snapshots */
   struct _EJDB_OPTS opts;
+  uint64_t nrecs_wgen;        /**< Collection write locks counter, read and changed atomically */
+  bool nrecs_dirty;           /**< NUMRECS_DIRTY_ID marker is stored by this instance, read atomically */
+  bool nrecs_recount;         /**< Database was not closed properly, records are recounted on collection load */
   volatile bool open;
 };
 
@@ -133,6 +238,8 @@ struct _JBPHCTX {
   JBCOLL jbc;
   JBL jbl;
   IWKV_val oldval;
+  JBL_PTR *mptrs;             /**< Document parts changed by update, all indexes are updated if zero */
+  int mptrs_num;              /**< Number of `mptrs` */
 };
 
 struct _JBEXEC;
@@ -156,6 +263,87 @@ struct _JBSSC {
   bool sof_active;
 };
 
+/**
+ * @brief Batched document fetch context.
+ *
+ * Ids found by index scan are collected into batches, sorted by id
+ * and fetched by sequential sweep over collection db.
+ */
+struct _JBBATCH {
+  JB_SCAN_CONSUMER consumer;  /**< Consumer of fetched documents */
+  int64_t *ids;               /**< Batch ids */
+  size_t num;                 /**< Number of ids in batch */
+};
+
+/**
+ * @brief Query resume position context.
+ *
+ * Resume token has the following form: `<scan>.<dir>.<id>[.<key>]`
+ * where `scan` is `c` for collection scan or index db id,
+ * `dir` is `n|p` cursor step direction, `id` is the last visited document id
+ * and `key` is hex encoded index key of the last visited document.
+ */
+struct _JBRSM {
+  bool track;           /**< Track position of documents visited by query */
+  bool visited;         /**< Document was visited by the last consumer call */
+  bool after;           /**< Scan is resumed after position given by `after_id`, `after_key` */
+  int64_t id;           /**< Id of the last visited document */
+  uint8_t *key;         /**< Index key of the last visited document */
+  size_t keysz;         /**< Size of index key */
+  size_t keyasz;        /**< Allocated size of `key` buffer */
+  IWKV_cursor_op step;  /**< Cursor step direction of resumed scan */
+  int64_t after_id;     /**< Id of document to resume after */
+  uint8_t *after_key;   /**< Index key of document to resume after */
+  size_t after_keysz;   /**< Size of `after_key` */
+};
+
+KHASH_SET_INIT_STR(JBGRPS)
+
+/** Aggregate function accumulator */
+struct _JBGACC {
+  int64_t cnt;                  /**< Number of accumulated values */
+  int64_t i64;                  /**< Sum of integer values */
+  double f64;                   /**< Sum of floating point values */
+  bool real;                    /**< Floating point values were summed */
+  JBL_NODE val;                 /**< Current min/max value or array of distinct values */
+  khash_t(JBGRPS) *distinct;    /**< Keys of distinct values */
+};
+
+/** Group of matched documents having the same values of group-by fields */
+struct _JBGROUP {
+  JBL_NODE *vals;               /**< Values of group-by fields */
+  struct _JBGACC *accs;         /**< Accumulators of aggregate functions */
+  struct _JBGROUP *next;        /**< Next group in order of creation */
+};
+
+KHASH_MAP_INIT_STR(JBGRPM, struct _JBGROUP *)
+
+/**
+ * @brief Group-by collector context.
+ *
+ * Matched documents are hashed into groups by values of group-by fields.
+ * If documents are scanned by index over the single group-by field
+ * groups are emitted one by one as soon as index key changes.
+ */
+struct _JBGRP {
+  bool ordered;                 /**< Documents are scanned in order of group-by field */
+  bool stop;                    /**< No more result documents needed */
+  jbl_type_t otype;             /**< Type of group-by field values ordered by index */
+  int anum;                     /**< Number of aggregate functions */
+  const char **names;           /**< Keys of group-by fields and aggregates in result documents */
+  IWXSTR *kstr;                 /**< Group key buffer */
+  IWXSTR *vstr;                 /**< Value key buffer */
+  IWPOOL *pool;                 /**< Memory pool of hashed groups */
+  khash_t(JBGRPM) *groups;      /**< Hashed groups */
+  struct _JBGROUP *first;       /**< First hashed group */
+  struct _JBGROUP *last;        /**< Last hashed group */
+  IWPOOL *opool;                /**< Memory pool of current ordered group */
+  struct _JBGROUP *ogroup;      /**< Current ordered group */
+  char *okey;                   /**< Key of current ordered group */
+  char *ikey;                   /**< Index key buffer used when groups are computed from index */
+  size_t ikeyasz;               /**< Allocated size of `ikey` */
+};
+
 struct _JBMIDX {
   JBIDX idx;                          /**< Index matched this filter */
   JQP_FILTER *filter;                 /**< Query filter */
@@ -175,11 +363,19 @@ typedef struct _JBEXEC {
   iwrc (*scanner)(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer);
   uint8_t *jblbuf;         /**< Buffer used to keep currently processed document */
   size_t jblbufsz;         /**< Size of jblbuf allocated memory */
+  uint8_t *jbldbuf;        /**< Buffer used to decode currently processed document */
+  size_t jbldbufsz;        /**< Size of jbldbuf allocated memory */
   bool sorting;            /**< Resultset sorting needed */
   IWKV_cursor_op cursor_init;         /**< Initial index cursor position (optional) */
   IWKV_cursor_op cursor_step;         /**< Next index cursor step */
   struct _JBMIDX midx;     /**< Index matching context */
   struct _JBSSC ssc;       /**< Result set sorting context */
+  struct _JBBATCH batch;   /**< Batched documents fetch context */
+  struct _JBRSM rsm;       /**< Query resume position context */
+  struct _JBGRP grp;       /**< Group-by collector context */
+  JBL_PTR *mptrs;          /**< Document parts changed by query `apply` (optional) */
+  int mptrs_num;           /**< Number of `mptrs` */
+  IWPOOL *mpool;           /**< Memory pool of `mptrs` */
 } JBEXEC;
 
 
@@ -188,25 +384,58 @@ typedef uint8_t jb_coll_acquire_t;
 #define JB_COLL_ACQUIRE_EXISTING  ((jb_coll_acquire_t) 0x02U)
 
 // Index selector empiric constants
-#define JB_IDX_EMPIRIC_MAX_INOP_ARRAY_SIZE 500
 #define JB_IDX_EMPIRIC_MIN_INOP_ARRAY_SIZE 10
 #define JB_IDX_EMPIRIC_MAX_INOP_ARRAY_RATIO 200
 
+// Batched documents fetch constants
+#define JB_BATCH_SIZE 1024
+#define JB_BATCH_MAX_GAP 8 /**< Max number of cursor steps to the next batch id before direct seek */
+
+// Max number of expired documents removed by TTL index under single collection lock
+#define JB_TTL_BATCH_SIZE 128
+
+// Number of collection records changes after which in-memory record counters are persisted
+#define JB_NRECS_SYNC_OPS 1024
+
+/** Encodes double as 8 bytes big-endian key, byte order of keys matches order of numbers */
+void jbi_f64_to_ikey(double v, char buf[static sizeof(double)]);
+double jbi_ikey_to_f64(const char buf[static sizeof(double)]);
+
 void jbi_jbl_fill_ikey(JBIDX idx, JBL jbv, IWKV_val *ikey, char numbuf[static JBNUMBUF_SIZE]);
 void jbi_jqval_fill_ikey(JBIDX idx, const JQVAL *jqval, IWKV_val *ikey, char numbuf[static JBNUMBUF_SIZE]);
 void jbi_node_fill_ikey(JBIDX idx, JBL_NODE node, IWKV_val *ikey, char numbuf[static JBNUMBUF_SIZE]);
 
 iwrc jbi_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err);
 iwrc jbi_sorter_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err);
+iwrc jbi_batch_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err);
+iwrc jbi_group_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err);
+/** Computes groups of query matching all documents directly from keys of index `idx` */
+iwrc jbi_group_index_scan(struct _JBEXEC *ctx, JBIDX idx);
+iwrc jbi_count_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err);
 iwrc jbi_full_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer);
 iwrc jbi_selection(JBEXEC *ctx);
+/** Returns true if matched documents can be counted by scan without reading of documents */
+bool jbi_count_covered(JBEXEC *ctx);
+/** Returns index which keys are enough to compute groups of query without reading of documents */
+JBIDX jbi_group_index_covered(JBEXEC *ctx);
 iwrc jbi_uniq_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer);
 iwrc jbi_dup_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer);
+iwrc jbi_rsm_mark(struct _JBEXEC *ctx, IWKV_cursor cur, const IWKV_val *key, int64_t id);
+iwrc jbi_rsm_cursor_open(struct _JBEXEC *ctx, IWDB db, IWKV_cursor_op step, bool advance,
+                         IWKV_cursor *curp, bool *eof);
 bool jbi_node_expr_matched(JQP_AUX *aux, JBIDX idx, IWKV_cursor cur, JQP_EXPR *expr, iwrc *rcp);
 
-iwrc jb_put(JBCOLL jbc, JBL jbl, int64_t id);
+/** Returns true if stored document is not a plain binn, plain binn documents are started with container type */
+IW_INLINE bool jb_doc_is_encoded(const void *data, size_t size) {
+  return size > 0 && *(const uint8_t *) data < BINN_LIST;
+}
+
+iwrc jb_doc_val_decode(JBCOLL jbc, IWKV_val *val);
+iwrc jb_exec_doc_decode(struct _JBEXEC *ctx, size_t off, size_t *vszp);
+
+iwrc jb_put(JBCOLL jbc, JBL jbl, int64_t id, JBL_PTR *mptrs, int mptrs_num);
 iwrc jb_del(JBCOLL jbc, JBL jbl, int64_t id);
-iwrc jb_cursor_set(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl);
+iwrc jb_cursor_set(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl, JBL_PTR *mptrs, int mptrs_num);
 iwrc jb_cursor_del(JBCOLL jbc, IWKV_cursor cur, int64_t id, JBL jbl);
 
 #endif
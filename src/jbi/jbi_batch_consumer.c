@@ -0,0 +1,124 @@
+#include "ejdb2_internal.h"
+
+static int _jbi_batch_cmp_desc(const void *v1, const void *v2) {
+  int64_t i1 = *(const int64_t *) v1, i2 = *(const int64_t *) v2;
+  return i1 < i2 ? 1 : i1 > i2 ? -1 : 0;
+}
+
+/**
+ * Moves collection cursor forward to the document identified by `id`.
+ * Collection db is traversed by `IWKV_CURSOR_NEXT` in descending order of ids,
+ * so nearby documents are reached by a few cursor steps instead of key lookup.
+ */
+static iwrc _jbi_batch_cursor_to(IWKV_cursor cur, int64_t id, bool *positioned, bool *found) {
+  iwrc rc;
+  size_t sz;
+  int64_t cid;
+  IWKV_val key = {
+    .data = &id,
+    .size = sizeof(id)
+  };
+  *found = false;
+  for (int i = 0; *positioned && i < JB_BATCH_MAX_GAP; ++i) {
+    rc = iwkv_cursor_copy_key(cur, &cid, sizeof(cid), &sz, 0);
+    RCRET(rc);
+    if (sz != sizeof(cid)) {
+      rc = IWKV_ERROR_CORRUPTED;
+      iwlog_ecode_error3(rc);
+      return rc;
+    }
+    if (cid == id) {
+      *found = true;
+      return 0;
+    } else if (cid < id) {
+      break;
+    }
+    rc = iwkv_cursor_to(cur, IWKV_CURSOR_NEXT);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      *positioned = false;
+    } else RCRET(rc);
+  }
+  rc = iwkv_cursor_to_key(cur, IWKV_CURSOR_EQ, &key);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    *positioned = false;
+    return 0;
+  }
+  RCRET(rc);
+  *positioned = true;
+  *found = true;
+  return 0;
+}
+
+/**
+ * Passes batched documents to the consumer in order of ids.
+ * `matched` is set if any of documents matched query.
+ */
+static iwrc _jbi_batch_flush(struct _JBEXEC *ctx, int64_t *step, bool *matched) {
+  iwrc rc;
+  bool positioned = false;
+  IWKV_cursor cur;
+  struct _JBBATCH *batch = &ctx->batch;
+  int64_t *ids = batch->ids;
+  size_t num = batch->num;
+
+  batch->num = 0;
+  if (!num) {
+    return 0;
+  }
+  qsort(ids, num, sizeof(ids[0]), _jbi_batch_cmp_desc);
+
+  rc = iwkv_cursor_open(ctx->jbc->cdb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0);
+  RCRET(rc);
+  for (size_t i = 0; i < num && *step; ++i) {
+    bool found, dmatched = false;
+    int64_t cstep = 1;
+    rc = _jbi_batch_cursor_to(cur, ids[i], &positioned, &found);
+    RCGO(rc, finish);
+    if (!found) {
+      continue;
+    }
+    rc = batch->consumer(ctx, cur, ids[i], &cstep, &dmatched, 0);
+    RCGO(rc, finish);
+    if (dmatched) {
+      *matched = true;
+    }
+    if (!cstep) {
+      *step = 0;
+    }
+  }
+
+finish:
+  iwkv_cursor_close(&cur);
+  return rc;
+}
+
+iwrc jbi_batch_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err) {
+  iwrc rc = 0;
+  struct _JBBATCH *batch = &ctx->batch;
+  if (!id) { // EOF scan
+    if (!err) {
+      int64_t fstep = 1;
+      bool fmatched = false;
+      err = _jbi_batch_flush(ctx, &fstep, &fmatched);
+    }
+    free(batch->ids);
+    batch->ids = 0;
+    batch->num = 0;
+    return batch->consumer(ctx, 0, 0, 0, 0, err);
+  }
+  if (!batch->ids) {
+    batch->ids = malloc(JB_BATCH_SIZE * sizeof(batch->ids[0]));
+    if (!batch->ids) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  *step = 1;
+  // Documents are matched on batch flush, scanner is notified
+  // if any document of flushed batch is matched
+  *matched = false;
+  batch->ids[batch->num++] = id;
+  if (batch->num >= JB_BATCH_SIZE) {
+    rc = _jbi_batch_flush(ctx, step, matched);
+  }
+  return rc;
+}
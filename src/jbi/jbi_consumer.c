@@ -38,6 +38,8 @@ start: {
     }
   }
 
+  rc = jb_exec_doc_decode(ctx, 0, &vsz);
+  RCGO(rc, finish);
   rc = jbl_from_buf_keep_onstack(&jbl, ctx->jblbuf, vsz);
   RCGO(rc, finish);
 
@@ -60,6 +62,7 @@ start: {
     };
     if (aux->apply || aux->apply_placeholder || aux->projection) {
       JBL_NODE root;
+      bool applied = false;
       if (!pool) {
         pool = iwpool_create(jbl.bn.size * 2);
         if (!pool) {
@@ -67,32 +70,46 @@ start: {
           goto finish;
         }
       }
-      rc = jbl_to_node(&jbl, &root, pool);
-      RCGO(rc, finish);
-      doc.node = root;
-      if (aux->qmode & JQP_QRY_APPLY_DEL) {
+      if (!aux->projection && !(aux->qmode & JQP_QRY_APPLY_DEL)) {
+        // Fixed size values are patched right in the document buffer
+        rc = jql_apply_inplace(q, &jbl, pool, &applied);
+        RCGO(rc, finish);
+      }
+      if (applied) {
         if (cur) {
-          rc = jb_cursor_del(ctx->jbc, cur, id, &jbl);
+          rc = jb_cursor_set(ctx->jbc, cur, id, &jbl, ctx->mptrs, ctx->mptrs_num);
         } else {
-          rc = jb_del(ctx->jbc, &jbl, id);
+          rc = jb_put(ctx->jbc, &jbl, id, ctx->mptrs, ctx->mptrs_num);
         }
-      } else if (aux->apply || aux->apply_placeholder) {
-        struct _JBL sn = {0};
-        rc = jql_apply(q, root, pool);
         RCGO(rc, finish);
-        rc = _jbl_from_node(&sn, root);
+      } else {
+        rc = jbl_to_node(&jbl, &root, pool);
         RCGO(rc, finish);
-        if (cur) {
-          rc = jb_cursor_set(ctx->jbc, cur, id, &sn);
-        } else {
-          rc = jb_put(ctx->jbc, &sn, id);
+        doc.node = root;
+        if (aux->qmode & JQP_QRY_APPLY_DEL) {
+          if (cur) {
+            rc = jb_cursor_del(ctx->jbc, cur, id, &jbl);
+          } else {
+            rc = jb_del(ctx->jbc, &jbl, id);
+          }
+        } else if (aux->apply || aux->apply_placeholder) {
+          struct _JBL sn = {0};
+          rc = jql_apply(q, root, pool);
+          RCGO(rc, finish);
+          rc = _jbl_from_node(&sn, root);
+          RCGO(rc, finish);
+          if (cur) {
+            rc = jb_cursor_set(ctx->jbc, cur, id, &sn, ctx->mptrs, ctx->mptrs_num);
+          } else {
+            rc = jb_put(ctx->jbc, &sn, id, ctx->mptrs, ctx->mptrs_num);
+          }
+          binn_free(&sn.bn);
         }
-        binn_free(&sn.bn);
-      }
-      RCGO(rc, finish);
-      if (aux->projection) {
-        rc = jql_project(q, root);
         RCGO(rc, finish);
+        if (aux->projection) {
+          rc = jql_project(q, root);
+          RCGO(rc, finish);
+        }
       }
     } else if (aux->qmode & JQP_QRY_APPLY_DEL) {
       if (cur) {
@@ -108,6 +125,7 @@ start: {
         rc = ux->visitor(ux, &doc, &ctx->istep);
         RCGO(rc, finish);
       } while (ctx->istep == -1);
+      ctx->rsm.visited = ctx->rsm.track;
     }
     ++ux->cnt;
     *step = ctx->istep > 0 ? 1 : ctx->istep < 0 ? -1 : 0;
@@ -0,0 +1,24 @@
+#include "ejdb2_internal.h"
+
+iwrc jbi_count_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err) {
+  if (!id) { // EOF scan
+    return err;
+  }
+  EJDB_EXEC *ux = ctx->ux;
+  JQP_EXPR *expr1 = ctx->midx.expr1;
+  if (expr1 && !expr1->prematched) {
+    // Range scan is not yet positioned on keys matched by main index expression,
+    // so document should be checked
+    return jbi_consumer(ctx, cur, id, step, matched, err);
+  }
+  *matched = true;
+  *step = 1;
+  if (ux->skip && ux->skip-- > 0) {
+    return 0;
+  }
+  ++ux->cnt;
+  if (--ux->limit < 1) {
+    *step = 0;
+  }
+  return 0;
+}
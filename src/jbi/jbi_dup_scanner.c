@@ -3,7 +3,7 @@
 static iwrc _jbi_consume_eq(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER consumer) {
   iwrc rc;
   bool matched;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[JBNUMBUF_SIZE];
 
   int64_t step = 1;
@@ -18,10 +18,17 @@ static iwrc _jbi_consume_eq(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER
   if (!key.size) {
     return consumer(ctx, 0, 0, 0, 0, 0);
   }
-  rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_GE, &key);
-  if (rc == IWKV_ERROR_NOTFOUND) {
-    return consumer(ctx, 0, 0, 0, 0, 0);
-  } else RCRET(rc);
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, idx->idb, midx->cursor_step, true, &cur, &eof);
+    if (!rc && eof) rc = IWKV_ERROR_NOTFOUND;
+    RCGO(rc, finish);
+  } else {
+    rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_GE, &key);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      return consumer(ctx, 0, 0, 0, 0, 0);
+    } else RCRET(rc);
+  }
 
   do {
     if (step > 0) --step;
@@ -36,6 +43,10 @@ static iwrc _jbi_consume_eq(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER
       step = 1;
       rc = consumer(ctx, 0, id, &step, &matched, 0);
       RCGO(rc, finish);
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, cur, 0, id);
+        RCGO(rc, finish);
+      }
     }
   } while (step && !(rc = iwkv_cursor_to(cur, step > 0 ? midx->cursor_step : cursor_reverse_step)));
 
@@ -69,6 +80,9 @@ static iwrc _jbi_consume_in_node(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONS
   IWKV_val key = {.compound = INT64_MIN};
   JBL_NODE nv = jqval->vnode->child;
 
+  if (ctx->rsm.after) {
+    return consumer(ctx, 0, 0, 0, 0, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  }
   for (i = 0; nv; nv = nv->next) {
     if (nv->type >= JBV_BOOL && nv->type <= JBV_STR) ++i;
   }
@@ -93,6 +107,9 @@ static iwrc _jbi_consume_in_node(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONS
 
   for (int c = 0; c < i && !rc; ++c) {
     JQVAL *jqv = &jqvarr[c];
+    if (c > 0 && !_jbi_cmp_jqval(&jqvarr[c - 1], jqv)) {
+      continue; // Skip duplicated values
+    }
     jbi_jqval_fill_ikey(idx, jqv, &key, numbuf);
     if (cur) {
       iwkv_cursor_close(&cur);
@@ -127,8 +144,9 @@ finish:
 }
 
 static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER consumer) {
+  iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[JBNUMBUF_SIZE];
 
   int64_t step = 1;
@@ -142,24 +160,30 @@ static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUME
   }
   key.compound = (midx->cursor_step == IWKV_CURSOR_PREV) ? INT64_MIN : INT64_MAX;
 
-  iwrc rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
-  if (rc == IWKV_ERROR_NOTFOUND && (midx->expr1->op->value == JQP_OP_LT || midx->expr1->op->value == JQP_OP_LTE)) {
-    iwkv_cursor_close(&cur);
-    key.compound = INT64_MAX;
-    midx->cursor_init = IWKV_CURSOR_BEFORE_FIRST;
-    midx->cursor_step = IWKV_CURSOR_NEXT;
-    rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, 0);
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, idx->idb, midx->cursor_step, true, &cur, &eof);
+    if (!rc && eof) rc = IWKV_ERROR_NOTFOUND;
     RCGO(rc, finish);
-    if (!midx->expr2) { // Fail fast
-      midx->expr2 = midx->expr1;
+  } else {
+    rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
+    if (rc == IWKV_ERROR_NOTFOUND && (midx->expr1->op->value == JQP_OP_LT || midx->expr1->op->value == JQP_OP_LTE)) {
+      iwkv_cursor_close(&cur);
+      key.compound = INT64_MAX;
+      midx->cursor_init = IWKV_CURSOR_BEFORE_FIRST;
+      midx->cursor_step = IWKV_CURSOR_NEXT;
+      rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, 0);
+      RCGO(rc, finish);
+      if (!midx->expr2) { // Fail fast
+        midx->expr2 = midx->expr1;
+      }
+    } else if (rc) {
+      goto finish;
+    }
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      rc = iwkv_cursor_to(cur, midx->cursor_step);
+      RCGO(rc, finish);
     }
-  } else if (rc) {
-    goto finish;
-  }
-
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    rc = iwkv_cursor_to(cur, midx->cursor_step);
-    RCGO(rc, finish);
   }
 
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_PREV)
@@ -181,7 +205,11 @@ static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUME
       step = 1;
       rc = consumer(ctx, 0, id, &step, &matched, 0);
       RCGO(rc, finish);
-      if (!midx->expr1->prematched && matched) {
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, cur, 0, id);
+        RCGO(rc, finish);
+      }
+      if (!midx->expr1->prematched && matched && midx->expr1->op->value != JQP_OP_RE) {
         // Further scan will always match main index expression
         midx->expr1->prematched = true;
       }
@@ -196,19 +224,105 @@ finish:
   return consumer(ctx, 0, 0, 0, 0, rc);
 }
 
+static int _jbi_cmp_i64(const void *v1, const void *v2) {
+  int64_t i1 = *(const int64_t *) v1, i2 = *(const int64_t *) v2;
+  return i1 < i2 ? -1 : i1 > i2 ? 1 : 0;
+}
+
+/**
+ * Full text index scan for words starting with given prefix.
+ * Document may contain many such words, so unique ids are collected
+ * and sorted before passing them to consumer.
+ */
+static iwrc _jbi_consume_fts_prefix(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER consumer) {
+  iwrc rc;
+  size_t sz, num = 0, asz = 0;
+  int64_t id, *ids = 0;
+  IWKV_cursor cur = 0;
+  char kbuf[FTSTOK_MAX_TERM_LEN + 1];
+  char numbuf[JBNUMBUF_SIZE];
+  struct _JBMIDX *midx = &ctx->midx;
+
+  IWKV_val key;
+  jbi_jqval_fill_ikey(midx->idx, jqval, &key, numbuf);
+  key.compound = INT64_MIN;
+  if (ctx->rsm.after) {
+    return consumer(ctx, 0, 0, 0, 0, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  }
+  if (!key.size || key.size > FTSTOK_MAX_TERM_LEN) {
+    return consumer(ctx, 0, 0, 0, 0, 0);
+  }
+  rc = iwkv_cursor_open(midx->idx->idb, &cur, IWKV_CURSOR_GE, &key);
+  RCGO(rc, finish);
+  do {
+    rc = iwkv_cursor_copy_key(cur, kbuf, sizeof(kbuf), &sz, &id);
+    RCGO(rc, finish);
+    if (sz < key.size || memcmp(kbuf, key.data, key.size)) {
+      break;
+    }
+    if (num >= asz) {
+      size_t nsz = asz ? asz * 2 : 64;
+      int64_t *nids = realloc(ids, nsz * sizeof(*ids));
+      if (!nids) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      ids = nids;
+      asz = nsz;
+    }
+    ids[num++] = id;
+  } while (!(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV)));
+
+  if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
+  RCGO(rc, finish);
+  iwkv_cursor_close(&cur);
+
+  if (num > 1) {
+    size_t i, j;
+    qsort(ids, num, sizeof(ids[0]), _jbi_cmp_i64);
+    for (i = 1, j = 1; i < num; ++i) {
+      if (ids[i] != ids[j - 1]) {
+        ids[j++] = ids[i];
+      }
+    }
+    num = j;
+  }
+  for (int64_t i = 0, step = 1; step && i >= 0 && i < (int64_t) num; i += step) {
+    bool matched;
+    rc = consumer(ctx, 0, ids[i], &step, &matched, 0);
+    RCGO(rc, finish);
+  }
+
+finish:
+  if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
+  free(ids);
+  return consumer(ctx, 0, 0, 0, 0, rc);
+}
+
 static iwrc _jbi_consume_noxpr_scan(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
+  iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   int64_t step = 1;
   struct _JBMIDX *midx = &ctx->midx;
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_PREV)
                                        ? IWKV_CURSOR_NEXT : IWKV_CURSOR_PREV;
 
-  iwrc rc = iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0);
-  RCGO(rc, finish);
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    rc = iwkv_cursor_to(cur, midx->cursor_step);
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, midx->idx->idb, midx->cursor_step, true, &cur, &eof);
+    if (!rc && eof) rc = IWKV_ERROR_NOTFOUND;
     RCGO(rc, finish);
+  } else {
+    rc = iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0);
+    RCGO(rc, finish);
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      rc = iwkv_cursor_to(cur, midx->cursor_step);
+      RCGO(rc, finish);
+    }
   }
   do {
     if (step > 0) --step;
@@ -221,6 +335,10 @@ static iwrc _jbi_consume_noxpr_scan(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consum
       step = 1;
       rc = consumer(ctx, 0, id, &step, &matched, 0);
       RCGO(rc, finish);
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, cur, 0, id);
+        RCGO(rc, finish);
+      }
     }
   } while (step && !(rc = iwkv_cursor_to(cur, step > 0 ? midx->cursor_step : cursor_reverse_step)));
 
@@ -241,6 +359,8 @@ iwrc jbi_dup_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
   JQP_QUERY *qp = ctx->ux->q->qp;
   JQVAL *jqval = jql_unit_to_jqval(qp->aux, midx->expr1->right, &rc);
   RCRET(rc);
+  jqval = jql_icase_jqval(midx->expr1->op, jqval, &rc);
+  RCRET(rc);
   switch (midx->expr1->op->value) {
     case JQP_OP_EQ:
       return _jbi_consume_eq(ctx, jqval, consumer);
@@ -252,6 +372,33 @@ iwrc jbi_dup_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
         return IW_ERROR_ASSERTION;
       }
       break;
+    case JQP_OP_RE: {
+      size_t plen;
+      const char *prefix = jql_regexp_prefix(qp->aux, midx->expr1->op, jqval, &plen, &rc);
+      RCRET(rc);
+      JQVAL pjqv = {
+        .type = JQVAL_STR,
+        .vstr = prefix
+      };
+      return _jbi_consume_scan(ctx, &pjqv, consumer);
+    }
+    case JQP_OP_FTS: {
+      bool prefix;
+      const char *term = jql_fts_term(midx->expr1->op, jqval, &prefix, &rc);
+      RCRET(rc);
+      if (!term) {
+        return consumer(ctx, 0, 0, 0, 0, 0);
+      }
+      JQVAL tjqv = {
+        .type = JQVAL_STR,
+        .vstr = term
+      };
+      if (prefix) {
+        return _jbi_consume_fts_prefix(ctx, &tjqv, consumer);
+      } else {
+        return _jbi_consume_eq(ctx, &tjqv, consumer);
+      }
+    }
     default:
       break;
   }
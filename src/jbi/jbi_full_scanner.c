@@ -4,8 +4,18 @@ iwrc jbi_full_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
   bool matched;
   IWKV_cursor cur;
   int64_t step = 1;
-  iwrc rc = iwkv_cursor_open(ctx->jbc->cdb, &cur, ctx->cursor_init, 0);
-  RCRET(rc);
+  iwrc rc;
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, ctx->jbc->cdb, ctx->cursor_step, false, &cur, &eof);
+    RCRET(rc);
+    if (eof) {
+      return consumer(ctx, 0, 0, 0, 0, 0);
+    }
+  } else {
+    rc = iwkv_cursor_open(ctx->jbc->cdb, &cur, ctx->cursor_init, 0);
+    RCRET(rc);
+  }
 
   IWKV_cursor_op cursor_reverse_step = (ctx->cursor_step == IWKV_CURSOR_NEXT)
                                        ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
@@ -27,6 +37,10 @@ iwrc jbi_full_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
       matched = false;
       rc = consumer(ctx, cur, id, &step, &matched, 0);
       RCBREAK(rc);
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, 0, 0, id);
+        RCBREAK(rc);
+      }
     }
   }
   if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
@@ -0,0 +1,724 @@
+#include "ejdb2_internal.h"
+
+static void _jbi_group_release_accs(struct _JBGRP *grp, struct _JBGROUP *g) {
+  for (int i = 0; i < grp->anum; ++i) {
+    if (g->accs[i].distinct) {
+      kh_destroy(JBGRPS, g->accs[i].distinct);
+      g->accs[i].distinct = 0;
+    }
+  }
+}
+
+static void _jbi_group_release(struct _JBEXEC *ctx) {
+  struct _JBGRP *grp = &ctx->grp;
+  for (struct _JBGROUP *g = grp->first; g; g = g->next) {
+    _jbi_group_release_accs(grp, g);
+  }
+  if (grp->ogroup) {
+    _jbi_group_release_accs(grp, grp->ogroup);
+  }
+  if (grp->groups) {
+    kh_destroy(JBGRPM, grp->groups);
+  }
+  iwxstr_destroy(grp->kstr);
+  iwxstr_destroy(grp->vstr);
+  free(grp->ikey);
+  iwpool_destroy(grp->opool);
+  iwpool_destroy(grp->pool);
+  bool ordered = grp->ordered;
+  jbl_type_t otype = grp->otype;
+  memset(grp, 0, sizeof(*grp));
+  grp->ordered = ordered;
+  grp->otype = otype;
+}
+
+static iwrc _jbi_group_init(struct _JBEXEC *ctx) {
+  iwrc rc = 0;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+
+  grp->pool = iwpool_create(1024);
+  grp->kstr = iwxstr_new();
+  grp->vstr = iwxstr_new();
+  grp->groups = kh_init(JBGRPM);
+  if (!grp->pool || !grp->kstr || !grp->vstr || !grp->groups) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next) {
+    ++grp->anum;
+  }
+  grp->names = iwpool_alloc((aux->groupby_num + grp->anum) * sizeof(grp->names[0]), grp->pool);
+  if (!grp->names) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  // Result document keys: `/group/field` and `count`, `sum /field`, ...
+  int i = 0;
+  for (; i < aux->groupby_num; ++i) {
+    iwxstr_clear(grp->kstr);
+    rc = jbl_ptr_serialize(aux->groupby_ptrs[i], grp->kstr);
+    RCRET(rc);
+    grp->names[i] = iwpool_strdup(grp->pool, iwxstr_ptr(grp->kstr), &rc);
+    RCRET(rc);
+  }
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next, ++i) {
+    iwxstr_clear(grp->kstr);
+    rc = iwxstr_cat2(grp->kstr, jqp_aggregate_name(ag->fn));
+    RCRET(rc);
+    if (ag->ptr) {
+      rc = iwxstr_cat(grp->kstr, " ", 1);
+      RCRET(rc);
+      rc = jbl_ptr_serialize(ag->ptr, grp->kstr);
+      RCRET(rc);
+    }
+    grp->names[i] = iwpool_strdup(grp->pool, iwxstr_ptr(grp->kstr), &rc);
+    RCRET(rc);
+  }
+  return rc;
+}
+
+/**
+ * Appends type tagged JSON representation of `v` to `xstr`
+ * so values of different types are never collided.
+ */
+static iwrc _jbi_group_key_cat(IWXSTR *xstr, JBL v) {
+  jbl_type_t t = v ? jbl_type(v) : JBV_NULL;
+  iwrc rc = iwxstr_printf(xstr, "%d:", (int) t);
+  RCRET(rc);
+  if (t > JBV_NULL) {
+    rc = jbl_as_json(v, jbl_xstr_json_printer, xstr, 0);
+  }
+  return rc;
+}
+
+/**
+ * Copies value of document field into `pool` since document buffer is reused.
+ */
+static iwrc _jbi_group_value(struct _JBGRP *grp, IWPOOL *pool, JBL v, JBL_NODE *np) {
+  iwrc rc;
+  JBL_NODE n;
+  jbl_type_t t = jbl_type(v);
+  if (t == JBV_OBJECT || t == JBV_ARRAY) {
+    iwxstr_clear(grp->vstr);
+    rc = jbl_as_json(v, jbl_xstr_json_printer, grp->vstr, 0);
+    RCRET(rc);
+    return jbl_node_from_json(iwxstr_ptr(grp->vstr), np, pool);
+  }
+  n = iwpool_calloc(sizeof(*n), pool);
+  if (!n) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  n->type = t;
+  switch (t) {
+    case JBV_BOOL:
+      n->vbool = jbl_get_i64(v) != 0;
+      break;
+    case JBV_I64:
+      n->vi64 = jbl_get_i64(v);
+      break;
+    case JBV_F64:
+      n->vf64 = jbl_get_f64(v);
+      break;
+    case JBV_STR:
+      n->vptr = iwpool_strdup(pool, jbl_get_str(v), &rc);
+      RCRET(rc);
+      n->vsize = (int) strlen(n->vptr);
+      break;
+    default:
+      n->type = JBV_NULL;
+      break;
+  }
+  *np = n;
+  return 0;
+}
+
+/**
+ * Compares document field value with current min/max value of accumulator,
+ * numbers are compared by value, other values are ordered by type like in `asc` sorting.
+ */
+static int _jbi_group_cmp(JBL v, JBL_NODE n) {
+  jbl_type_t t = jbl_type(v);
+  if ((t == JBV_I64 || t == JBV_F64) && (n->type == JBV_I64 || n->type == JBV_F64)) {
+    if (t == JBV_I64 && n->type == JBV_I64) {
+      int64_t v1 = jbl_get_i64(v);
+      return v1 > n->vi64 ? 1 : v1 < n->vi64 ? -1 : 0;
+    }
+    double v1 = jbl_get_f64(v);
+    double v2 = n->type == JBV_I64 ? (double) n->vi64 : n->vf64;
+    return v1 > v2 ? 1 : v1 < v2 ? -1 : 0;
+  }
+  if (t != n->type) {
+    return t - n->type;
+  }
+  switch (t) {
+    case JBV_BOOL:
+      return (int) jbl_get_i64(v) - (int) n->vbool;
+    case JBV_STR:
+      return strcmp(jbl_get_str(v), n->vptr);
+    default:
+      return 0;
+  }
+}
+
+static iwrc _jbi_group_new(struct _JBEXEC *ctx, IWPOOL *pool, JBL jbl, struct _JBGROUP **gp) {
+  iwrc rc = 0;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  struct _JBGROUP *g = iwpool_calloc(sizeof(*g), pool);
+  if (!g) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  g->vals = iwpool_calloc(aux->groupby_num * sizeof(g->vals[0]) + 1, pool);
+  g->accs = iwpool_calloc(grp->anum * sizeof(g->accs[0]) + 1, pool);
+  if (!g->vals || !g->accs) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (int i = 0; jbl && i < aux->groupby_num; ++i) {
+    struct _JBL v;
+    if (_jbl_at(jbl, aux->groupby_ptrs[i], &v)) {
+      rc = _jbi_group_value(grp, pool, &v, &g->vals[i]);
+      RCRET(rc);
+    }
+  }
+  *gp = g;
+  return rc;
+}
+
+static iwrc _jbi_group_accumulate(struct _JBEXEC *ctx, IWPOOL *pool, struct _JBGROUP *g, JBL jbl) {
+  iwrc rc = 0;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  struct _JBGACC *acc = g->accs;
+
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next, ++acc) {
+    struct _JBL v;
+    if (ag->fn == JQP_AGGR_COUNT) {
+      ++acc->cnt;
+      continue;
+    }
+    if (!_jbl_at(jbl, ag->ptr, &v)) {
+      continue;
+    }
+    jbl_type_t t = jbl_type(&v);
+    switch (ag->fn) {
+      case JQP_AGGR_SUM:
+      case JQP_AGGR_AVG:
+        if (t == JBV_I64) {
+          acc->i64 += jbl_get_i64(&v);
+          ++acc->cnt;
+        } else if (t == JBV_F64) {
+          acc->f64 += jbl_get_f64(&v);
+          acc->real = true;
+          ++acc->cnt;
+        }
+        break;
+      case JQP_AGGR_MIN:
+      case JQP_AGGR_MAX:
+        if (t >= JBV_BOOL && t <= JBV_STR) {
+          int cmp = acc->val ? _jbi_group_cmp(&v, acc->val) : 0;
+          if (!acc->val || (ag->fn == JQP_AGGR_MIN ? cmp < 0 : cmp > 0)) {
+            rc = _jbi_group_value(grp, pool, &v, &acc->val);
+            RCRET(rc);
+          }
+          ++acc->cnt;
+        }
+        break;
+      case JQP_AGGR_DISTINCT: {
+        int ret;
+        JBL_NODE n;
+        iwxstr_clear(grp->vstr);
+        rc = _jbi_group_key_cat(grp->vstr, &v);
+        RCRET(rc);
+        if (!acc->distinct) {
+          acc->distinct = kh_init(JBGRPS);
+          acc->val = iwpool_calloc(sizeof(*acc->val), pool);
+          if (!acc->distinct || !acc->val) {
+            return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+          }
+          acc->val->type = JBV_ARRAY;
+        }
+        if (kh_get(JBGRPS, acc->distinct, iwxstr_ptr(grp->vstr)) != kh_end(acc->distinct)) {
+          break;
+        }
+        char *key = iwpool_strndup(pool, iwxstr_ptr(grp->vstr), iwxstr_size(grp->vstr), &rc);
+        RCRET(rc);
+        kh_put(JBGRPS, acc->distinct, key, &ret);
+        if (ret < 0) {
+          return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        }
+        rc = _jbi_group_value(grp, pool, &v, &n);
+        RCRET(rc);
+        jbl_add_item(acc->val, n);
+        ++acc->cnt;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return rc;
+}
+
+static JBL_NODE _jbi_group_node(IWPOOL *pool, const char *key, JBL_NODE n) {
+  if (!n) {
+    n = iwpool_calloc(sizeof(*n), pool);
+    if (!n) {
+      return 0;
+    }
+    n->type = JBV_NULL;
+  }
+  n->key = key;
+  n->klidx = (int) strlen(key);
+  return n;
+}
+
+/**
+ * Builds result document of group and passes it to query visitor.
+ */
+static iwrc _jbi_group_emit(struct _JBEXEC *ctx, IWPOOL *pool, struct _JBGROUP *g) {
+  iwrc rc = 0;
+  int64_t step = 1;
+  struct _JBL jbl = { 0 };
+  EJDB_EXEC *ux = ctx->ux;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ux->q->aux;
+
+  if (grp->stop) {
+    return 0;
+  }
+  if (ux->skip > 0) {
+    --ux->skip;
+    return 0;
+  }
+  JBL_NODE n, root = iwpool_calloc(sizeof(*root), pool);
+  if (!root) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  root->type = JBV_OBJECT;
+
+  int i = 0;
+  for (; i < aux->groupby_num; ++i) {
+    n = _jbi_group_node(pool, grp->names[i], g->vals[i]);
+    if (!n) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    jbl_add_item(root, n);
+  }
+  struct _JBGACC *acc = g->accs;
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next, ++acc, ++i) {
+    n = 0;
+    if (ag->fn == JQP_AGGR_COUNT || acc->cnt || ag->fn == JQP_AGGR_DISTINCT) {
+      n = iwpool_calloc(sizeof(*n), pool);
+      if (!n) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      switch (ag->fn) {
+        case JQP_AGGR_COUNT:
+          n->type = JBV_I64;
+          n->vi64 = acc->cnt;
+          break;
+        case JQP_AGGR_SUM:
+          if (acc->real) {
+            n->type = JBV_F64;
+            n->vf64 = acc->f64 + acc->i64;
+          } else {
+            n->type = JBV_I64;
+            n->vi64 = acc->i64;
+          }
+          break;
+        case JQP_AGGR_AVG:
+          n->type = JBV_F64;
+          n->vf64 = (acc->f64 + acc->i64) / acc->cnt;
+          break;
+        default: // min, max, distinct
+          if (acc->val) {
+            n = acc->val;
+          } else {
+            n->type = JBV_ARRAY;
+          }
+          break;
+      }
+    }
+    n = _jbi_group_node(pool, grp->names[i], n);
+    if (!n) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    jbl_add_item(root, n);
+  }
+
+  rc = _jbl_from_node(&jbl, root);
+  RCGO(rc, finish);
+  struct _EJDB_DOC doc = {
+    .raw = &jbl
+  };
+  do {
+    step = 1;
+    rc = ux->visitor(ux, &doc, &step);
+    RCGO(rc, finish);
+  } while (step == -1);
+  ++ux->cnt;
+  if (!step || --ux->limit < 1) {
+    grp->stop = true;
+  }
+
+finish:
+  binn_free(&jbl.bn);
+  return rc;
+}
+
+static iwrc _jbi_group_ordered_flush(struct _JBEXEC *ctx) {
+  struct _JBGRP *grp = &ctx->grp;
+  if (!grp->ogroup) {
+    return 0;
+  }
+  iwrc rc = _jbi_group_emit(ctx, grp->opool, grp->ogroup);
+  _jbi_group_release_accs(grp, grp->ogroup);
+  grp->ogroup = 0;
+  grp->okey = 0;
+  iwpool_destroy(grp->opool);
+  grp->opool = 0;
+  return rc;
+}
+
+static iwrc _jbi_group_finish(struct _JBEXEC *ctx) {
+  iwrc rc = 0;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  if (!grp->pool) {
+    rc = _jbi_group_init(ctx);
+    RCRET(rc);
+  }
+  rc = _jbi_group_ordered_flush(ctx);
+  RCRET(rc);
+  if (!grp->first && !aux->groupby_num) {
+    // Aggregates over the whole result set are always reported
+    rc = _jbi_group_new(ctx, grp->pool, 0, &grp->first);
+    RCRET(rc);
+  }
+  for (struct _JBGROUP *g = grp->first; g && !grp->stop; g = g->next) {
+    rc = _jbi_group_emit(ctx, grp->pool, g);
+    RCRET(rc);
+  }
+  return rc;
+}
+
+iwrc jbi_group_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id, int64_t *step, bool *matched, iwrc err) {
+  if (!id) { // EOF scan
+    if (!err) {
+      err = _jbi_group_finish(ctx);
+    }
+    _jbi_group_release(ctx);
+    return err;
+  }
+
+  iwrc rc;
+  struct _JBL jbl;
+  size_t vsz = 0;
+  struct _JBGROUP *g;
+  struct _JBGRP *grp = &ctx->grp;
+  EJDB_EXEC *ux = ctx->ux;
+  struct JQP_AUX *aux = ux->q->aux;
+
+start: {
+    if (cur) {
+      rc = iwkv_cursor_copy_val(cur, ctx->jblbuf, ctx->jblbufsz, &vsz);
+    } else {
+      IWKV_val key = {
+        .data = &id,
+        .size = sizeof(id)
+      };
+      rc = iwkv_get_copy(ctx->jbc->cdb, &key, ctx->jblbuf, ctx->jblbufsz, &vsz);
+    }
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      return 0;
+    }
+    RCRET(rc);
+    if (vsz > ctx->jblbufsz) {
+      size_t nsize = MAX(vsz, ctx->jblbufsz * 2);
+      void *nbuf = realloc(ctx->jblbuf, nsize);
+      if (!nbuf) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      ctx->jblbuf = nbuf;
+      ctx->jblbufsz = nsize;
+      goto start;
+    }
+  }
+
+  rc = jb_exec_doc_decode(ctx, 0, &vsz);
+  RCRET(rc);
+  rc = jbl_from_buf_keep_onstack(&jbl, ctx->jblbuf, vsz);
+  RCRET(rc);
+  rc = jql_matched(ux->q, &jbl, matched);
+  if (rc || !*matched) {
+    return rc;
+  }
+  if (!grp->pool) {
+    rc = _jbi_group_init(ctx);
+    RCRET(rc);
+  }
+
+  bool ordered = grp->ordered;
+  iwxstr_clear(grp->kstr);
+  for (int i = 0; i < aux->groupby_num; ++i) {
+    struct _JBL v;
+    bool found = _jbl_at(&jbl, aux->groupby_ptrs[i], &v);
+    if (i > 0) {
+      rc = iwxstr_cat(grp->kstr, "\t", 1);
+      RCRET(rc);
+    }
+    rc = _jbi_group_key_cat(grp->kstr, found ? &v : 0);
+    RCRET(rc);
+    // Only documents having values of indexed type are ordered by index scan
+    ordered = ordered && found && jbl_type(&v) == grp->otype;
+  }
+
+  if (ordered) {
+    if (grp->okey && strcmp(grp->okey, iwxstr_ptr(grp->kstr)) != 0) {
+      rc = _jbi_group_ordered_flush(ctx);
+      RCRET(rc);
+      if (grp->stop) {
+        *step = 0;
+        return 0;
+      }
+    }
+    if (!grp->ogroup) {
+      grp->opool = iwpool_create(256);
+      if (!grp->opool) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      grp->okey = iwpool_strndup(grp->opool, iwxstr_ptr(grp->kstr), iwxstr_size(grp->kstr), &rc);
+      RCRET(rc);
+      rc = _jbi_group_new(ctx, grp->opool, &jbl, &grp->ogroup);
+      RCRET(rc);
+    }
+    return _jbi_group_accumulate(ctx, grp->opool, grp->ogroup, &jbl);
+  }
+
+  khiter_t k = kh_get(JBGRPM, grp->groups, iwxstr_ptr(grp->kstr));
+  if (k != kh_end(grp->groups)) {
+    g = kh_value(grp->groups, k);
+  } else {
+    int ret;
+    char *key = iwpool_strndup(grp->pool, iwxstr_ptr(grp->kstr), iwxstr_size(grp->kstr), &rc);
+    RCRET(rc);
+    rc = _jbi_group_new(ctx, grp->pool, &jbl, &g);
+    RCRET(rc);
+    k = kh_put(JBGRPM, grp->groups, key, &ret);
+    if (ret < 0) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    kh_value(grp->groups, k) = g;
+    if (grp->last) {
+      grp->last->next = g;
+    } else {
+      grp->first = g;
+    }
+    grp->last = g;
+  }
+  return _jbi_group_accumulate(ctx, grp->pool, g, &jbl);
+}
+
+/**
+ * Reads key of index cursor into `grp->ikey` buffer, key is zero terminated.
+ */
+static iwrc _jbi_group_ikey_read(struct _JBGRP *grp, IWKV_cursor cur, size_t *szp) {
+  size_t sz = 0;
+  iwrc rc = iwkv_cursor_copy_key(cur, grp->ikey, grp->ikeyasz ? grp->ikeyasz - 1 : 0, &sz, 0);
+  RCRET(rc);
+  if (sz >= grp->ikeyasz) {
+    size_t nsz = MAX(sz + 1, 64);
+    char *nbuf = realloc(grp->ikey, nsz);
+    if (!nbuf) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    grp->ikey = nbuf;
+    grp->ikeyasz = nsz;
+    rc = iwkv_cursor_copy_key(cur, grp->ikey, grp->ikeyasz - 1, &sz, 0);
+    RCRET(rc);
+  }
+  grp->ikey[sz] = '\0';
+  *szp = sz;
+  return 0;
+}
+
+/**
+ * Converts key read by `_jbi_group_ikey_read()` into value node of index type.
+ */
+static iwrc _jbi_group_ikey_node(struct _JBGRP *grp, JBIDX idx, size_t sz, IWPOOL *pool, JBL_NODE *np) {
+  iwrc rc = 0;
+  JBL_NODE n = iwpool_calloc(sizeof(*n), pool);
+  if (!n) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  if (idx->mode & EJDB_IDX_STR) {
+    n->type = JBV_STR;
+    n->vptr = iwpool_strndup(pool, grp->ikey, sz, &rc);
+    RCRET(rc);
+    n->vsize = (int) sz;
+  } else if (idx->mode & EJDB_IDX_I64) {
+    n->type = JBV_I64;
+    memcpy(&n->vi64, grp->ikey, sizeof(n->vi64));
+  } else {
+    n->type = JBV_F64;
+    if (idx->idbf & IWDB_REALNUM_KEYS) {
+      n->vf64 = iwatof(grp->ikey);
+    } else {
+      n->vf64 = jbi_ikey_to_f64(grp->ikey);
+    }
+  }
+  *np = n;
+  return rc;
+}
+
+/**
+ * Fetches the lowest (`IWKV_CURSOR_PREV`) or the highest (`IWKV_CURSOR_NEXT`) key of index.
+ */
+static iwrc _jbi_group_index_edge(struct _JBEXEC *ctx, JBIDX idx, IWKV_cursor_op op, JBL_NODE *np) {
+  size_t sz;
+  IWKV_cursor cur;
+  struct _JBGRP *grp = &ctx->grp;
+  iwrc rc = iwkv_cursor_open(idx->idb, &cur,
+                             op == IWKV_CURSOR_PREV ? IWKV_CURSOR_AFTER_LAST : IWKV_CURSOR_BEFORE_FIRST, 0);
+  RCRET(rc);
+  rc = iwkv_cursor_to(cur, op);
+  RCGO(rc, finish);
+  rc = _jbi_group_ikey_read(grp, cur, &sz);
+  RCGO(rc, finish);
+  rc = _jbi_group_ikey_node(grp, idx, sz, grp->pool, np);
+
+finish:
+  if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
+  iwkv_cursor_close(&cur);
+  return rc;
+}
+
+/**
+ * Traverses distinct keys of index in ascending order.
+ * Distinct values are collected into `dacc` if it is set,
+ * otherwise every key is reported as a group with number of its records.
+ * Runs of duplicated keys not needed to be counted are skipped by seeking to the next key.
+ */
+static iwrc _jbi_group_index_keys(struct _JBEXEC *ctx, JBIDX idx, struct _JBGACC *dacc) {
+  size_t sz;
+  IWKV_cursor cur;
+  EJDB_EXEC *ux = ctx->ux;
+  struct _JBGRP *grp = &ctx->grp;
+  bool compound = idx->idbf & IWDB_COMPOUND_KEYS;
+
+  iwrc rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_AFTER_LAST, 0);
+  RCRET(rc);
+  rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV);
+
+  while (!rc && !grp->stop) {
+    JBL_NODE n;
+    rc = _jbi_group_ikey_read(grp, cur, &sz);
+    RCGO(rc, finish);
+    IWKV_val key = {
+      .data = grp->ikey,
+      .size = sz
+    };
+    if (dacc) {
+      rc = _jbi_group_ikey_node(grp, idx, sz, grp->pool, &n);
+      RCGO(rc, finish);
+      jbl_add_item(dacc->val, n);
+      ++dacc->cnt;
+    } else if (ux->skip > 0) {
+      --ux->skip;
+    } else {
+      bool matched;
+      int64_t cnt = 0;
+      struct _JBGROUP *g;
+      if (grp->anum) {
+        do {
+          rc = iwkv_cursor_is_matched_key(cur, &key, &matched, 0);
+          if (rc || !matched) {
+            break;
+          }
+          ++cnt;
+        } while (!(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV)));
+        if (rc && rc != IWKV_ERROR_NOTFOUND) {
+          goto finish;
+        }
+      }
+      grp->opool = iwpool_create(256);
+      if (!grp->opool) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      iwrc rc2 = _jbi_group_new(ctx, grp->opool, 0, &g);
+      if (!rc2) {
+        rc2 = _jbi_group_ikey_node(grp, idx, sz, grp->opool, &g->vals[0]);
+      }
+      for (int i = 0; !rc2 && i < grp->anum; ++i) {
+        g->accs[i].cnt = cnt; // Only `count` aggregates are allowed here
+      }
+      if (!rc2) {
+        rc2 = _jbi_group_emit(ctx, grp->opool, g);
+      }
+      iwpool_destroy(grp->opool);
+      grp->opool = 0;
+      if (rc2) {
+        rc = rc2;
+        goto finish;
+      }
+      if (grp->anum) {
+        continue; // Cursor is already moved past the run of key
+      }
+    }
+    if (compound) {
+      key.compound = INT64_MAX;
+      rc = iwkv_cursor_to_key(cur, IWKV_CURSOR_GE, &key);
+    } else {
+      rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV);
+    }
+  }
+
+finish:
+  if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
+  iwkv_cursor_close(&cur);
+  return rc;
+}
+
+iwrc jbi_group_index_scan(struct _JBEXEC *ctx, JBIDX idx) {
+  struct _JBGROUP *g;
+  struct _JBGRP *grp = &ctx->grp;
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  iwrc rc = _jbi_group_init(ctx);
+  RCGO(rc, finish);
+
+  if (aux->groupby_num) {
+    rc = _jbi_group_index_keys(ctx, idx, 0);
+    goto finish;
+  }
+
+  rc = _jbi_group_new(ctx, grp->pool, 0, &g);
+  RCGO(rc, finish);
+  struct _JBGACC *acc = g->accs;
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next, ++acc) {
+    switch (ag->fn) {
+      case JQP_AGGR_MIN:
+      case JQP_AGGR_MAX:
+        rc = _jbi_group_index_edge(ctx, idx, ag->fn == JQP_AGGR_MIN ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT, &acc->val);
+        RCGO(rc, finish);
+        acc->cnt = acc->val ? 1 : 0;
+        break;
+      case JQP_AGGR_DISTINCT:
+        acc->val = iwpool_calloc(sizeof(*acc->val), grp->pool);
+        if (!acc->val) {
+          rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+          goto finish;
+        }
+        acc->val->type = JBV_ARRAY;
+        rc = _jbi_group_index_keys(ctx, idx, acc);
+        RCGO(rc, finish);
+        break;
+      default:
+        break;
+    }
+  }
+  rc = _jbi_group_emit(ctx, grp->pool, g);
+
+finish:
+  _jbi_group_release(ctx);
+  return rc;
+}
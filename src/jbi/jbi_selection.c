@@ -21,6 +21,14 @@ static void _jbi_print_index(struct _JBIDX *idx, IWXSTR *xstr) {
     if (cnt++) iwxstr_cat2(xstr, "|");
     iwxstr_cat2(xstr, "F64");
   }
+  if (m & EJDB_IDX_FTS) {
+    if (cnt++) iwxstr_cat2(xstr, "|");
+    iwxstr_cat2(xstr, "FTS");
+  }
+  if (m & EJDB_IDX_ICASE) {
+    if (cnt++) iwxstr_cat2(xstr, "|");
+    iwxstr_cat2(xstr, "ICASE");
+  }
   if (cnt++) iwxstr_cat2(xstr, "|");
   iwxstr_printf(xstr, "%lld ", idx->rnum);
   jbl_ptr_serialize(idx->ptr, xstr);
@@ -75,6 +83,18 @@ static void _jbi_log_index_rules(IWXSTR *xstr, struct _JBMIDX *mctx) {
   iwxstr_cat2(xstr, "\n");
 }
 
+/**
+ * Partial index is used only if query filter implies index filter,
+ * since documents not matched by index filter are not stored in index.
+ */
+static bool _jbi_idx_usable(JBEXEC *ctx, struct _JBIDX *idx, iwrc *rcp) {
+  *rcp = 0;
+  if (!idx->fq) {
+    return true;
+  }
+  return jql_implies(ctx->ux->q, idx->fq, rcp);
+}
+
 IW_INLINE int _jbi_idx_expr_op_weight(struct _JBMIDX *midx) {
   jqp_op_t op = midx->expr1->op->value;
   switch (op) {
@@ -83,6 +103,8 @@ IW_INLINE int _jbi_idx_expr_op_weight(struct _JBMIDX *midx) {
     case JQP_OP_IN:
       //case JQP_OP_NI: todo
       return 9;
+    case JQP_OP_FTS:
+      return midx->cursor_init == IWKV_CURSOR_EQ ? 9 : 7;
     default:
       break;
   }
@@ -92,6 +114,7 @@ IW_INLINE int _jbi_idx_expr_op_weight(struct _JBMIDX *midx) {
   switch (op) {
     case JQP_OP_GT:
     case JQP_OP_GTE:
+    case JQP_OP_RE:
       return 7;
     case JQP_OP_LT:
     case JQP_OP_LTE:
@@ -106,9 +129,8 @@ static bool _jbi_is_solid_node_expression(const JQP_NODE *n) {
   for (const JQP_EXPR *expr = &unit->expr; expr; expr = expr->next) {
     if (
       expr->op->negate
-      || (expr->join && (expr->join->negate || expr->join->value == JQP_JOIN_OR))
-      || expr->op->value == JQP_OP_RE) {
-      // No negate conditions, No OR, No regexp
+      || (expr->join && (expr->join->negate || expr->join->value == JQP_JOIN_OR))) {
+      // No negate conditions, No OR
       return false;
     }
     JQPUNIT *left = expr->left;
@@ -121,9 +143,39 @@ static bool _jbi_is_solid_node_expression(const JQP_NODE *n) {
   return true;
 }
 
+static iwrc _jbi_compute_fts_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
+  JQP_AUX *aux = ctx->ux->q->aux;
+  mctx->orderby_support = false;
+  for (JQP_EXPR *expr = mctx->nexpr; expr; expr = expr->next) {
+    iwrc rc = 0;
+    bool prefix;
+    if (expr->op->value != JQP_OP_FTS || expr->left->type != JQP_STRING_TYPE) {
+      continue;
+    }
+    JQVAL *rv = jql_unit_to_jqval(aux, expr->right, &rc);
+    RCRET(rc);
+    const char *term = jql_fts_term(expr->op, rv, &prefix, &rc);
+    RCRET(rc);
+    if (!term) {
+      continue;
+    }
+    // Prefer postings of exact term over scan of terms range
+    if (!mctx->expr1 || (mctx->cursor_init != IWKV_CURSOR_EQ && !prefix)) {
+      mctx->expr1 = expr;
+      mctx->cursor_init = prefix ? IWKV_CURSOR_GE : IWKV_CURSOR_EQ;
+      mctx->cursor_step = IWKV_CURSOR_PREV;
+    }
+  }
+  return 0;
+}
+
 static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
   JQP_EXPR *expr = mctx->nexpr; // Node expression
+  JQP_EXPR *rexpr = 0;          // Regexp expression with literal prefix
   if (!expr) return 0;
+  if (mctx->idx->mode & EJDB_IDX_FTS) {
+    return _jbi_compute_fts_index_rules(ctx, mctx);
+  }
   JQP_AUX *aux = ctx->ux->q->aux;
 
   for (; expr; expr = expr->next) {
@@ -134,6 +186,21 @@ static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
     if (expr->left->type != JQP_STRING_TYPE) {
       continue;
     }
+    if (expr->op->icase != ((mctx->idx->mode & EJDB_IDX_ICASE) != 0)) {
+      // Case insensitive operations are served only by case insensitive indexes
+      continue;
+    }
+    if (op == JQP_OP_RE) {
+      if (!rexpr && (mctx->idx->mode & EJDB_IDX_STR)) {
+        size_t plen;
+        jql_regexp_prefix(aux, expr->op, rv, &plen, &rc);
+        RCRET(rc);
+        if (plen) {
+          rexpr = expr;
+        }
+      }
+      continue;
+    }
     switch (rv->type) {
       case JQVAL_NULL:
       case JQVAL_RE:
@@ -147,10 +214,9 @@ static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
         for (JBL_NODE n = rv->vnode->child; n; n = n->next, ++vcnt);
         if (
           vcnt > JB_IDX_EMPIRIC_MIN_INOP_ARRAY_SIZE
-          && (vcnt > JB_IDX_EMPIRIC_MAX_INOP_ARRAY_SIZE
-              || mctx->idx->rnum < rv->vbinn->count * JB_IDX_EMPIRIC_MAX_INOP_ARRAY_RATIO)
+          && mctx->idx->rnum < vcnt * JB_IDX_EMPIRIC_MAX_INOP_ARRAY_RATIO
         ) {
-          // No index for large IN array | small collection size
+          // No index for IN array which is large relative to collection size
           continue;
         }
         break;
@@ -206,6 +272,14 @@ static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
     }
   }
 
+  if (rexpr && !mctx->expr1 && !mctx->expr2) {
+    // Scan index range of keys starting with regexp literal prefix
+    mctx->expr1 = rexpr;
+    mctx->expr2 = rexpr;
+    mctx->cursor_init = IWKV_CURSOR_GE;
+    mctx->cursor_step = IWKV_CURSOR_PREV;
+  }
+
   if (mctx->expr2) {
     if (!mctx->expr1) {
       mctx->expr1 = mctx->expr2;
@@ -228,7 +302,7 @@ static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct _JBMIDX *mctx) {
           mctx->orderby_support = false;
         }
       }
-      if (!mctx->orderby_support && mctx->expr2) {
+      if (!mctx->orderby_support && mctx->expr2 && mctx->expr2 != mctx->expr1) {
         JQP_EXPR *tmp = mctx->expr1;
         mctx->expr1 = mctx->expr2;
         mctx->expr2 = tmp;
@@ -294,6 +368,10 @@ static iwrc _jbi_collect_indexes(JBEXEC *ctx,
       struct _JBMIDX mctx = {.filter = f};
       struct _JBL_PTR *ptr = idx->ptr;
       if (ptr->cnt > fnc) continue;
+      if (!_jbi_idx_usable(ctx, idx, &rc)) {
+        RCRET(rc);
+        continue;
+      }
 
       JQP_EXPR *nexpr = 0;
       int i = 0, j = 0;
@@ -374,8 +452,11 @@ static struct _JBIDX *_jbi_select_index_for_orderby(JBEXEC *ctx) {
   struct _JBL_PTR *obp = aux->orderby_ptrs[0];
   assert(obp);
   for (struct _JBIDX *idx = ctx->jbc->idx; idx; idx = idx->next) {
+    iwrc rc;
     struct _JBL_PTR *ptr = idx->ptr;
-    if (obp->cnt != ptr->cnt) {
+    // Full text index keeps record per word and case insensitive index is ordered by case folded values,
+    // so their scan order is not the order of field values
+    if (obp->cnt != ptr->cnt || (idx->mode & (EJDB_IDX_FTS | EJDB_IDX_ICASE)) || !_jbi_idx_usable(ctx, idx, &rc)) {
       continue;
     }
     int i = 0;
@@ -397,6 +478,40 @@ static struct _JBIDX *_jbi_select_index_for_orderby(JBEXEC *ctx) {
   return 0;
 }
 
+static bool _jbi_ptr_eq(struct _JBL_PTR *p1, struct _JBL_PTR *p2) {
+  if (p1->cnt != p2->cnt) {
+    return false;
+  }
+  for (int i = 0; i < p1->cnt; ++i) {
+    if (strcmp(p1->n[i], p2->n[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Documents are grouped by index scan order without hashing
+ * if selected index is built over the single group-by field.
+ */
+static void _jbi_select_group_order(JBEXEC *ctx) {
+  struct JQP_AUX *aux = ctx->ux->q->aux;
+  struct _JBIDX *idx = ctx->midx.idx;
+  if ((idx->mode & (EJDB_IDX_FTS | EJDB_IDX_ICASE)) || !_jbi_ptr_eq(idx->ptr, aux->groupby_ptrs[0])) {
+    return;
+  }
+  if (idx->mode & EJDB_IDX_STR) {
+    ctx->grp.otype = JBV_STR;
+  } else if (idx->mode & EJDB_IDX_I64) {
+    ctx->grp.otype = JBV_I64;
+  } else if (idx->mode & EJDB_IDX_F64) {
+    ctx->grp.otype = JBV_F64;
+  } else {
+    return;
+  }
+  ctx->grp.ordered = true;
+}
+
 iwrc jbi_selection(JBEXEC *ctx) {
   iwrc rc = 0;
   size_t snp = 0;
@@ -442,5 +557,93 @@ iwrc jbi_selection(JBEXEC *ctx) {
       }
     }
   }
+  if ((aux->qmode & JQP_QRY_GROUP) && aux->groupby_num == 1 && ctx->midx.idx) {
+    _jbi_select_group_order(ctx);
+  }
   return rc;
 }
+
+bool jbi_count_covered(JBEXEC *ctx) {
+  JQL q = ctx->ux->q;
+  struct _JBMIDX *midx = &ctx->midx;
+  if (!midx->idx || !midx->expr1) {
+    // Collection or index scan without expression, every document is matched by `/*` query
+    return jql_is_match_all(q);
+  }
+  jqp_op_t op = midx->expr1->op->value;
+  if (op == JQP_OP_RE || op == JQP_OP_FTS) {
+    return false;
+  }
+  JQP_EXPR_NODE *en = q->aux->expr;
+  if (en->next || !en->chain || en->chain->next || en->chain->type != JQP_FILTER_TYPE) {
+    return false;
+  }
+  struct _JBL_PTR *ptr = midx->idx->ptr;
+  JQP_NODE *n = ((JQP_FILTER *) en->chain)->node;
+  for (int i = 0; i < ptr->cnt - 1; ++i, n = n->next) {
+    if (!n || n->ntype != JQP_NODE_FIELD) {
+      return false;
+    }
+  }
+  if (!n || n->next || n->ntype != JQP_NODE_EXPR || n->value->type != JQP_EXPR_TYPE) {
+    return false;
+  }
+  // Filter is served entirely by index if node contains only
+  // the main index expression and the range bound checked on index keys
+  for (JQP_EXPR *expr = &n->value->expr; expr; expr = expr->next) {
+    JQPUNIT *left = expr->left;
+    if (expr->op->negate
+        || (expr->join && (expr->join->negate || expr->join->value != JQP_JOIN_AND))
+        || left->type != JQP_STRING_TYPE
+        || (left->string.flavour & (JQP_STR_STAR | JQP_STR_DBL_STAR))
+        || strcmp(left->string.value, ptr->n[ptr->cnt - 1]) != 0) {
+      return false;
+    }
+    if (expr != midx->expr1 && (expr != midx->expr2 || op == JQP_OP_EQ || op == JQP_OP_IN)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+JBIDX jbi_group_index_covered(JBEXEC *ctx) {
+  JQL q = ctx->ux->q;
+  struct JQP_AUX *aux = q->aux;
+  struct _JBL_PTR *fptr = 0;
+  if ((aux->qmode & JQP_QRY_NOIDX) || aux->groupby_num > 1 || !jql_is_match_all(q)) {
+    return 0;
+  }
+  if (aux->groupby_num) {
+    // Facet counts: `group /f count`
+    fptr = aux->groupby_ptrs[0];
+    for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next) {
+      if (ag->fn != JQP_AGGR_COUNT) {
+        return 0;
+      }
+    }
+  } else {
+    // Values of single field: `min /f max /f distinct /f`
+    for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next) {
+      if (ag->fn != JQP_AGGR_MIN && ag->fn != JQP_AGGR_MAX && ag->fn != JQP_AGGR_DISTINCT) {
+        return 0;
+      }
+      if (!fptr) {
+        fptr = ag->ptr;
+      } else if (!_jbi_ptr_eq(fptr, ag->ptr)) {
+        return 0;
+      }
+    }
+  }
+  if (!fptr) {
+    return 0;
+  }
+  for (struct _JBIDX *idx = ctx->jbc->idx; idx; idx = idx->next) {
+    if (!(idx->mode & (EJDB_IDX_FTS | EJDB_IDX_ICASE))
+        && (idx->mode & (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64))
+        && !idx->fq
+        && _jbi_ptr_eq(idx->ptr, fptr)) {
+      return idx;
+    }
+  }
+  return 0;
+}
@@ -55,10 +55,20 @@ finish:
 }
 
 static iwrc _jbi_scan_sorter_apply(IWPOOL *pool, struct _JBEXEC *ctx, JQL q, struct _EJDB_DOC *doc) {
+  iwrc rc;
   JBL_NODE root;
   JBL jbl = doc->raw;
   struct JQP_AUX *aux = q->aux;
-  iwrc rc = jbl_to_node(jbl, &root, pool);
+  if (!aux->projection && !(aux->qmode & JQP_QRY_APPLY_DEL) && !ctx->ssc.sof_active) {
+    bool applied;
+    // Fixed size values are patched right in the in-memory sort buffer
+    rc = jql_apply_inplace(q, jbl, pool, &applied);
+    RCRET(rc);
+    if (applied) {
+      return jb_put(ctx->jbc, jbl, doc->id, ctx->mptrs, ctx->mptrs_num);
+    }
+  }
+  rc = jbl_to_node(jbl, &root, pool);
   RCRET(rc);
   doc->node = root;
   if (aux->qmode & JQP_QRY_APPLY_DEL) {
@@ -70,7 +80,7 @@ static iwrc _jbi_scan_sorter_apply(IWPOOL *pool, struct _JBEXEC *ctx, JQL q, str
     RCRET(rc);
     rc = _jbl_from_node(&sn, root);
     RCRET(rc);
-    rc = jb_put(ctx->jbc, &sn, doc->id);
+    rc = jb_put(ctx->jbc, &sn, doc->id, ctx->mptrs, ctx->mptrs_num);
     binn_free(&sn.bn);
     RCRET(rc);
   }
@@ -191,16 +201,70 @@ iwrc jbi_sorter_consumer(struct _JBEXEC *ctx, IWKV_cursor cur, int64_t id,
   struct _JBSSC *ssc = &ctx->ssc;
   EJDB db = ctx->jbc->db;
   IWFS_EXT *sof = &ssc->sof;
+  IWKV_val key = {
+    .data = &id,
+    .size = sizeof(id)
+  };
+
+  bool fetched = false;
+  JBCOLL jbc = ctx->jbc;
 
-start: {
+  // Document is read directly into the tail of in-memory sort buffer
+  // saving a copy of matched document, it fits the buffer in most cases.
+  // Skipped for collections storing encoded documents since they are decoded into separate buffer anyway.
+  if (ssc->docs && ssc->docs_npos + sizeof(id) < ssc->docs_asz && !jbc->kdict.enabled && !jbc->zthreshold) {
+    uint8_t *wp = ssc->docs + ssc->docs_npos;
+    size_t cap = ssc->docs_asz - ssc->docs_npos - sizeof(id);
+    if (cur) {
+      rc = iwkv_cursor_copy_val(cur, wp + sizeof(id), cap, &vsz);
+    } else {
+      rc = iwkv_get_copy(jbc->cdb, &key, wp + sizeof(id), cap, &vsz);
+    }
+    if (rc == IWKV_ERROR_NOTFOUND) return 0;
+    else RCRET(rc);
+    if (vsz <= cap) {
+      if (!jb_doc_is_encoded(wp + sizeof(id), vsz)) {
+        rc = jbl_from_buf_keep_onstack(&jbl, wp + sizeof(id), vsz);
+        RCRET(rc);
+        rc = jql_matched(ctx->ux->q, &jbl, matched);
+        if (rc || !*matched) {
+          return rc;
+        }
+        if (ssc->refs_asz <= (ssc->refs_num + 1) * sizeof(ssc->refs[0])) {
+          ssc->refs_asz *= 2;
+          uint32_t *nrefs = realloc(ssc->refs, ssc->refs_asz);
+          if (!nrefs) {
+            return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+          }
+          ssc->refs = nrefs;
+        }
+        memcpy(wp, &id, sizeof(id));
+        ssc->refs[ssc->refs_num++] = ssc->docs_npos;
+        ssc->docs_npos += vsz + sizeof(id);
+        return 0;
+      }
+      // Encoded document stored before collection options were changed,
+      // it is decoded from the bytes already read
+      if (vsz + sizeof(id) > ctx->jblbufsz) {
+        size_t nsize = MAX(vsz + sizeof(id), ctx->jblbufsz * 2);
+        void *nbuf = realloc(ctx->jblbuf, nsize);
+        if (!nbuf) {
+          return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        }
+        ctx->jblbuf = nbuf;
+        ctx->jblbufsz = nsize;
+      }
+      memcpy(ctx->jblbuf + sizeof(id), wp + sizeof(id), vsz);
+      fetched = true;
+    }
+  }
+
+  if (!fetched) {
+start:
     if (cur) {
       rc = iwkv_cursor_copy_val(cur, ctx->jblbuf + sizeof(id), ctx->jblbufsz - sizeof(id), &vsz);
     } else {
-      IWKV_val key = {
-        .data = &id,
-        .size = sizeof(id)
-      };
-      rc = iwkv_get_copy(ctx->jbc->cdb, &key, ctx->jblbuf + sizeof(id), ctx->jblbufsz - sizeof(id), &vsz);
+      rc = iwkv_get_copy(jbc->cdb, &key, ctx->jblbuf + sizeof(id), ctx->jblbufsz - sizeof(id), &vsz);
     }
     if (rc == IWKV_ERROR_NOTFOUND) rc = 0;
     else RCRET(rc);
@@ -216,6 +280,8 @@ start: {
     }
   }
 
+  rc = jb_exec_doc_decode(ctx, sizeof(id), &vsz);
+  RCRET(rc);
   rc = jbl_from_buf_keep_onstack(&jbl, ctx->jblbuf + sizeof(id), vsz);
   RCRET(rc);
 
@@ -9,13 +9,14 @@ static iwrc _jbi_consume_eq(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER
   bool matched;
   struct _JBMIDX *midx = &ctx->midx;
   char numbuf[JBNUMBUF_SIZE];
+  char vnumbuf[JBNUMBUF_SIZE];
   IWKV_val key;
 
   jbi_jqval_fill_ikey(midx->idx, jqval, &key, numbuf);
   if (!key.size) {
     return consumer(ctx, 0, 0, 0, 0, 0);
   }
-  iwrc rc = iwkv_get_copy(midx->idx->idb, &key, numbuf, sizeof(numbuf), &sz);
+  iwrc rc = iwkv_get_copy(midx->idx->idb, &key, vnumbuf, sizeof(vnumbuf), &sz);
   if (rc) {
     if (rc == IWKV_ERROR_NOTFOUND) {
       return consumer(ctx, 0, 0, 0, 0, 0);
@@ -23,8 +24,14 @@ static iwrc _jbi_consume_eq(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER
       return rc;
     }
   }
-  IW_READVNUMBUF64_2(numbuf, id);
+  IW_READVNUMBUF64_2(vnumbuf, id);
+  if (ctx->rsm.after && ctx->rsm.after_id == id) { // Already visited
+    return consumer(ctx, 0, 0, 0, 0, 0);
+  }
   rc = consumer(ctx, 0, id, &step, &matched, 0);
+  if (!rc && ctx->rsm.visited) {
+    rc = jbi_rsm_mark(ctx, 0, &key, id);
+  }
   return consumer(ctx, 0, 0, 0, 0, rc);
 }
 
@@ -41,6 +48,9 @@ static iwrc _jbi_consume_in_node(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONS
   struct _JBMIDX *midx = &ctx->midx;
   JBL_NODE nv = jqval->vnode->child;
 
+  if (ctx->rsm.after) {
+    return consumer(ctx, 0, 0, 0, 0, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  }
   if (!nv) {
     return consumer(ctx, 0, 0, 0, 0, 0);
   }
@@ -74,8 +84,9 @@ finish:
 }
 
 static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUMER consumer) {
+  iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[JBNUMBUF_SIZE];
 
   int64_t step = 1;
@@ -85,27 +96,33 @@ static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUME
   IWKV_val key;
   jbi_jqval_fill_ikey(idx, jqval, &key, numbuf);
 
-  iwrc rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
-  if (rc == IWKV_ERROR_NOTFOUND && (midx->expr1->op->value == JQP_OP_LT || midx->expr1->op->value == JQP_OP_LTE)) {
-    iwkv_cursor_close(&cur);
-    midx->cursor_init = IWKV_CURSOR_BEFORE_FIRST;
-    midx->cursor_step = IWKV_CURSOR_NEXT;
-    rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, 0);
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, idx->idb, midx->cursor_step, true, &cur, &eof);
+    if (!rc && eof) rc = IWKV_ERROR_NOTFOUND;
     RCGO(rc, finish);
-    if (!midx->expr2) { // Fail fast
-      midx->expr2 = midx->expr1;
+  } else {
+    rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
+    if (rc == IWKV_ERROR_NOTFOUND && (midx->expr1->op->value == JQP_OP_LT || midx->expr1->op->value == JQP_OP_LTE)) {
+      iwkv_cursor_close(&cur);
+      midx->cursor_init = IWKV_CURSOR_BEFORE_FIRST;
+      midx->cursor_step = IWKV_CURSOR_NEXT;
+      rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, 0);
+      RCGO(rc, finish);
+      if (!midx->expr2) { // Fail fast
+        midx->expr2 = midx->expr1;
+      }
+    } else if (rc) {
+      goto finish;
+    }
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      rc = iwkv_cursor_to(cur, midx->cursor_step);
+      RCGO(rc, finish);
     }
-  } else if (rc) {
-    goto finish;
   }
 
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_NEXT)
                                        ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
-
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    rc = iwkv_cursor_to(cur, midx->cursor_step);
-    RCGO(rc, finish);
-  }
   do {
     if (step > 0) --step;
     else if (step < 0) ++step;
@@ -129,7 +146,11 @@ static iwrc _jbi_consume_scan(struct _JBEXEC *ctx, JQVAL *jqval, JB_SCAN_CONSUME
       step = 1;
       rc = consumer(ctx, 0, id, &step, &matched, 0);
       RCGO(rc, finish);
-      if (!midx->expr1->prematched && matched) {
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, cur, 0, id);
+        RCGO(rc, finish);
+      }
+      if (!midx->expr1->prematched && matched && midx->expr1->op->value != JQP_OP_RE) {
         // Further scan will always match main index expression
         midx->expr1->prematched = true;
       }
@@ -145,19 +166,27 @@ finish:
 }
 
 iwrc _jbi_consume_noxpr_scan(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
+  iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[JBNUMBUF_SIZE];
   int64_t step = 1;
   struct _JBMIDX *midx = &ctx->midx;
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_NEXT)
                                        ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
 
-  iwrc rc = iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0);
-  RCGO(rc, finish);
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    rc = iwkv_cursor_to(cur, midx->cursor_step);
+  if (ctx->rsm.after) {
+    bool eof;
+    rc = jbi_rsm_cursor_open(ctx, midx->idx->idb, midx->cursor_step, true, &cur, &eof);
+    if (!rc && eof) rc = IWKV_ERROR_NOTFOUND;
+    RCGO(rc, finish);
+  } else {
+    rc = iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0);
     RCGO(rc, finish);
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      rc = iwkv_cursor_to(cur, midx->cursor_step);
+      RCGO(rc, finish);
+    }
   }
   do {
     if (step > 0) --step;
@@ -177,6 +206,10 @@ iwrc _jbi_consume_noxpr_scan(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
       step = 1;
       rc = consumer(ctx, 0, id, &step, &matched, 0);
       RCGO(rc, finish);
+      if (ctx->rsm.visited) {
+        rc = jbi_rsm_mark(ctx, cur, 0, id);
+        RCGO(rc, finish);
+      }
     }
   } while (step && !(rc = iwkv_cursor_to(cur, step > 0 ? midx->cursor_step : cursor_reverse_step)));
 
@@ -197,6 +230,8 @@ iwrc jbi_uniq_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
   JQP_QUERY *qp = ctx->ux->q->qp;
   JQVAL *jqval = jql_unit_to_jqval(qp->aux, midx->expr1->right, &rc);
   RCRET(rc);
+  jqval = jql_icase_jqval(midx->expr1->op, jqval, &rc);
+  RCRET(rc);
   switch (midx->expr1->op->value) {
     case JQP_OP_EQ:
       return _jbi_consume_eq(ctx, jqval, consumer);
@@ -208,6 +243,16 @@ iwrc jbi_uniq_scanner(struct _JBEXEC *ctx, JB_SCAN_CONSUMER consumer) {
         return IW_ERROR_ASSERTION;
       }
       break;
+    case JQP_OP_RE: {
+      size_t plen;
+      const char *prefix = jql_regexp_prefix(qp->aux, midx->expr1->op, jqval, &plen, &rc);
+      RCRET(rc);
+      JQVAL pjqv = {
+        .type = JQVAL_STR,
+        .vstr = prefix
+      };
+      return _jbi_consume_scan(ctx, &pjqv, consumer);
+    }
     default:
       break;
   }
@@ -4,11 +4,51 @@
 
 // ---------------------------------------------------------------------------
 
+void jbi_f64_to_ikey(double v, char buf[static sizeof(double)]) {
+  uint64_t bits;
+  if (v == 0.0) {
+    v = 0.0; // Normalize negative zero
+  }
+  memcpy(&bits, &v, sizeof(bits));
+  // Flip all bits of negative numbers and sign bit of positive ones
+  bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+  for (int i = 7; i >= 0; --i) { // Big-endian
+    buf[i] = (char) (bits & 0xff);
+    bits >>= 8;
+  }
+}
+
+double jbi_ikey_to_f64(const char buf[static sizeof(double)]) {
+  double v;
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits = (bits << 8) | (uint8_t) buf[i];
+  }
+  bits = (bits & 0x8000000000000000ULL) ? (bits & ~0x8000000000000000ULL) : ~bits;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+/**
+ * Fills key of `EJDB_IDX_F64` index. Indexes created with `IWDB_REALNUM_KEYS` flag
+ * keep decimal string keys, otherwise keys are 8 bytes order preserving
+ * encoding of double values compared as plain bytes.
+ */
+IW_INLINE void _jbi_f64_fill_ikey(JBIDX idx, double v, IWKV_val *ikey, char numbuf[static JBNUMBUF_SIZE]) {
+  ikey->data = numbuf;
+  if (idx->idbf & IWDB_REALNUM_KEYS) {
+    jbi_ftoa(v, numbuf, &ikey->size);
+  } else {
+    jbi_f64_to_ikey(v, numbuf);
+    ikey->size = sizeof(double);
+  }
+}
+
 // fixme: code duplication below
 void jbi_jbl_fill_ikey(JBIDX idx, JBL jbv, IWKV_val *ikey, char numbuf[static JBNUMBUF_SIZE]) {
   int64_t *llv = (void *) numbuf;
   jbl_type_t jbvt = jbl_type(jbv);
-  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE));
+  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE | EJDB_IDX_ICASE));
   ikey->size = 0;
   ikey->data = 0;
 
@@ -64,10 +104,10 @@ void jbi_jbl_fill_ikey(JBIDX idx, JBL jbv, IWKV_val *ikey, char numbuf[static JB
         case JBV_F64:
         case JBV_I64:
         case JBV_BOOL:
-          jbi_ftoa(jbl_get_f64(jbv), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jbl_get_f64(jbv), ikey, numbuf);
           break;
         case JBV_STR:
-          jbi_ftoa(iwatof(jbl_get_str(jbv)), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(jbl_get_str(jbv)), ikey, numbuf);
           break;
         default:
           ikey->size = 0;
@@ -84,7 +124,7 @@ void jbi_jqval_fill_ikey(JBIDX idx, const JQVAL *jqval, IWKV_val *ikey, char num
   int64_t *llv = (void *) numbuf;
   ikey->size = 0;
   ikey->data = numbuf;
-  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE));
+  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE | EJDB_IDX_ICASE));
   jqval_type_t jqvt = jqval->type;
 
   switch (itype) {
@@ -141,16 +181,16 @@ void jbi_jqval_fill_ikey(JBIDX idx, const JQVAL *jqval, IWKV_val *ikey, char num
       ikey->data = numbuf;
       switch (jqvt) {
         case JQVAL_F64:
-          jbi_ftoa(jqval->vf64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jqval->vf64, ikey, numbuf);
           break;
         case JQVAL_I64:
-          jbi_ftoa(jqval->vi64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jqval->vi64, ikey, numbuf);
           break;
         case JQVAL_BOOL:
-          jbi_ftoa(jqval->vbool, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jqval->vbool, ikey, numbuf);
           break;
         case JQVAL_STR:
-          jbi_ftoa(iwatof(jqval->vstr), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(jqval->vstr), ikey, numbuf);
           break;
         default:
           ikey->size = 0;
@@ -158,6 +198,12 @@ void jbi_jqval_fill_ikey(JBIDX idx, const JQVAL *jqval, IWKV_val *ikey, char num
           break;
       }
       break;
+    case EJDB_IDX_FTS:
+      if (jqvt == JQVAL_STR) { // Normalized term
+        ikey->size = strlen(jqval->vstr);
+        ikey->data = (void *) jqval->vstr;
+      }
+      break;
     default:
       break;
   }
@@ -167,7 +213,7 @@ void jbi_node_fill_ikey(JBIDX idx, JBL_NODE node, IWKV_val *ikey, char numbuf[st
   int64_t *llv = (void *) numbuf;
   ikey->size = 0;
   ikey->data = numbuf;
-  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE));
+  ejdb_idx_mode_t itype = (idx->mode & ~(EJDB_IDX_UNIQUE | EJDB_IDX_ICASE));
   jbl_type_t jbvt = node->type;
 
   switch (itype) {
@@ -224,16 +270,16 @@ void jbi_node_fill_ikey(JBIDX idx, JBL_NODE node, IWKV_val *ikey, char numbuf[st
       ikey->data = numbuf;
       switch (jbvt) {
         case JBV_F64:
-          jbi_ftoa(node->vf64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, node->vf64, ikey, numbuf);
           break;
         case JBV_I64:
-          jbi_ftoa(node->vi64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, node->vi64, ikey, numbuf);
           break;
         case JBV_BOOL:
-          jbi_ftoa(node->vbool, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, node->vbool, ikey, numbuf);
           break;
         case JBV_STR:
-          jbi_ftoa(iwatof(node->vptr), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(node->vptr), ikey, numbuf);
           break;
         default:
           ikey->size = 0;
@@ -262,25 +308,36 @@ bool jbi_node_expr_matched(JQP_AUX *aux, JBIDX idx, IWKV_cursor cur, JQP_EXPR *e
   rc = iwkv_cursor_copy_key(cur, kbuf, sizeof(skey) - 1, &sz, 0);
   RCGO(rc, finish);
   if (sz > sizeof(skey) - 1) {
-    kbuf = malloc(sz);
+    kbuf = malloc(sz + 1);
     if (!kbuf) {
       rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
       goto finish;
     }
-    rc = iwkv_cursor_copy_key(cur, kbuf, sizeof(skey) - 1, &sz, 0);
+    rc = iwkv_cursor_copy_key(cur, kbuf, sz, &sz, 0);
     RCGO(rc, finish);
   }
   if (idx->mode & EJDB_IDX_STR) {
     kbuf[sz] = '\0';
     lv.type = JQVAL_STR;
     lv.vstr = kbuf;
+    if (expr->op->value == JQP_OP_RE) {
+      // Regexp index scan is bounded by its literal prefix
+      size_t plen;
+      const char *prefix = jql_regexp_prefix(aux, expr->op, rv, &plen, &rc);
+      ret = !rc && plen && sz >= plen && !strncmp(kbuf, prefix, plen);
+      goto finish;
+    }
   } else if (idx->mode & EJDB_IDX_I64) {
     memcpy(&lv.vi64, kbuf, sizeof(lv.vi64));
     lv.type = JQVAL_I64;
   } else if (idx->mode & EJDB_IDX_F64) {
-    kbuf[sz] = '\0';
     lv.type = JQVAL_F64;
-    lv.vf64 = (double) iwatof(kbuf);
+    if (idx->idbf & IWDB_REALNUM_KEYS) {
+      kbuf[sz] = '\0';
+      lv.vf64 = (double) iwatof(kbuf);
+    } else {
+      lv.vf64 = jbi_ikey_to_f64(kbuf);
+    }
   }
 
   ret = jql_match_jqval_pair(aux, &lv, expr->op, rv, &rc);
@@ -292,3 +349,95 @@ finish:
   *rcp = rc;
   return ret;
 }
+
+iwrc jbi_rsm_mark(struct _JBEXEC *ctx, IWKV_cursor cur, const IWKV_val *key, int64_t id) {
+  iwrc rc = 0;
+  size_t sz = 0;
+  struct _JBRSM *rsm = &ctx->rsm;
+  rsm->visited = false;
+  rsm->id = id;
+  rsm->keysz = 0;
+  if (cur) {
+    rc = iwkv_cursor_copy_key(cur, rsm->key, rsm->keyasz, &sz, 0);
+    RCRET(rc);
+  } else if (key) {
+    sz = key->size;
+  } else { // Collection scan, document id is the position
+    return 0;
+  }
+  if (sz > rsm->keyasz) {
+    size_t nsz = MAX(sz, 64);
+    uint8_t *nkey = realloc(rsm->key, nsz);
+    if (!nkey) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    rsm->key = nkey;
+    rsm->keyasz = nsz;
+    if (cur) {
+      rc = iwkv_cursor_copy_key(cur, rsm->key, rsm->keyasz, &sz, 0);
+      RCRET(rc);
+    }
+  }
+  if (!cur) {
+    memcpy(rsm->key, key->data, sz);
+  }
+  rsm->keysz = sz;
+  return rc;
+}
+
+iwrc jbi_rsm_cursor_open(struct _JBEXEC *ctx, IWDB db, IWKV_cursor_op step, bool advance,
+                         IWKV_cursor *curp, bool *eof) {
+  bool matched;
+  int64_t compound = 0;
+  struct _JBRSM *rsm = &ctx->rsm;
+  IWKV_val key;
+
+  *eof = false;
+  if (rsm->step != step) { // Token produced by scan in opposite direction
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  if (db == ctx->jbc->cdb) {
+    key.data = &rsm->after_id;
+    key.size = sizeof(rsm->after_id);
+    key.compound = 0;
+  } else {
+    key.data = rsm->after_key;
+    key.size = rsm->after_keysz;
+    key.compound = (ctx->midx.idx->idbf & IWDB_COMPOUND_KEYS) ? rsm->after_id : 0;
+  }
+  // Cursor is placed such that the next cursor `step` moves it
+  // to the first record following resume position.
+  iwrc rc = iwkv_cursor_open(db, curp, IWKV_CURSOR_GE, &key);
+  if (rc == IWKV_ERROR_NOTFOUND) { // All keys are less than resume position
+    if (*curp) {
+      iwkv_cursor_close(curp);
+    }
+    if (step == IWKV_CURSOR_PREV) {
+      *eof = true;
+      return 0;
+    }
+    rc = iwkv_cursor_open(db, curp, IWKV_CURSOR_BEFORE_FIRST, 0);
+  }
+  RCRET(rc);
+  if (step == IWKV_CURSOR_PREV) {
+    rc = iwkv_cursor_is_matched_key(*curp, &key, &matched, &compound);
+    RCRET(rc);
+    if (!matched || compound != key.compound) {
+      // Cursor stays at the first greater record which is not visited yet
+      rc = iwkv_cursor_to(*curp, IWKV_CURSOR_NEXT);
+      if (rc == IWKV_ERROR_NOTFOUND) {
+        iwkv_cursor_close(curp);
+        rc = iwkv_cursor_open(db, curp, IWKV_CURSOR_AFTER_LAST, 0);
+      }
+      RCRET(rc);
+    }
+  }
+  if (advance) {
+    rc = iwkv_cursor_to(*curp, step);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      *eof = true;
+      rc = 0;
+    }
+  }
+  return rc;
+}
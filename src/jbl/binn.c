@@ -394,7 +394,7 @@ BINN_PRIVATE unsigned char *SearchForID(unsigned char *p, int header_size, int s
 }
 
 BINN_PRIVATE unsigned char *SearchForKey(unsigned char *p, int header_size, int size, int numitems, const char *key,
-                                         int keylen) {
+                                         int keylen, BOOL nocase) {
   unsigned char len, *plimit, *base;
   int i;
 
@@ -409,7 +409,7 @@ BINN_PRIVATE unsigned char *SearchForKey(unsigned char *p, int header_size, int
     if (p > plimit) break;
     // Compare if the strings are equal.
     if (len > 0) {
-      if (strnicmp((char *) p, key, len) == 0) {  // note that there is no null terminator here
+      if ((nocase ? strnicmp((char *) p, key, len) : memcmp(p, key, len)) == 0) {  // note that there is no null terminator here
         if (keylen == len) {
           p += len;
           return p;
@@ -427,6 +427,69 @@ BINN_PRIVATE unsigned char *SearchForKey(unsigned char *p, int header_size, int
   return NULL;
 }
 
+// BINN_OBJECT_IDX container is followed by the directory of items offsets
+// sorted by case insensitive keys then by items positions.
+// Offsets are 16 bit wide if the container size fits into 16 bits, otherwise 32 bit wide.
+
+#define KEYS_DIR_WIDTH(size_) ((size_) > 0xFFFF ? 4 : 2)
+
+BINN_PRIVATE int KeyCaseCmp(const unsigned char *k1, int len1, const unsigned char *k2, int len2) {
+  int i, c1, c2, len = len1 < len2 ? len1 : len2;
+  for (i = 0; i < len; i++) {
+    c1 = (k1[i] >= 'A' && k1[i] <= 'Z') ? k1[i] + 32 : k1[i];
+    c2 = (k2[i] >= 'A' && k2[i] <= 'Z') ? k2[i] + 32 : k2[i];
+    if (c1 != c2) return c1 - c2;
+  }
+  return len1 - len2;
+}
+
+BINN_PRIVATE int KeysDirSize(const unsigned char *p, int size, int numitems) {
+  if (*p != BINN_OBJECT_IDX) return 0;
+  return numitems * KEYS_DIR_WIDTH(size);
+}
+
+BINN_PRIVATE int KeysDirOffset(const unsigned char *dir, int width, int pos) {
+  unsigned short int16;
+  int int32;
+  if (width == 2) {
+    memcpy(&int16, dir + 2 * pos, 2);
+    return frombe16(int16);
+  }
+  memcpy(&int32, dir + 4 * pos, 4);
+  return frombe32(int32);
+}
+
+BINN_PRIVATE unsigned char *SearchForKeyDir(unsigned char *p, int header_size, int size, int numitems, const char *key,
+                                            int keylen, BOOL nocase) {
+  int width = KEYS_DIR_WIDTH(size), lo = 0, hi = numitems, mid, off;
+  unsigned char *dir = p + size - numitems * width, *pkey;
+
+  if (dir < p + header_size) return NULL;
+  // lower bound of the key
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    off = KeysDirOffset(dir, width, mid);
+    pkey = p + off;
+    if ((off < header_size) || (pkey + *pkey >= dir)) return NULL;
+    if (KeyCaseCmp(pkey + 1, *pkey, (const unsigned char *) key, keylen) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // keys equal ignoring case are ordered by positions in the object
+  for ( ; lo < numitems; lo++) {
+    off = KeysDirOffset(dir, width, lo);
+    pkey = p + off;
+    if ((off < header_size) || (pkey + *pkey >= dir)) return NULL;
+    if (KeyCaseCmp(pkey + 1, *pkey, (const unsigned char *) key, keylen) != 0) break;
+    if (nocase || (memcmp(pkey + 1, key, keylen) == 0)) {
+      return pkey + 1 + *pkey;
+    }
+  }
+  return NULL;
+}
+
 BINN_PRIVATE BOOL AddValue(binn *item, int type, void *pvalue, int size);
 
 BINN_PRIVATE BOOL binn_list_add_raw(binn *item, int type, void *pvalue, int size) {
@@ -449,7 +512,7 @@ BINN_PRIVATE BOOL binn_object_set_raw(binn *item, const char *key, int keylen, i
     return FALSE;
 
   // is the key already in it?
-  p = SearchForKey(item->pbuf, MAX_BINN_HEADER, item->used_size, item->count, key, keylen);
+  p = SearchForKey(item->pbuf, MAX_BINN_HEADER, item->used_size, item->count, key, keylen, TRUE);
   if (p) return FALSE;
 
   // start adding it
@@ -839,6 +902,9 @@ BINN_PRIVATE BOOL IsValidBinnHeader(const void *pbuf, int *ptype, int *pcount, i
     case BINN_MAP:
     case BINN_OBJECT:
       break;
+    case BINN_OBJECT_IDX:
+      type = BINN_OBJECT;
+      break;
     default:
       return FALSE;
   }
@@ -886,6 +952,7 @@ binn *binn_copy(void *old) {
   binn *item;
   size = 0;
   if (!IsValidBinnHeader(old_ptr, &type, &count, &size, &header_size)) return NULL;
+  size -= KeysDirSize(old_ptr, size, count);  // keys directory is not copied into writable item
   item = binn_new(type, size - header_size + MAX_BINN_HEADER, NULL);
   if (item) {
     unsigned char *dest;
@@ -897,6 +964,199 @@ binn *binn_copy(void *old) {
   return item;
 }
 
+typedef struct {
+  unsigned char *buf;
+  int used;
+  int alloc;
+} KDBUF;
+
+typedef struct {
+  const unsigned char *key;
+  int len;
+  int off;
+} KDENTRY;
+
+BINN_PRIVATE BOOL KeysDirReserve(KDBUF *kb, int size) {
+  int alloc;
+  unsigned char *buf;
+  if (kb->used + size <= kb->alloc) return TRUE;
+  alloc = kb->alloc ? kb->alloc : 256;
+  while (alloc < kb->used + size) alloc *= 2;
+  buf = (unsigned char *) realloc_fn(kb->buf, alloc);
+  if (buf == NULL) return FALSE;
+  kb->buf = buf;
+  kb->alloc = alloc;
+  return TRUE;
+}
+
+BINN_PRIVATE int KeysDirEntryCmp(const void *v1, const void *v2) {
+  const KDENTRY *e1 = v1, *e2 = v2;
+  int ret = KeyCaseCmp(e1->key, e1->len, e2->key, e2->len);
+  return ret ? ret : e1->off - e2->off;
+}
+
+BINN_PRIVATE BOOL RewriteContainer(KDBUF *kb, unsigned char *ptr, const binn_rewrite_spec *spec) {
+  int type, count, size = 0, header_size, i, start, len, total, width = 2, sizelen, countlen, hsize, int32;
+  unsigned char *p, *pv, *pnext, *plimit, *w;
+  const unsigned char *key;
+  int keylen;
+  KDENTRY *entries = NULL;
+  unsigned short int16;
+  BOOL dir, ret = FALSE;
+
+  if (IsValidBinnHeader(ptr, &type, &count, &size, &header_size) == FALSE) return FALSE;
+  dir = (type == BINN_OBJECT) && (count > 0) && (spec->key_write == NULL)
+        && (spec->min_keys > 0) && (count >= spec->min_keys);
+  if (dir) {
+    entries = (KDENTRY *) binn_malloc(count * sizeof(KDENTRY));
+    if (entries == NULL) return FALSE;
+  }
+  // items are written after the space reserved for the largest header
+  start = kb->used;
+  if (KeysDirReserve(kb, MAX_BINN_HEADER) == FALSE) goto finish;
+  kb->used += MAX_BINN_HEADER;
+
+  p = ptr + header_size;
+  plimit = ptr + size;
+  for (i = 0; i < count; i++) {
+    pv = p;
+    if (type == BINN_OBJECT) {
+      if (dir) entries[i].off = kb->used - start - MAX_BINN_HEADER;
+      if (spec->key_read) {
+        pv = spec->key_read(p, plimit, &key, &keylen, spec->op);
+        if ((pv == NULL) || (keylen < 0) || (keylen > 255)) goto finish;
+      } else {
+        key = p + 1;
+        keylen = *p;
+        pv += 1 + keylen;
+      }
+      if (spec->key_read || spec->key_write) {
+        // object key is written in the target format, item value is handled below
+        if (KeysDirReserve(kb, BINN_REWRITE_KEY_MAX) == FALSE) goto finish;
+        if (spec->key_write) {
+          len = spec->key_write(key, keylen, kb->buf + kb->used, spec->op);
+          if ((len < 0) || (len > BINN_REWRITE_KEY_MAX)) goto finish;
+        } else {
+          kb->buf[kb->used] = (unsigned char) keylen;
+          memcpy(kb->buf + kb->used + 1, key, keylen);
+          len = 1 + keylen;
+        }
+        kb->used += len;
+        p = pv;
+      }
+    } else if (type == BINN_MAP) {
+      pv += 4;
+    }
+    if (pv >= plimit) goto finish;
+    pnext = AdvanceDataPos(pv, plimit);
+    if ((pnext == 0) || (pnext < pv)) goto finish;
+    if ((*pv & BINN_STORAGE_MASK) == BINN_STORAGE_CONTAINER) {
+      len = (int) (pv - p);
+      if (KeysDirReserve(kb, len) == FALSE) goto finish;
+      memcpy(kb->buf + kb->used, p, len);
+      kb->used += len;
+      if (RewriteContainer(kb, pv, spec) == FALSE) goto finish;
+    } else {
+      len = (int) (pnext - p);
+      if (KeysDirReserve(kb, len) == FALSE) goto finish;
+      memcpy(kb->buf + kb->used, p, len);
+      kb->used += len;
+    }
+    p = pnext;
+  }
+
+  len = kb->used - start - MAX_BINN_HEADER;
+  countlen = count > 127 ? 4 : 1;
+  total = 2 + countlen + len + (dir ? width * count : 0);
+  sizelen = total > 127 ? 4 : 1;
+  total += sizelen - 1;
+  if (dir && (total > 0xFFFF)) {
+    width = 4;
+    total += 2 * count;
+  }
+  hsize = 1 + sizelen + countlen;
+  memmove(kb->buf + start + hsize, kb->buf + start + MAX_BINN_HEADER, len);
+  kb->used = start + hsize + len;
+
+  // write the header
+  w = kb->buf + start;
+  *w++ = (unsigned char) (dir ? BINN_OBJECT_IDX : type);
+  if (sizelen == 4) {
+    int32 = tobe32(total | 0x80000000);
+    memcpy(w, &int32, 4);
+    w += 4;
+  } else {
+    *w++ = (unsigned char) total;
+  }
+  if (countlen == 4) {
+    int32 = tobe32(count | 0x80000000);
+    memcpy(w, &int32, 4);
+  } else {
+    *w = (unsigned char) count;
+  }
+
+  if (dir) {
+    if (KeysDirReserve(kb, width * count) == FALSE) goto finish;
+    for (i = 0; i < count; i++) {
+      entries[i].off += hsize;
+      entries[i].key = kb->buf + start + entries[i].off + 1;
+      entries[i].len = *(entries[i].key - 1);
+    }
+    qsort(entries, count, sizeof(KDENTRY), KeysDirEntryCmp);
+    w = kb->buf + kb->used;
+    for (i = 0; i < count; i++) {
+      if (width == 2) {
+        int16 = tobe16((unsigned short) entries[i].off);
+        memcpy(w, &int16, 2);
+      } else {
+        int32 = tobe32(entries[i].off);
+        memcpy(w, &int32, 4);
+      }
+      w += width;
+    }
+    kb->used += width * count;
+  }
+  ret = (kb->used - start == total);
+
+finish:
+  if (entries) free_fn(entries);
+  return ret;
+}
+
+BOOL APIENTRY binn_rewrite(void *ptr, const binn_rewrite_spec *spec, void **pbuf, int *palloc, int off, int *psize) {
+  KDBUF kb;
+  BOOL ret;
+  if ((ptr == NULL) || (spec == NULL) || (pbuf == NULL) || (palloc == NULL) || (off < 0) || (psize == NULL)) {
+    return FALSE;
+  }
+  kb.buf = *pbuf;
+  kb.alloc = *pbuf ? *palloc : 0;
+  kb.used = off;
+  if (KeysDirReserve(&kb, 0) == FALSE) return FALSE;
+  ret = RewriteContainer(&kb, ptr, spec);
+  // buffer may be reallocated even if rewriting is failed
+  *pbuf = kb.buf;
+  *palloc = kb.alloc;
+  if (ret) *psize = kb.used - off;
+  return ret;
+}
+
+void *APIENTRY binn_keys_dir_copy(void *ptr, int min_keys, int *psize) {
+  void *buf = NULL;
+  int alloc = 0;
+  binn_rewrite_spec spec = {
+    .min_keys = min_keys < 1 ? 1 : min_keys
+  };
+  ptr = binn_ptr(ptr);
+  if ((ptr == NULL) || (psize == NULL)) return NULL;
+  if (binn_rewrite(ptr, &spec, &buf, &alloc, 0, psize) == FALSE) {
+    if (buf) free_fn(buf);
+    return NULL;
+  }
+  return buf;
+}
+
+
 BOOL binn_is_valid_header(const void *pbuf, int *ptype, int *pcount, int *psize, int *pheadersize) {
   return IsValidBinnHeader(pbuf, ptype, pcount, psize, pheadersize);
 }
@@ -1115,7 +1375,7 @@ BINN_PRIVATE BOOL GetValue(unsigned char *p, binn *value) {
       break;
     case BINN_STORAGE_CONTAINER:
       value->ptr = p2;  // <-- it returns the pointer to the container, not the data
-      if (IsValidBinnHeader(p2, NULL, &value->count, &value->size, NULL) == FALSE) return FALSE;
+      if (IsValidBinnHeader(p2, &value->type, &value->count, &value->size, NULL) == FALSE) return FALSE;
       break;
     case BINN_STORAGE_STRING:
       datasz = *((unsigned char *) p);
@@ -1193,7 +1453,7 @@ BINN_PRIVATE void *store_value(binn *value) {
 
 /*** READ FUNCTIONS ********************************************************/
 
-BOOL APIENTRY binn_object_get_value(void *ptr, const char *key, binn *value) {
+BINN_PRIVATE BOOL binn_object_get_value_impl(void *ptr, const char *key, int keylen, BOOL nocase, binn *value) {
   int type, count, size = 0, header_size;
   unsigned char *p;
 
@@ -1207,11 +1467,25 @@ BOOL APIENTRY binn_object_get_value(void *ptr, const char *key, binn *value) {
   if (count == 0) return FALSE;
 
   p = (unsigned char *) ptr;
-  p = SearchForKey(p, header_size, size, count, key, strlen(key));
+  if (*p == BINN_OBJECT_IDX) {
+    p = SearchForKeyDir(p, header_size, size, count, key, keylen, nocase);
+  } else {
+    p = SearchForKey(p, header_size, size, count, key, keylen, nocase);
+  }
   if (p == FALSE) return FALSE;
   return GetValue(p, value);
 }
 
+BOOL APIENTRY binn_object_get_value(void *ptr, const char *key, binn *value) {
+  if (key == 0) return FALSE;
+  return binn_object_get_value_impl(ptr, key, strlen(key), TRUE, value);
+}
+
+BOOL APIENTRY binn_object_get_value2(void *ptr, const char *key, int keylen, binn *value) {
+  if ((key == 0) || (keylen < 0) || (keylen > 255)) return FALSE;
+  return binn_object_get_value_impl(ptr, key, keylen, FALSE, value);
+}
+
 BOOL APIENTRY binn_map_get_value(void *ptr, int id, binn *value) {
   int type, count, size = 0, header_size;
   unsigned char *p;
@@ -1258,6 +1532,44 @@ BOOL APIENTRY binn_list_get_value(void *ptr, int pos, binn *value) {
   return GetValue(p, value);
 }
 
+unsigned char *APIENTRY binn_object_value_at(void *ptr, const char *key, int keylen) {
+  int type, count, size = 0, header_size;
+  unsigned char *p;
+
+  ptr = binn_ptr(ptr);
+  if ((ptr == 0) || (key == 0) || (keylen < 0) || (keylen > 255)) return NULL;
+  if (IsValidBinnHeader(ptr, &type, &count, &size, &header_size) == FALSE) return NULL;
+  if ((type != BINN_OBJECT) || (count == 0)) return NULL;
+
+  p = (unsigned char *) ptr;
+  if (*p == BINN_OBJECT_IDX) {
+    return SearchForKeyDir(p, header_size, size, count, key, keylen, FALSE);
+  }
+  return SearchForKey(p, header_size, size, count, key, keylen, FALSE);
+}
+
+unsigned char *APIENTRY binn_list_value_at(void *ptr, int pos) {
+  int i, type, count, size = 0, header_size;
+  unsigned char *p, *plimit, *base;
+
+  ptr = binn_ptr(ptr);
+  if (ptr == 0) return NULL;
+  if (IsValidBinnHeader(ptr, &type, &count, &size, &header_size) == FALSE) return NULL;
+  if ((type != BINN_LIST) || (pos <= 0) || (pos > count)) return NULL;
+  pos--;  // convert from base 1 to base 0
+
+  p = (unsigned char *) ptr;
+  base = p;
+  plimit = p + size;
+  p += header_size;
+
+  for (i = 0; i < pos; i++) {
+    p = AdvanceDataPos(p, plimit);
+    if ((p == 0) || (p < base)) return NULL;
+  }
+  return p;
+}
+
 /*** READ PAIR BY POSITION *************************************************/
 
 BINN_PRIVATE BOOL binn_read_pair(int expected_type, void *ptr, int pos, int *pid, char *pkey, binn *value) {
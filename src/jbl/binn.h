@@ -120,6 +120,7 @@ typedef uint64_t uint64;
 #define BINN_LIST      0xE0
 #define BINN_MAP       0xE1
 #define BINN_OBJECT    0xE2
+#define BINN_OBJECT_IDX 0xE3  // Object followed by sorted keys directory, exposed to readers as BINN_OBJECT
 
 #define BINN_NULL      0x00
 #define BINN_TRUE      0x01
@@ -285,6 +286,31 @@ BOOL APIENTRY binn_create_object(binn *object);
 // create a new binn as a copy from another
 binn * APIENTRY binn_copy(void *old);
 
+// create a copy of serialized container where objects having at least `min_keys` keys
+// are stored as BINN_OBJECT_IDX with sorted keys directory. the result must be released by free_fn()
+void * APIENTRY binn_keys_dir_copy(void *ptr, int min_keys, int *psize);
+
+#define BINN_REWRITE_KEY_MAX 272  // max size of object key written by binn_rewrite_spec.key_write
+
+// serialized container rewriting options
+typedef struct binn_rewrite_spec {
+  // objects having at least `min_keys` keys are written with sorted keys directory (0 - no directories).
+  // directories are not written if `key_write` is set
+  int min_keys;
+  // reads object item key in custom format at `p`,
+  // returns pointer to the item value or NULL on error. if NULL standard binn keys are read
+  unsigned char * (*key_read)(unsigned char *p, unsigned char *plimit, const unsigned char **pkey, int *pkeylen,
+                              void *op);
+  // writes object item key in custom format into `out` having at least BINN_REWRITE_KEY_MAX bytes,
+  // returns number of bytes written or -1 on error. if NULL standard binn keys are written
+  int (*key_write)(const unsigned char *key, int keylen, unsigned char *out, void *op);
+  void *op;
+} binn_rewrite_spec;
+
+// rewrite serialized container into `*pbuf` (reallocated by realloc_fn() as needed) starting at `off`.
+// `*palloc` holds the allocated size of `*pbuf`. number of written bytes stored into `psize`
+BOOL APIENTRY binn_rewrite(void *ptr, const binn_rewrite_spec *spec, void **pbuf, int *palloc, int off, int *psize);
+
 BOOL APIENTRY binn_list_add_new(binn *list, binn *value);
 BOOL APIENTRY binn_map_set_new(binn *map, int id, binn *value);
 BOOL APIENTRY binn_object_set_new(binn *obj, const char *key, binn *value);
@@ -366,6 +392,12 @@ int    APIENTRY binn_count(void *ptr);
 int    APIENTRY binn_buf_count(const void *pbuf);
 BOOL   APIENTRY binn_is_valid_header(const void *pbuf, int *ptype, int *pcount, int *psize, int *pheadersize);
 
+// position of serialized value (its type byte) of object item `key` (case sensitive)
+// or list item `pos` (base 1) within container buffer, NULL if not found.
+// fixed size values may be rewritten in place at this position
+unsigned char * APIENTRY binn_object_value_at(void *ptr, const char *key, int keylen);
+unsigned char * APIENTRY binn_list_value_at(void *ptr, int pos);
+
 BOOL   APIENTRY binn_is_valid(void *ptr, int *ptype, int *pcount, int *psize);
 /* the function returns the values (type, count and size) and they don't need to be
    initialized. these values are read from the buffer. example:
@@ -455,6 +487,8 @@ binn *APIENTRY binn_object_value(void *obj, const char *key);
 BOOL APIENTRY binn_list_get_value(void *list, int pos, binn *value);
 BOOL APIENTRY binn_map_get_value(void *map, int id, binn *value);
 BOOL APIENTRY binn_object_get_value(void *obj, const char *key, binn *value);
+// case sensitive lookup of the key of given length
+BOOL APIENTRY binn_object_get_value2(void *obj, const char *key, int keylen, binn *value);
 
 // single interface - these functions check the data type
 BOOL APIENTRY binn_list_get(void *list, int pos, int type, void *pvalue, int *psize);
@@ -1134,7 +1134,59 @@ static jbl_visitor_cmd_t _jbl_get_visitor(int lvl, binn *bv, const char *key, in
   return JBL_VCMD_OK;
 }
 
+/**
+ * Resolves pointer without wildcards by direct lookup of every path node
+ * in parent container instead of visiting the whole document.
+ * Objects stored with sorted keys directory are searched in O(log n).
+ */
+static bool _jbl_at_direct(binn *bn, JBL_PTR jp, binn *res) {
+  binn bv[2];
+  binn *cur = bn;
+  for (int i = 0; i < jp->cnt; ++i) {
+    const char *key = jp->n[i];
+    binn *next = &bv[i & 1];
+    switch (cur->type) {
+      case BINN_OBJECT:
+        if (!binn_object_get_value2(cur, key, strlen(key), next)) {
+          return false;
+        }
+        break;
+      case BINN_LIST: {
+        int64_t idx = 0;
+        const char *kp = key;
+        if (*kp == '\0' || (*kp == '0' && kp[1] != '\0')) {
+          return false;
+        }
+        for ( ; *kp >= '0' && *kp <= '9' && idx <= INT_MAX; ++kp) {
+          idx = idx * 10 + (*kp - '0');
+        }
+        if (*kp != '\0' || idx >= INT_MAX || !binn_list_get_value(cur, (int) idx + 1, next)) {
+          return false;
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+    cur = next;
+  }
+  memcpy(res, cur, sizeof(*res));
+  return true;
+}
+
+IW_INLINE bool _jbl_ptr_has_wildcards(JBL_PTR jp) {
+  for (int i = 0; i < jp->cnt; ++i) {
+    if (jp->n[i][0] == '*' && jp->n[i][1] == '\0') {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool _jbl_at(JBL jbl, JBL_PTR jp, JBL res) {
+  if (jp->cnt > 0 && jbl->bn.type != BINN_MAP && !_jbl_ptr_has_wildcards(jp)) {
+    return _jbl_at_direct(&jbl->bn, jp, &res->bn);
+  }
   JBL_VCTX vctx = {
     .bn = &jbl->bn,
     .op = jp,
@@ -1146,6 +1198,20 @@ bool _jbl_at(JBL jbl, JBL_PTR jp, JBL res) {
 }
 
 iwrc jbl_at2(JBL jbl, JBL_PTR jp, JBL *res) {
+  if (jp->cnt > 0 && jbl->bn.type != BINN_MAP && !_jbl_ptr_has_wildcards(jp)) {
+    JBL jv = malloc(sizeof(struct _JBL));
+    if (!jv) {
+      *res = 0;
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    if (!_jbl_at_direct(&jbl->bn, jp, &jv->bn)) {
+      free(jv);
+      *res = 0;
+      return JBL_ERROR_PATH_NOTFOUND;
+    }
+    *res = jv;
+    return 0;
+  }
   JBL_VCTX vctx = {
     .bn = &jbl->bn,
     .op = jp,
@@ -2205,6 +2271,409 @@ iwrc jbl_patch_auto(JBL_NODE root, JBL_NODE patch, IWPOOL *pool) {
   return rc;
 }
 
+static int _jbl_merge_patch_ptrs_count(JBL_NODE patch) {
+  int cnt = 0;
+  for (JBL_NODE n = patch->child; n; n = n->next) {
+    if (n->type == JBV_OBJECT && n->child) {
+      cnt += _jbl_merge_patch_ptrs_count(n);
+    } else {
+      ++cnt;
+    }
+  }
+  return cnt;
+}
+
+static iwrc _jbl_merge_patch_ptrs(JBL_NODE patch, IWXSTR *xstr, JBL_PTR *ptrs, int *cnt, IWPOOL *pool) {
+  iwrc rc = 0;
+  size_t len = iwxstr_size(xstr);
+  for (JBL_NODE n = patch->child; n; n = n->next) {
+    rc = iwxstr_cat(xstr, "/", 1);
+    RCRET(rc);
+    for (int i = 0; i < n->klidx; ++i) { // Escape pointer node
+      char c = n->key[i];
+      if (c == '~') {
+        rc = iwxstr_cat(xstr, "~0", 2);
+      } else if (c == '/') {
+        rc = iwxstr_cat(xstr, "~1", 2);
+      } else {
+        rc = iwxstr_cat(xstr, &c, 1);
+      }
+      RCRET(rc);
+    }
+    if (n->type == JBV_OBJECT && n->child) {
+      rc = _jbl_merge_patch_ptrs(n, xstr, ptrs, cnt, pool);
+    } else {
+      rc = _jbl_ptr_pool(iwxstr_ptr(xstr), &ptrs[(*cnt)++], pool);
+    }
+    RCRET(rc);
+    iwxstr_pop(xstr, iwxstr_size(xstr) - len);
+  }
+  return rc;
+}
+
+static bool _jbl_ptr_is_array_pos(JBL_PTR ptr) {
+  if (ptr->cnt < 1) {
+    return false;
+  }
+  const char *s = ptr->n[ptr->cnt - 1];
+  if (!strcmp(s, "-")) {
+    return true;
+  }
+  for (; *s; ++s) {
+    if (!isdigit(*s)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static iwrc _jbl_patch_op_ptr(const char *path, bool structural, JBL_PTR *ptrs, int *cnt, IWPOOL *pool) {
+  JBL_PTR ptr;
+  iwrc rc = _jbl_ptr_pool(path, &ptr, pool);
+  RCRET(rc);
+  if (ptr->cnt == 1 && *ptr->n[0] == '\0') {
+    ptr->cnt = 0; // Root operation
+  } else if (structural && _jbl_ptr_is_array_pos(ptr)) {
+    // Array element insertion/removal shifts positions of its siblings
+    ptr->cnt--;
+  }
+  ptrs[(*cnt)++] = ptr;
+  return 0;
+}
+
+iwrc jbl_patch_auto_ptrs(JBL_NODE patch, JBL_PTR **ptrsp, int *cntp, IWPOOL *pool) {
+  if (!patch || !ptrsp || !cntp || !pool) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  iwrc rc = 0;
+  int cnt = 0;
+  JBL_PTR *ptrs;
+  *ptrsp = 0;
+  *cntp = 0;
+
+  if (patch->type == JBV_OBJECT) {
+    ptrs = iwpool_alloc(_jbl_merge_patch_ptrs_count(patch) * sizeof(*ptrs) + 1, pool);
+    if (!ptrs) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    IWXSTR *xstr = iwxstr_new();
+    if (!xstr) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    rc = _jbl_merge_patch_ptrs(patch, xstr, ptrs, &cnt, pool);
+    iwxstr_destroy(xstr);
+    RCRET(rc);
+  } else if (patch->type == JBV_ARRAY) {
+    int pcnt;
+    JBL_PATCH *p;
+    rc = _jbl_create_patch(patch, &p, &pcnt, pool);
+    RCRET(rc);
+    ptrs = iwpool_alloc(2 * pcnt * sizeof(*ptrs) + 1, pool);
+    if (!ptrs) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    for (int i = 0; i < pcnt; ++i) {
+      jbp_patch_t op = p[i].op;
+      if (op == JBP_TEST) {
+        continue;
+      }
+      bool structural = (op == JBP_ADD || op == JBP_REMOVE || op == JBP_COPY || op == JBP_MOVE);
+      rc = _jbl_patch_op_ptr(p[i].path, structural, ptrs, &cnt, pool);
+      RCRET(rc);
+      if (op == JBP_MOVE && p[i].from) {
+        rc = _jbl_patch_op_ptr(p[i].from, structural, ptrs, &cnt, pool);
+        RCRET(rc);
+      }
+    }
+  } else {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  *ptrsp = ptrs;
+  *cntp = cnt;
+  return rc;
+}
+
+/** Pending in-place write of serialized fixed size value */
+typedef struct _JBL_IPW {
+  uint8_t *pos;       /**< Position of value type byte */
+  uint8_t *dpos;      /**< Position of value data */
+  uint8_t type;       /**< New value type */
+  int size;           /**< Size of value data */
+  const void *data;   /**< String data or zero if `buf` is used */
+  uint8_t buf[8];     /**< Big-endian number data */
+} JBL_IPW;
+
+static int _jbl_ipw_num_size(uint8_t type) {
+  switch (type) {
+    case BINN_UINT8:
+    case BINN_INT8:
+      return 1;
+    case BINN_UINT16:
+    case BINN_INT16:
+      return 2;
+    case BINN_UINT32:
+    case BINN_INT32:
+    case BINN_FLOAT32:
+      return 4;
+    case BINN_UINT64:
+    case BINN_INT64:
+    case BINN_FLOAT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+/** Reads serialized number at `pos` into `n` */
+static bool _jbl_ipw_num_read(const uint8_t *pos, JBL_NODE n) {
+  uint64_t u = 0;
+  uint8_t type = *pos;
+  int sz = _jbl_ipw_num_size(type);
+  if (!sz) {
+    return false;
+  }
+  for (int i = 1; i <= sz; ++i) {
+    u = (u << 8) | pos[i];
+  }
+  n->type = JBV_I64;
+  switch (type) {
+    case BINN_INT8:
+      n->vi64 = (int8_t) u;
+      break;
+    case BINN_INT16:
+      n->vi64 = (int16_t) u;
+      break;
+    case BINN_INT32:
+      n->vi64 = (int32_t) u;
+      break;
+    case BINN_FLOAT32: {
+      uint32_t u32 = (uint32_t) u;
+      float f;
+      memcpy(&f, &u32, sizeof(f));
+      n->type = JBV_F64;
+      n->vf64 = f;
+      break;
+    }
+    case BINN_FLOAT64:
+      n->type = JBV_F64;
+      memcpy(&n->vf64, &u, sizeof(n->vf64));
+      break;
+    default:
+      n->vi64 = (int64_t) u;
+      break;
+  }
+  return true;
+}
+
+/**
+ * Plans write of `v` into serialized value at `pos`.
+ * Returns `false` if `v` cannot be stored without changing the value size.
+ */
+static bool _jbl_ipw_plan(uint8_t *pos, JBL_NODE v, JBL_IPW *w) {
+  uint64_t u;
+  uint8_t type = *pos;
+  int storage = type & BINN_STORAGE_MASK;
+  memset(w, 0, sizeof(*w));
+  w->pos = pos;
+  w->dpos = pos + 1;
+  if (type & BINN_STORAGE_HAS_MORE) {
+    return false;
+  }
+  switch (v->type) {
+    case JBV_NULL:
+    case JBV_BOOL:
+      if (storage != BINN_STORAGE_NOBYTES) {
+        return false;
+      }
+      w->type = v->type == JBV_NULL ? BINN_NULL : v->vbool ? BINN_TRUE : BINN_FALSE;
+      return true;
+    case JBV_I64: {
+      int64_t x = v->vi64;
+      w->size = _jbl_ipw_num_size(type);
+      switch (w->size) {
+        case 1:
+          w->type = (x >= 0 && x <= UINT8_MAX) ? BINN_UINT8 : (x >= INT8_MIN && x <= INT8_MAX) ? BINN_INT8 : 0;
+          break;
+        case 2:
+          w->type = (x >= 0 && x <= UINT16_MAX) ? BINN_UINT16 : (x >= INT16_MIN && x <= INT16_MAX) ? BINN_INT16 : 0;
+          break;
+        case 4:
+          w->type = (x >= 0 && x <= UINT32_MAX) ? BINN_UINT32 : (x >= INT32_MIN && x <= INT32_MAX) ? BINN_INT32 : 0;
+          break;
+        case 8:
+          w->type = BINN_INT64;
+          break;
+      }
+      if (!w->type) {
+        return false;
+      }
+      u = (uint64_t) x;
+      break;
+    }
+    case JBV_F64:
+      if (_jbl_ipw_num_size(type) != 8) {
+        return false;
+      }
+      w->type = BINN_FLOAT64;
+      w->size = 8;
+      memcpy(&u, &v->vf64, sizeof(u));
+      break;
+    case JBV_STR: {
+      int len = pos[1];
+      if (type != BINN_STRING) {
+        return false;
+      }
+      if (len & 0x80) {
+        len = (pos[1] << 24 | pos[2] << 16 | pos[3] << 8 | pos[4]) & 0x7FFFFFFF;
+        w->dpos = pos + 5;
+      } else {
+        w->dpos = pos + 2;
+      }
+      if (len != v->vsize) {
+        return false;
+      }
+      w->type = BINN_STRING;
+      w->size = len;
+      w->data = v->vptr;
+      return true;
+    }
+    default:
+      return false;
+  }
+  for (int i = w->size - 1; i >= 0; --i, u >>= 8) {
+    w->buf[i] = (uint8_t) u;
+  }
+  return true;
+}
+
+/** Finds serialized value at `ptr` path limited by `cnt` first nodes */
+static uint8_t *_jbl_ipw_find(uint8_t *root, JBL_PTR ptr, int cnt) {
+  uint8_t *p = root;
+  for (int i = 0; p && i < cnt; ++i) {
+    const char *n = ptr->n[i];
+    int type = binn_buf_type(p);
+    if (type == BINN_OBJECT) {
+      p = binn_object_value_at(p, n, (int) strlen(n));
+    } else if (type == BINN_LIST) {
+      char *ep;
+      long idx = strtol(n, &ep, 10);
+      if (!isdigit(*n) || (*n == '0' && n[1]) || *ep || idx >= INT_MAX) {
+        return 0;
+      }
+      p = binn_list_value_at(p, (int) idx + 1);
+    } else {
+      return 0;
+    }
+  }
+  return p;
+}
+
+static bool _jbl_ipw_merge(uint8_t *obj, JBL_NODE patch, JBL_IPW *w, int *cnt) {
+  for (JBL_NODE n = patch->child; n; n = n->next) {
+    uint8_t *pos = binn_object_value_at(obj, n->key, n->klidx);
+    if (!pos || n->type == JBV_NULL) { // Null removes member
+      return false;
+    }
+    if (n->type == JBV_OBJECT) {
+      if (binn_buf_type(pos) != BINN_OBJECT || !_jbl_ipw_merge(pos, n, w, cnt)) {
+        return false;
+      }
+    } else if (!_jbl_ipw_plan(pos, n, &w[*cnt])) {
+      return false;
+    } else {
+      ++(*cnt);
+    }
+  }
+  return true;
+}
+
+iwrc jbl_patch_auto_inplace(JBL jbl, JBL_NODE patch, IWPOOL *pool, bool *applied) {
+  if (!jbl || !patch || !pool || !applied) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  iwrc rc = 0;
+  int cnt = 0, wcnt = 0;
+  JBL_PATCH *p = 0;
+  uint8_t *root = jbl->bn.ptr;
+  *applied = false;
+
+  if (!root || jbl->bn.writable) {
+    return 0;
+  }
+  if (patch->type == JBV_OBJECT) {
+    if (binn_buf_type(root) != BINN_OBJECT) {
+      return 0;
+    }
+    cnt = _jbl_merge_patch_ptrs_count(patch);
+  } else if (patch->type == JBV_ARRAY) {
+    rc = _jbl_create_patch(patch, &p, &cnt, pool);
+    RCRET(rc);
+  } else {
+    return 0;
+  }
+
+  JBL_IPW *warr = iwpool_alloc((cnt + 1) * sizeof(*warr), pool);
+  if (!warr) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  if (p) {
+    for (int i = 0; i < cnt; ++i) {
+      JBL_PTR path;
+      uint8_t *pos;
+      struct _JBL_NODE inc;
+      JBL_NODE value = p[i].vnode;
+      jbp_patch_t op = p[i].op;
+      if (!value || !(op == JBP_REPLACE || op == JBP_ADD || op == JBP_INCREMENT)) {
+        return 0;
+      }
+      rc = _jbl_ptr_pool(p[i].path, &path, pool);
+      RCRET(rc);
+      if (path->cnt == 1 && *path->n[0] == '\0') { // Root
+        return 0;
+      }
+      if (op == JBP_ADD) { // Replaces existing object member but inserts array element
+        pos = _jbl_ipw_find(root, path, path->cnt - 1);
+        if (!pos || binn_buf_type(pos) != BINN_OBJECT) {
+          return 0;
+        }
+      }
+      pos = _jbl_ipw_find(root, path, path->cnt);
+      if (!pos) {
+        return 0;
+      }
+      if (op == JBP_INCREMENT) {
+        memset(&inc, 0, sizeof(inc));
+        if (!_jbl_ipw_num_read(pos, &inc) || _jbl_increment_node_data(&inc, value)) {
+          return 0;
+        }
+        value = &inc;
+      }
+      if (!_jbl_ipw_plan(pos, value, &warr[wcnt++])) {
+        return 0;
+      }
+    }
+  } else if (!_jbl_ipw_merge(root, patch, warr, &wcnt)) {
+    return 0;
+  }
+  for (int i = 0; i < wcnt; ++i) { // Planned writes are independent only if targets differ
+    for (int j = i + 1; j < wcnt; ++j) {
+      if (warr[i].pos == warr[j].pos) {
+        return 0;
+      }
+    }
+  }
+  for (int i = 0; i < wcnt; ++i) {
+    JBL_IPW *w = &warr[i];
+    *w->pos = w->type;
+    if (w->size) {
+      memcpy(w->dpos, w->data ? w->data : w->buf, w->size);
+    }
+  }
+  jbl->node = 0;
+  *applied = true;
+  return rc;
+}
+
 static const char *_jbl_ecodefn(locale_t locale, uint32_t ecode) {
   if (!(ecode > _JBL_ERROR_START && ecode < _JBL_ERROR_END)) {
     return 0;
@@ -610,6 +610,35 @@ IW_EXPORT iwrc jbn_visit(JBL_NODE node, int lvl, JBN_VCTX *vctx, JBN_VISITOR vis
 
 IW_EXPORT iwrc jbl_patch_auto(JBL_NODE root, JBL_NODE patch, IWPOOL *pool);
 
+/**
+ * @brief Collects JSON pointers to document parts which may be changed
+ * by `patch` accepted by `jbl_patch_auto()`.
+ * Every changed value is located at, below or above one of returned pointers.
+ * Pointer with zero nodes denotes the whole document.
+ *
+ * @param patch JSON patch or JSON merge patch
+ * @param [out] ptrsp Array of pointers allocated in `pool`
+ * @param [out] cntp Number of pointers in array
+ * @param pool Memory pool
+ */
+IW_EXPORT iwrc jbl_patch_auto_ptrs(JBL_NODE patch, JBL_PTR **ptrsp, int *cntp, IWPOOL *pool);
+
+/**
+ * @brief Applies `patch` accepted by `jbl_patch_auto()` directly to the serialized buffer of `jbl`
+ * without document tree conversion. Only replacements of existing numbers, booleans, nulls
+ * and strings of the same length as well as number increments are applied this way,
+ * provided that new values keep the size of stored ones.
+ *
+ * If `*applied` is `false` document buffer is left untouched and patch should be applied
+ * to document tree by `jbl_patch_auto()`.
+ *
+ * @param jbl Document loaded from writable buffer, eg. by `jbl_from_buf_keep_onstack()`
+ * @param patch JSON patch or JSON merge patch
+ * @param pool Memory pool used for temporary allocations
+ * @param [out] applied Set to `true` if patch was applied
+ */
+IW_EXPORT iwrc jbl_patch_auto_inplace(JBL jbl, JBL_NODE patch, IWPOOL *pool, bool *applied);
+
 IW_EXPORT iwrc jbl_patch_node(JBL_NODE root, const JBL_PATCH *patch, size_t cnt);
 
 IW_EXPORT iwrc jbl_patch(JBL jbl, const JBL_PATCH *patch, size_t cnt);
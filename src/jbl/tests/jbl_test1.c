@@ -709,6 +709,159 @@ void jbl_test1_8() {
   jbl_destroy(&nested);
 }
 
+void jbl_test1_9() {
+  // Wide object stored with sorted keys directory
+  IWXSTR *xstr = iwxstr_new();
+  IWXSTR *xstr2 = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr2);
+  iwxstr_cat2(xstr, "{");
+  for (int i = 199; i >= 0; --i) {
+    iwxstr_printf(xstr, "\"k%d\":%d,", i, i);
+  }
+  iwxstr_cat2(xstr, "\"nested\":{");
+  for (int i = 0; i < 20; ++i) {
+    iwxstr_printf(xstr, "\"n%d\":\"v%d\",", i, i);
+  }
+  iwxstr_cat2(xstr, "\"arr\":[1,2,{\"x\":3}]}}");
+
+  JBL jbl, at;
+  struct _JBL jbs;
+  void *buf, *kbuf;
+  size_t size;
+  int ksize;
+  binn bv;
+
+  iwrc rc = jbl_from_json(&jbl, iwxstr_ptr(xstr));
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_buf(jbl, &buf, &size);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  kbuf = binn_keys_dir_copy(buf, 8, &ksize);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(kbuf);
+  CU_ASSERT_EQUAL(*(unsigned char *) kbuf, BINN_OBJECT_IDX);
+  CU_ASSERT_TRUE(ksize > size);
+
+  rc = jbl_from_buf_keep_onstack(&jbs, kbuf, ksize);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbs.bn.type, BINN_OBJECT);
+  CU_ASSERT_EQUAL(jbl_count(&jbs), 201);
+
+  rc = jbl_at(&jbs, "/k150", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(at), 150);
+  jbl_destroy(&at);
+
+  rc = jbl_at(&jbs, "/nested/n7", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(jbl_get_str(at), "v7");
+  jbl_destroy(&at);
+
+  rc = jbl_at(&jbs, "/nested/arr/2/x", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(at), 3);
+  jbl_destroy(&at);
+
+  rc = jbl_at(&jbs, "/K150", &at);
+  CU_ASSERT_EQUAL(rc, JBL_ERROR_PATH_NOTFOUND);
+  rc = jbl_at(&jbs, "/k200", &at);
+  CU_ASSERT_EQUAL(rc, JBL_ERROR_PATH_NOTFOUND);
+  rc = jbl_at(&jbs, "/nested/arr/01", &at);
+  CU_ASSERT_EQUAL(rc, JBL_ERROR_PATH_NOTFOUND);
+
+  // Binn lookups are case insensitive
+  CU_ASSERT_TRUE(binn_object_get_value(kbuf, "K42", &bv));
+  CU_ASSERT_EQUAL(bv.vint32, 42);
+  CU_ASSERT_FALSE(binn_object_get_value2(kbuf, "K42", 3, &bv));
+
+  // Serialized JSON is not changed
+  iwxstr_clear(xstr);
+  rc = jbl_as_json(jbl, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(&jbs, jbl_xstr_json_printer, xstr2, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), iwxstr_ptr(xstr2));
+
+  free(kbuf);
+  jbl_destroy(&jbl);
+  iwxstr_destroy(xstr);
+  iwxstr_destroy(xstr2);
+}
+
+static void apply_patch_inplace(const char *data, const char *patch, const char *result, IWXSTR *xstr) {
+  JBL jbl;
+  JBL_NODE pn;
+  struct _JBL jbs;
+  void *buf;
+  size_t size;
+  bool applied;
+  char *data2 = iwu_replace_char(strdup(data), '\'', '"');
+  char *patch2 = iwu_replace_char(strdup(patch), '\'', '"');
+  IWPOOL *pool = iwpool_create(256);
+  CU_ASSERT_TRUE_FATAL(data2 && patch2 && pool);
+
+  iwrc rc = jbl_from_json(&jbl, data2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_buf(jbl, &buf, &size);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_from_buf_keep_onstack(&jbs, buf, size);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_node_from_json(patch2, &pn, pool);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_patch_auto_inplace(&jbs, pn, pool, &applied);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(applied, result != 0);
+
+  iwxstr_clear(xstr);
+  rc = jbl_as_json(&jbs, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  if (result) {
+    char *result2 = iwu_replace_char(strdup(result), '\'', '"');
+    CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), result2);
+    free(result2);
+  } else { // Document is not touched
+    CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), data2);
+  }
+  jbl_destroy(&jbl);
+  iwpool_destroy(pool);
+  free(data2);
+  free(patch2);
+}
+
+void jbl_test1_10() {
+  // Fixed size values patched directly in binn buffer
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  apply_patch_inplace("{'a':1,'b':'xyz','c':true}", "[{'op':'increment','path':'/a','value':5}]",
+                      "{'a':6,'b':'xyz','c':true}", xstr);
+  apply_patch_inplace("{'a':1,'b':'xyz','c':true}", "[{'op':'replace','path':'/b','value':'abc'},"
+                      "{'op':'add','path':'/c','value':null}]",
+                      "{'a':1,'b':'abc','c':null}", xstr);
+  apply_patch_inplace("{'a':{'b':[1,{'c':-1}]}}", "[{'op':'increment','path':'/a/b/1/c','value':-100},"
+                      "{'op':'replace','path':'/a/b/0','value':-2}]",
+                      "{'a':{'b':[-2,{'c':-101}]}}", xstr);
+  apply_patch_inplace("{'a':1.5,'n':{'x':true,'y':2}}", "{'a':2.25,'n':{'x':false}}",
+                      "{'a':2.25,'n':{'x':false,'y':2}}", xstr);
+  apply_patch_inplace("{'a':5000000000}", "[{'op':'replace','path':'/a','value':0.5}]",
+                      "{'a':0.5}", xstr);
+
+  // Stored value size is changed
+  apply_patch_inplace("{'a':255}", "[{'op':'increment','path':'/a','value':1}]", 0, xstr);
+  apply_patch_inplace("{'a':1}", "[{'op':'replace','path':'/a','value':1.5}]", 0, xstr);
+  apply_patch_inplace("{'b':'xyz'}", "[{'op':'replace','path':'/b','value':'xy'}]", 0, xstr);
+  apply_patch_inplace("{'a':[1,2]}", "[{'op':'add','path':'/a/0','value':1}]", 0, xstr);
+  apply_patch_inplace("{'a':1}", "{'a':null}", 0, xstr);
+  apply_patch_inplace("{'a':1}", "{'b':1}", 0, xstr);
+  // Operations other than replace and increment
+  apply_patch_inplace("{'a':1}", "[{'op':'test','path':'/a','value':1}]", 0, xstr);
+  apply_patch_inplace("{'a':[1,2]}", "[{'op':'remove','path':'/a/01'}]", 0, xstr);
+  // Same target updated twice
+  apply_patch_inplace("{'a':1}", "[{'op':'increment','path':'/a','value':1},"
+                      "{'op':'increment','path':'/a','value':1}]", 0, xstr);
+
+  iwxstr_destroy(xstr);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) return CU_get_error();
@@ -725,7 +878,9 @@ int main() {
     (NULL == CU_add_test(pSuite, "jbl_test1_5", jbl_test1_5)) ||
     (NULL == CU_add_test(pSuite, "jbl_test1_6", jbl_test1_6)) ||
     (NULL == CU_add_test(pSuite, "jbl_test1_7", jbl_test1_7)) ||
-    (NULL == CU_add_test(pSuite, "jbl_test1_8", jbl_test1_8))
+    (NULL == CU_add_test(pSuite, "jbl_test1_8", jbl_test1_8)) ||
+    (NULL == CU_add_test(pSuite, "jbl_test1_9", jbl_test1_9)) ||
+    (NULL == CU_add_test(pSuite, "jbl_test1_10", jbl_test1_10))
   ) {
     CU_cleanup_registry();
     return CU_get_error();
@@ -14,6 +14,7 @@
 #define JBR_MAX_KEY_LEN 36
 #define JBR_HTTP_CHUNK_SIZE 4096
 #define JBR_WS_STR_PREMATURE_END "Premature end of message"
+#define JBR_SUB_CHANNEL_BUFSZ 32
 
 static uint64_t k_header_x_access_token_hash;
 static uint64_t k_header_x_hints_hash;
@@ -37,6 +38,9 @@ struct _JBR {
   pthread_barrier_t start_barrier;
   const EJDB_HTTP *http;
   EJDB db;
+  pthread_mutex_t subs_mtx;       /**< Guards `subs` list */
+  struct _JBRSUB *subs;           /**< Websocket subscriptions to document changes */
+  volatile bool subs_listen;      /**< Database changes listener registered */
 };
 
 typedef struct _JBRCTX {
@@ -216,11 +220,22 @@ static void _jbr_on_query(JBRCTX *rctx) {
         goto finish;
       }
     }
+    if (strstr(hv.data, "resume")) {
+      ux.next = iwxstr_new();
+      if (!ux.next) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+    }
   }
 
   rc = ejdb_exec(&ux);
 
   if (!rc && rctx->wbuf) {
+    if (ux.next && iwxstr_size(ux.next)) {
+      rc = iwxstr_printf(rctx->wbuf, "\r\nresume\t%s", iwxstr_ptr(ux.next));
+      RCGO(rc, finish);
+    }
     rc = iwxstr_cat(rctx->wbuf, "\r\n", 2);
     RCGO(rc, finish);
     rc = _jbr_flush_chunk(rctx, true);
@@ -273,6 +288,9 @@ finish:
   if (ux.log) {
     iwxstr_destroy(ux.log);
   }
+  if (ux.next) {
+    iwxstr_destroy(ux.next);
+  }
   if (rctx->wbuf) {
     iwxstr_destroy(rctx->wbuf);
     rctx->wbuf = 0;
@@ -658,14 +676,34 @@ typedef enum {
   JBWS_IDX,
   JBWS_NIDX,
   JBWS_REMOVE_COLL,
+  JBWS_SUBSCRIBE,
+  JBWS_UNSUBSCRIBE,
 } jbwsop_t;
 
 typedef struct _JBWCTX {
   bool read_anon;
   EJDB db;
+  JBR jbr;
   ws_s *ws;
 } JBWCTX;
 
+/** Websocket subscription to changes of documents matched by query */
+typedef struct _JBRSUB {
+  JBWCTX *wctx;                         /**< Subscriber connection */
+  JQL q;                                /**< Documents filter query */
+  uintptr_t wsid;                       /**< Websocket pub/sub subscription id */
+  char key[JBR_MAX_KEY_LEN + 1];        /**< Subscription key */
+  char channel[JBR_SUB_CHANNEL_BUFSZ];  /**< Pub/sub channel of this subscription */
+  struct _JBRSUB *next;
+} JBRSUB;
+
+static void _jbr_sub_destroy(JBRSUB *sub) {
+  if (sub->q) {
+    jql_destroy(&sub->q);
+  }
+  free(sub);
+}
+
 IW_INLINE bool _jbr_ws_write_text(ws_s *ws, const char *data, int len) {
   if (fio_is_closed(websocket_uuid(ws)) || websocket_write(ws, (fio_str_info_s) {
   .data = (char *) data, .len = len
@@ -696,6 +734,23 @@ static void _jbr_ws_on_open(ws_s *ws) {
 static void _jbr_ws_on_close(intptr_t uuid, void *udata) {
   JBWCTX *wctx = udata;
   if (wctx) {
+    // Pub/sub subscriptions of closed websocket are released by facil
+    JBR jbr = wctx->jbr;
+    pthread_mutex_lock(&jbr->subs_mtx);
+    for (JBRSUB *sub = jbr->subs, *prev = 0, *next; sub; sub = next) {
+      next = sub->next;
+      if (sub->wctx == wctx) {
+        if (prev) {
+          prev->next = next;
+        } else {
+          jbr->subs = next;
+        }
+        _jbr_sub_destroy(sub);
+      } else {
+        prev = sub;
+      }
+    }
+    pthread_mutex_unlock(&jbr->subs_mtx);
     free(wctx);
   }
 }
@@ -1024,6 +1079,145 @@ static void _jbr_ws_remove_coll(JBWCTX *wctx, const char *key, const char *coll)
   }
 }
 
+// Called by the database thread delivering document changes
+static void _jbr_changes_listener(EJDB db, EJDB_CHANGE chg, void *op) {
+  JBR jbr = op;
+  iwrc rc = 0;
+  IWXSTR *jstr = 0, *wbuf = 0;
+  pthread_mutex_lock(&jbr->subs_mtx);
+  for (JBRSUB *sub = jbr->subs; sub; sub = sub->next) {
+    bool matched = false;
+    if (strcmp(jql_collection(sub->q), chg->coll)) {
+      continue;
+    }
+    rc = jql_matched(sub->q, chg->doc, &matched);
+    RCGO(rc, finish);
+    if (!matched) {
+      continue;
+    }
+    if (!wbuf) {
+      wbuf = iwxstr_new();
+      if (!wbuf) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      if (chg->op == EJDB_CHANGE_PUT) {
+        jstr = iwxstr_new2(chg->doc->bn.size * 2);
+        if (!jstr) {
+          rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+          goto finish;
+        }
+        rc = jbl_as_json(chg->doc, jbl_xstr_json_printer, jstr, 0);
+        RCGO(rc, finish);
+      }
+    } else {
+      iwxstr_clear(wbuf);
+    }
+    if (jstr) {
+      rc = iwxstr_printf(wbuf, "%s\tput\t%lld\t%s", sub->key, chg->id, iwxstr_ptr(jstr));
+    } else {
+      rc = iwxstr_printf(wbuf, "%s\tdel\t%lld", sub->key, chg->id);
+    }
+    RCGO(rc, finish);
+    fio_publish(.engine = FIO_PUBSUB_PROCESS,
+                .channel = { .data = sub->channel, .len = strlen(sub->channel) },
+                .message = { .data = iwxstr_ptr(wbuf), .len = iwxstr_size(wbuf) });
+  }
+
+finish:
+  pthread_mutex_unlock(&jbr->subs_mtx);
+  if (rc) {
+    iwlog_ecode_error3(rc);
+  }
+  if (jstr) {
+    iwxstr_destroy(jstr);
+  }
+  if (wbuf) {
+    iwxstr_destroy(wbuf);
+  }
+}
+
+static void _jbr_ws_subscribe(JBWCTX *wctx, const char *key, const char *coll, const char *query) {
+  JBR jbr = wctx->jbr;
+  JBRSUB *sub = calloc(1, sizeof(*sub));
+  if (!sub) {
+    _jbr_ws_send_rc(wctx, key, iwrc_set_errno(IW_ERROR_ALLOC, errno), 0);
+    return;
+  }
+  iwrc rc = jql_create2(&sub->q, coll, query, JQL_SILENT_ON_PARSE_ERROR | JQL_KEEP_QUERY_ON_PARSE_ERROR);
+  if (rc) {
+    iwrc rcs = rc;
+    iwrc_strip_code(&rcs);
+    if (rcs == JQL_ERROR_QUERY_PARSE) {
+      _jbr_ws_send_error(wctx, key, jql_error(sub->q), 0);
+    } else {
+      _jbr_ws_send_rc(wctx, key, rc, 0);
+    }
+    goto finish;
+  }
+  if (jql_has_apply(sub->q)) {
+    _jbr_ws_send_rc(wctx, key, JBR_ERROR_WS_INVALID_MESSAGE, "Subscription query cannot modify documents");
+    rc = JBR_ERROR_WS_INVALID_MESSAGE;
+    goto finish;
+  }
+  sub->wctx = wctx;
+  strcpy(sub->key, key);
+  snprintf(sub->channel, sizeof(sub->channel), "jbs:%" PRIxPTR, (uintptr_t) sub);
+
+  if (__sync_bool_compare_and_swap(&jbr->subs_listen, 0, 1)) {
+    // Listener is kept until database is closed
+    rc = ejdb_changes_subscribe(jbr->db, _jbr_changes_listener, jbr);
+    if (rc) {
+      jbr->subs_listen = false;
+      _jbr_ws_send_rc(wctx, key, rc, 0);
+      goto finish;
+    }
+  }
+  sub->wsid = websocket_subscribe(wctx->ws,
+                                  .channel = { .data = sub->channel, .len = strlen(sub->channel) },
+                                  .force_text = 1);
+  if (!sub->wsid) {
+    rc = IW_ERROR_FAIL;
+    _jbr_ws_send_rc(wctx, key, rc, 0);
+    goto finish;
+  }
+  pthread_mutex_lock(&jbr->subs_mtx);
+  sub->next = jbr->subs;
+  jbr->subs = sub;
+  pthread_mutex_unlock(&jbr->subs_mtx);
+  _jbr_ws_write_text(wctx->ws, key, strlen(key));
+
+finish:
+  if (rc) {
+    _jbr_sub_destroy(sub);
+  }
+}
+
+static void _jbr_ws_unsubscribe(JBWCTX *wctx, const char *key) {
+  JBR jbr = wctx->jbr;
+  JBRSUB *sub = 0;
+  pthread_mutex_lock(&jbr->subs_mtx);
+  for (JBRSUB *prev = 0, *s = jbr->subs; s; prev = s, s = s->next) {
+    if (s->wctx == wctx && !strcmp(s->key, key)) {
+      if (prev) {
+        prev->next = s->next;
+      } else {
+        jbr->subs = s->next;
+      }
+      sub = s;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&jbr->subs_mtx);
+  if (!sub) {
+    _jbr_ws_send_rc(wctx, key, IW_ERROR_NOT_EXISTS, 0);
+    return;
+  }
+  websocket_unsubscribe(wctx->ws, sub->wsid);
+  _jbr_sub_destroy(sub);
+  _jbr_ws_write_text(wctx->ws, key, strlen(key));
+}
+
 static void _jbr_ws_on_message(ws_s *ws, fio_str_info_s msg, uint8_t is_text) {
   if (!is_text) { // Do not serve binary requests
     websocket_close(ws);
@@ -1066,6 +1260,8 @@ static void _jbr_ws_on_message(ws_s *ws, fio_str_info_s msg, uint8_t is_text) {
       "\n<key> rmc     <collection>"
       "\n<key> query   <collection> <query>"
       "\n<key> explain <collection> <query>"
+      "\n<key> subscribe <collection> <query>"
+      "\n<key> unsubscribe"
       "\n<key> <query>"
       "\n";
     _jbr_ws_write_text(ws, help, strlen(help));
@@ -1121,6 +1317,10 @@ static void _jbr_ws_on_message(ws_s *ws, fio_str_info_s msg, uint8_t is_text) {
       wsop = JBWS_NIDX;
     } else if (!strncmp("rmc", data, pos)) {
       wsop = JBWS_REMOVE_COLL;
+    } else if (!strncmp("subscribe", data, pos)) {
+      wsop = JBWS_SUBSCRIBE;
+    } else if (!strncmp("unsubscribe", data, pos)) {
+      wsop = JBWS_UNSUBSCRIBE;
     }
   }
 
@@ -1129,6 +1329,9 @@ static void _jbr_ws_on_message(ws_s *ws, fio_str_info_s msg, uint8_t is_text) {
     if (wsop == JBWS_INFO) {
       _jbr_ws_info(wctx, key);
       return;
+    } else if (wsop == JBWS_UNSUBSCRIBE) {
+      _jbr_ws_unsubscribe(wctx, key);
+      return;
     }
 
     for (; pos < len && isspace(data[pos]); ++pos);
@@ -1178,6 +1381,10 @@ static void _jbr_ws_on_message(ws_s *ws, fio_str_info_s msg, uint8_t is_text) {
         data[len] = '\0';
         _jbr_ws_query(wctx, key, coll, data, (wsop == JBWS_EXPLAIN));
         break;
+      case JBWS_SUBSCRIBE:
+        data[len] = '\0';
+        _jbr_ws_subscribe(wctx, key, coll, data);
+        break;
       default: {
         char nbuf[JBNUMBUF_SIZE];
         for (pos = 0; pos < len && pos < JBNUMBUF_SIZE - 1 && isdigit(data[pos]); ++pos) {
@@ -1246,6 +1453,7 @@ static void _jbr_on_http_upgrade(http_s *req, char *requested_protocol, size_t l
     return;
   }
   wctx->db = jbr->db;
+  wctx->jbr = jbr;
 
   if (http->access_token) {
     FIOBJ h = fiobj_hash_get2(req->headers, k_header_x_access_token_hash);
@@ -1319,6 +1527,11 @@ static void *_jbr_start_thread(void *op) {
 
 static void _jbr_release(JBR *pjbr) {
   JBR jbr = *pjbr;
+  for (JBRSUB *sub = jbr->subs, *next; sub; sub = next) {
+    next = sub->next;
+    _jbr_sub_destroy(sub);
+  }
+  pthread_mutex_destroy(&jbr->subs_mtx);
   free(jbr);
   *pjbr = 0;
 }
@@ -1334,17 +1547,18 @@ iwrc jbr_start(EJDB db, const EJDB_OPTS *opts, JBR *pjbr) {
   jbr->db = db;
   jbr->terminated = true;
   jbr->http = &opts->http;
+  pthread_mutex_init(&jbr->subs_mtx, 0);
 
   if (!jbr->http->blocking) {
     int rci = pthread_barrier_init(&jbr->start_barrier, 0, 2);
     if (rci) {
-      free(jbr);
+      _jbr_release(&jbr);
       return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
     }
     rci = pthread_create(&jbr->worker_thread, 0, _jbr_start_thread, jbr);
     if (rci) {
       pthread_barrier_destroy(&jbr->start_barrier);
-      free(jbr);
+      _jbr_release(&jbr);
       return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
     }
     pthread_barrier_wait(&jbr->start_barrier);
@@ -1379,6 +1593,14 @@ iwrc jbr_shutdown(JBR *pjbr) {
       pthread_join(jbr->worker_thread, 0);
     }
   }
+  if (jbr->subs_listen) {
+    // Listener refers to `jbr` so it must be removed before `jbr` is freed
+    iwrc rc = ejdb_changes_unsubscribe(jbr->db, _jbr_changes_listener, jbr);
+    if (rc && rc != IW_ERROR_NOT_EXISTS) {
+      iwlog_ecode_error3(rc);
+    }
+    jbr->subs_listen = false;
+  }
   _jbr_release(pjbr);
   *pjbr = 0;
   return 0;
@@ -445,6 +445,17 @@ static JQPUNIT *_jqp_unit_op(yycontext *yy, const char *text) {
     unit->op.value = JQP_OP_NI;
   } else if (!strcmp(text, "re")) {
     unit->op.value = JQP_OP_RE;
+  } else if (!strcmp(text, "fts")) {
+    unit->op.value = JQP_OP_FTS;
+  } else if (!strcmp(text, "ieq")) {
+    unit->op.value = JQP_OP_EQ;
+    unit->op.icase = true;
+  } else if (!strcmp(text, "iin")) {
+    unit->op.value = JQP_OP_IN;
+    unit->op.icase = true;
+  } else if (!strcmp(text, "ire")) {
+    unit->op.value = JQP_OP_RE;
+    unit->op.icase = true;
   } else {
     iwlog_error("Invalid operation: %s", text);
     JQRC(yy, JQL_ERROR_QUERY_PARSE);
@@ -761,6 +772,56 @@ static void _jqp_add_orderby(yycontext *yy, JQPUNIT *unit) {
   }
 }
 
+static void _jqp_add_groupby(yycontext *yy, JQPUNIT *unit) {
+  JQP_AUX *aux = yy->aux;
+  if (unit->type != JQP_STRING_TYPE) {
+    iwlog_error("Unexpected type for group by: %d", unit->type);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  if (!aux->groupby) {
+    aux->groupby = &unit->string;
+  } else {
+    JQP_STRING *gb = aux->groupby;
+    while (gb->next) gb = gb->next;
+    gb->next = &unit->string;
+  }
+}
+
+static void _jqp_add_aggregate(yycontext *yy, JQPUNIT *unit) {
+  JQP_AUX *aux = yy->aux;
+  char *fn = _jqp_string_pop(yy);
+  if (unit->type != JQP_STRING_TYPE) {
+    iwlog_error("Unexpected type for aggregate: %d", unit->type);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  JQP_AGGREGATE *ag = iwpool_calloc(sizeof(*ag), aux->pool);
+  if (!ag) {
+    JQRC(yy, iwrc_set_errno(IW_ERROR_ALLOC, errno));
+  }
+  if (!strcmp(fn, "sum")) {
+    ag->fn = JQP_AGGR_SUM;
+  } else if (!strcmp(fn, "min")) {
+    ag->fn = JQP_AGGR_MIN;
+  } else if (!strcmp(fn, "max")) {
+    ag->fn = JQP_AGGR_MAX;
+  } else if (!strcmp(fn, "avg")) {
+    ag->fn = JQP_AGGR_AVG;
+  } else if (!strcmp(fn, "distinct")) {
+    ag->fn = JQP_AGGR_DISTINCT;
+  } else {
+    iwlog_error("Unknown aggregate function: %s", fn);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  ag->value = &unit->string;
+  if (!aux->aggregates) {
+    aux->aggregates = ag;
+  } else {
+    JQP_AGGREGATE *a = aux->aggregates;
+    while (a->next) a = a->next;
+    a->next = ag;
+  }
+}
+
 static void _jqp_set_skip(yycontext *yy, JQPUNIT *unit) {
   JQP_AUX *aux = yy->aux;
   if (unit->type != JQP_INTEGER_TYPE && !(unit->type == JQP_STRING_TYPE
@@ -787,6 +848,18 @@ static void _jqp_set_limit(yycontext *yy, JQPUNIT *unit) {
   aux->limit = unit;
 }
 
+static void _jqp_set_after(yycontext *yy, JQPUNIT *unit) {
+  JQP_AUX *aux = yy->aux;
+  if (unit->type != JQP_STRING_TYPE) {
+    iwlog_error("Unexpected type for after: %d", unit->type);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  if (aux->after) {
+    JQRC(yy, JQL_ERROR_AFTER_ALREADY_SET);
+  }
+  aux->after = unit;
+}
+
 static void _jqp_set_aggregate_count(yycontext *yy) {
   JQP_AUX *aux = yy->aux;
   aux->qmode |= JQP_QRY_COUNT;
@@ -817,6 +890,64 @@ static void _jqp_set_projection(yycontext *yy, JQPUNIT *unit) {
   }
 }
 
+/**
+ * Builds JSON pointer from chain of path nodes linked by `subnext`.
+ */
+static iwrc _jqp_ptr_alloc(JQP_AUX *aux, IWXSTR *xstr, JQP_STRING *nodes, JBL_PTR *ptrp) {
+  iwrc rc = 0;
+  iwxstr_clear(xstr);
+  for (JQP_STRING *on = nodes; on; on = on->subnext) {
+    rc = iwxstr_cat(xstr, "/", 1);
+    RCRET(rc);
+    rc = iwxstr_cat(xstr, on->value, strlen(on->value));
+    RCRET(rc);
+  }
+  return jbl_ptr_alloc_pool(iwxstr_ptr(xstr), ptrp, aux->pool);
+}
+
+static iwrc _jqp_finish_group(JQP_AUX *aux, IWXSTR *xstr) {
+  iwrc rc = 0;
+  int cnt = 0;
+  if (aux->orderby || aux->apply || aux->apply_placeholder || aux->projection || aux->after
+      || (aux->qmode & JQP_QRY_APPLY_DEL)) {
+    return JQL_ERROR_INVALID_AGGREGATE;
+  }
+  aux->qmode |= JQP_QRY_GROUP;
+  if (aux->qmode & JQP_QRY_COUNT) {
+    // `count` turns into aggregate of every group
+    JQP_AGGREGATE *ag = iwpool_calloc(sizeof(*ag), aux->pool);
+    if (!ag) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    ag->fn = JQP_AGGR_COUNT;
+    ag->next = aux->aggregates;
+    aux->aggregates = ag;
+    aux->qmode &= ~JQP_QRY_COUNT;
+  }
+  for (JQP_STRING *gb = aux->groupby; gb; gb = gb->next) {
+    ++cnt;
+  }
+  if (cnt) {
+    aux->groupby_ptrs = iwpool_alloc(cnt * sizeof(JBL_PTR), aux->pool);
+    if (!aux->groupby_ptrs) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    cnt = 0;
+    for (JQP_STRING *gb = aux->groupby; gb; gb = gb->next) {
+      rc = _jqp_ptr_alloc(aux, xstr, gb, &aux->groupby_ptrs[cnt++]);
+      RCRET(rc);
+    }
+  }
+  aux->groupby_num = cnt;
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next) {
+    if (ag->value) {
+      rc = _jqp_ptr_alloc(aux, xstr, ag->value, &ag->ptr);
+      RCRET(rc);
+    }
+  }
+  return rc;
+}
+
 static void _jqp_finish(yycontext *yy) {
   iwrc rc = 0;
   int cnt = 0;
@@ -831,33 +962,33 @@ static void _jqp_finish(yycontext *yy) {
     }
   }
   aux->orderby_num = cnt;
+  if (cnt || aux->groupby || aux->aggregates) {
+    xstr = iwxstr_new();
+    if (!xstr) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      RCGO(rc, finish);
+    }
+  }
   if (cnt) {
     aux->orderby_ptrs = iwpool_alloc(cnt * sizeof(JBL_PTR), aux->pool);
     if (!aux->orderby_ptrs) {
       rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
       goto finish;
     }
-    xstr = iwxstr_new();
-    if (!xstr) {
-      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-      RCGO(rc, finish);
-    }
     cnt = 0;
     orderby = aux->orderby;
     for (; orderby; orderby = orderby->next) {
-      iwxstr_clear(xstr);
-      for (JQP_STRING *on = orderby; on; on = on->subnext) {
-        rc = iwxstr_cat(xstr, "/", 1);
-        RCGO(rc, finish);
-        iwxstr_cat(xstr, on->value, strlen(on->value));
-      }
-      rc = jbl_ptr_alloc_pool(iwxstr_ptr(xstr), &aux->orderby_ptrs[cnt], aux->pool);
+      rc = _jqp_ptr_alloc(aux, xstr, orderby, &aux->orderby_ptrs[cnt]);
       RCGO(rc, finish);
       JBL_PTR ptr = aux->orderby_ptrs[cnt];
       ptr->op = (uint64_t) ((orderby->flavour & JQP_STR_NEGATE) != 0); // asc/desc
       cnt++;
     }
   }
+  if (aux->groupby || aux->aggregates) {
+    rc = _jqp_finish_group(aux, xstr);
+    RCGO(rc, finish);
+  }
 
 finish:
   if (xstr) {
@@ -865,6 +996,7 @@ finish:
   }
   if (rc) {
     aux->orderby_num = 0;
+    aux->groupby_num = 0;
     JQRC(yy, rc);
   }
 }
@@ -1016,6 +1148,30 @@ static iwrc _jqp_print_apply(const JQP_QUERY *q, jbl_json_printer pt, void *op)
   return rc;
 }
 
+static iwrc _jqp_print_icase_op(const JQP_OP *jqop, jbl_json_printer pt, void *op) {
+  iwrc rc = 0;
+  PT(0, 0, ' ', 1);
+  if (jqop->negate) {
+    PT("not ", 4, 0, 0);
+  }
+  switch (jqop->value) {
+    case JQP_OP_EQ:
+      PT("ieq ", 4, 0, 0);
+      break;
+    case JQP_OP_IN:
+      PT("iin ", 4, 0, 0);
+      break;
+    case JQP_OP_RE:
+      PT("ire ", 4, 0, 0);
+      break;
+    default:
+      iwlog_ecode_error3(IW_ERROR_ASSERTION);
+      rc = IW_ERROR_ASSERTION;
+      break;
+  }
+  return rc;
+}
+
 static iwrc _jqp_print_join(jqp_op_t jqop, bool negate, jbl_json_printer pt, void *op) {
   iwrc rc = 0;
   PT(0, 0, ' ', 1);
@@ -1061,6 +1217,9 @@ static iwrc _jqp_print_join(jqp_op_t jqop, bool negate, jbl_json_printer pt, voi
     case JQP_OP_RE:
       PT("re", 2, 0, 0);
       break;
+    case JQP_OP_FTS:
+      PT("fts", 3, 0, 0);
+      break;
     default:
       iwlog_ecode_error3(IW_ERROR_ASSERTION);
       rc = IW_ERROR_ASSERTION;
@@ -1099,7 +1258,11 @@ iwrc jqp_print_filter_node_expr(const JQP_EXPR *e, jbl_json_printer pt, void *op
     iwlog_ecode_error3(IW_ERROR_ASSERTION);
     return IW_ERROR_ASSERTION;
   }
-  rc = _jqp_print_join(e->op->value, e->op->negate, pt, op);
+  if (e->op->icase) {
+    rc = _jqp_print_icase_op(e->op, pt, op);
+  } else {
+    rc = _jqp_print_join(e->op->value, e->op->negate, pt, op);
+  }
   RCRET(rc);
   if (e->right->type == JQP_STRING_TYPE) {
     if (e->right->string.flavour & JQP_STR_PLACEHOLDER) {
@@ -1143,6 +1306,15 @@ static iwrc _jqp_print_filter_node(const JQP_NODE *n, jbl_json_printer pt, void
   return rc;
 }
 
+iwrc jqp_print_filter(const JQP_FILTER *f, jbl_json_printer pt, void *op) {
+  iwrc rc = 0;
+  for (JQP_NODE *n = f->node; n; n = n->next) {
+    rc = _jqp_print_filter_node(n, pt, op);
+    RCRET(rc);
+  }
+  return rc;
+}
+
 static iwrc _jqp_print_filter(const JQP_QUERY *q,
                               const JQP_FILTER *f,
                               jbl_json_printer pt,
@@ -1152,11 +1324,7 @@ static iwrc _jqp_print_filter(const JQP_QUERY *q,
     PT(0, 0, '@', 1);
     PT(f->anchor, -1, 0, 0);
   }
-  for (JQP_NODE *n = f->node; n; n = n->next) {
-    rc = _jqp_print_filter_node(n, pt, op);
-    RCRET(rc);
-  }
-  return rc;
+  return jqp_print_filter(f, pt, op);
 }
 
 static iwrc _jqp_print_expression_node(const JQP_QUERY *q,
@@ -1189,6 +1357,25 @@ static iwrc _jqp_print_expression_node(const JQP_QUERY *q,
   return rc;
 }
 
+const char *jqp_aggregate_name(jqp_aggr_t fn) {
+  switch (fn) {
+    case JQP_AGGR_COUNT:
+      return "count";
+    case JQP_AGGR_SUM:
+      return "sum";
+    case JQP_AGGR_MIN:
+      return "min";
+    case JQP_AGGR_MAX:
+      return "max";
+    case JQP_AGGR_AVG:
+      return "avg";
+    case JQP_AGGR_DISTINCT:
+      return "distinct";
+    default:
+      return "";
+  }
+}
+
 static iwrc _jqp_print_opts(const JQP_QUERY *q, jbl_json_printer pt, void *op) {
   iwrc rc = 0;
   int c = 0;
@@ -1217,7 +1404,36 @@ static iwrc _jqp_print_opts(const JQP_QUERY *q, jbl_json_printer pt, void *op) {
     }
     ob = ob->next;
   }
-  if (aux->skip || aux->limit) {
+  JQP_STRING *gb = aux->groupby;
+  while (gb) {
+    if (c++ > 0) {
+      PT("\n ", 2, 0, 0);
+    }
+    PT(" group ", 7, 0, 0);
+    JQP_STRING *n = gb;
+    do {
+      PT(0, 0, '/', 1);
+      PT(n->value, -1, 0, 0);
+    } while ((n = n->subnext));
+    gb = gb->next;
+  }
+  for (JQP_AGGREGATE *ag = aux->aggregates; ag; ag = ag->next) {
+    if (ag->fn == JQP_AGGR_COUNT) {
+      continue;
+    }
+    if (c++ > 0) {
+      PT("\n ", 2, 0, 0);
+    }
+    PT(0, 0, ' ', 1);
+    PT(jqp_aggregate_name(ag->fn), -1, 0, 0);
+    PT(0, 0, ' ', 1);
+    JQP_STRING *n = ag->value;
+    do {
+      PT(0, 0, '/', 1);
+      PT(n->value, -1, 0, 0);
+    } while ((n = n->subnext));
+  }
+  if (aux->skip || aux->limit || aux->after) {
     if (c > 0) {
       PT("\n ", 2, 0, 0);
     }
@@ -1252,6 +1468,17 @@ static iwrc _jqp_print_opts(const JQP_QUERY *q, jbl_json_printer pt, void *op) {
       PT(nbuf, -1, 0, 0);
     }
   }
+  if (aux->after) {
+    PT(" after ", 7, 0, 0);
+    if (aux->after->string.flavour & JQP_STR_PLACEHOLDER) {
+      rc = _print_placeholder(aux->after->string.value, pt, op);
+      RCRET(rc);
+    } else {
+      PT(0, 0, '"', 1);
+      PT(aux->after->string.value, -1, 0, 0);
+      PT(0, 0, '"', 1);
+    }
+  }
   return rc;
 }
 
@@ -1273,7 +1500,7 @@ iwrc jqp_print_query(const JQP_QUERY *q, jbl_json_printer pt, void *op) {
     rc = _jqp_print_projection(aux->projection, pt, op);
     RCRET(rc);
   }
-  if (aux->skip || aux->limit || aux->orderby) {
+  if (aux->skip || aux->limit || aux->after || aux->orderby || aux->groupby || aux->aggregates) {
     PT(0, 0, '\n', 1);
     rc = _jqp_print_opts(q, pt, op);
   }
@@ -6,8 +6,65 @@
 #include "jbl_internal.h"
 #include "jql_internal.h"
 #include "convert.h"
+#include "khash.h"
+#include "ftstok.h"
 #include <errno.h>
 
+/** Minimal size of homogeneous `in` array to be matched using hash set */
+#define JQL_INOP_HASH_MIN_SIZE 16
+
+KHASH_SET_INIT_INT64(JQI64S)
+KHASH_SET_INIT_STR(JQSTRS)
+
+/** Compiled expression of `re` operator with required literals extracted */
+typedef struct JQREGEX {
+  struct re *rx;
+  bool rx_owned;              /**< Regexp is owned by this structure */
+  size_t match_end;           /**< Expression length if it ended with `$` */
+  bool literal;               /**< Whole expression is a plain literal stored as `prefix` */
+  const char *prefix;         /**< Literal every matched input starts with */
+  size_t prefix_len;
+  const char *infix;          /**< Longest literal required to be in matched input after prefix */
+  size_t infix_len;
+} JQREGEX;
+
+/** Term of `fts` operator query */
+typedef struct JQFTS_TERM {
+  const char *term;           /**< Case folded term */
+  size_t len;
+  int clause;                 /**< Clause number: single term or phrase */
+  bool prefix;                /**< Term matches any word starting with it */
+  bool first;                 /**< First term of clause */
+  bool last;                  /**< Last term of clause */
+  bool active;                /**< Clause matched up to this term by the last seen words */
+} JQFTS_TERM;
+
+/** Compiled query of `fts` operator */
+typedef struct JQFTS {
+  IWPOOL *pool;
+  JQFTS_TERM *terms;
+  bool *cmatched;             /**< Clauses matched in the currently processed text */
+  int nterms;
+  int nclauses;
+  int nmatched;               /**< Number of matched clauses */
+  int iterm;                  /**< Term used to lookup full text index or `-1` */
+} JQFTS;
+
+/** Case folded right value of `ieq`, `iin`, `ire` operators */
+typedef struct JQICASE {
+  IWPOOL *pool;
+  JQVAL rv;
+} JQICASE;
+
+/** Hash set built over right side array of `in` operator */
+typedef struct JQINSET {
+  jbl_type_t type;            /**< JBV_I64 | JBV_STR or JBV_NONE if array is not hashable */
+  union {
+    khash_t(JQI64S) *si64;
+    khash_t(JQSTRS) *sstr;
+  };
+} JQINSET;
+
 /** Query matching context */
 typedef struct MCTX {
   int lvl;
@@ -34,6 +91,48 @@ typedef struct MFCTX {
 
 static JQP_NODE *_jql_match_node(MCTX *mctx, JQP_NODE *n, bool *res, iwrc *rcp);
 
+static void _jql_regexp_destroy(JQREGEX *jr);
+
+IW_INLINE void _jql_fts_destroy(JQFTS *jf) {
+  if (jf) {
+    iwpool_destroy(jf->pool);
+  }
+}
+
+static void _jql_inset_destroy(JQINSET *set) {
+  if (!set) return;
+  if (set->type == JBV_I64) {
+    kh_destroy(JQI64S, set->si64);
+  } else if (set->type == JBV_STR) {
+    kh_destroy(JQSTRS, set->sstr);
+  }
+  free(set);
+}
+
+/**
+ * Drop cached `in` operator hash sets, compiled regexps, `fts` queries
+ * and case folded values since they
+ * may refer to placeholder values which are going to be changed.
+ */
+static void _jql_reset_op_caches(JQP_AUX *aux) {
+  for (JQP_OP *op = aux->start_op; op; op = op->next) {
+    if (op->opaque_icase) {
+      iwpool_destroy(((JQICASE *) op->opaque_icase)->pool);
+      op->opaque_icase = 0;
+    }
+    if (op->opaque) {
+      if (op->value == JQP_OP_IN) {
+        _jql_inset_destroy(op->opaque);
+      } else if (op->value == JQP_OP_RE) {
+        _jql_regexp_destroy(op->opaque);
+      } else if (op->value == JQP_OP_FTS) {
+        _jql_fts_destroy(op->opaque);
+      }
+      op->opaque = 0;
+    }
+  }
+}
+
 IW_INLINE void _jql_jqval_destroy(JQP_STRING *pv) {
   JQVAL *qv = pv->opaque;
   if (qv) {
@@ -74,6 +173,7 @@ static JQVAL *_jql_find_placeholder(JQL q, const char *name) {
 
 static iwrc _jql_set_placeholder(JQL q, const char *placeholder, int index, JQVAL *val) {
   JQP_AUX *aux = q->aux;
+  _jql_reset_op_caches(aux);
   if (!placeholder) { // Index
     char nbuf[JBNUMBUF_SIZE];
     iwitoa(index, nbuf, JBNUMBUF_SIZE);
@@ -347,6 +447,7 @@ void jql_reset(JQL q, bool reset_match_cache, bool reset_placeholders) {
   JQP_AUX *aux = q->aux;
   _jql_reset_expression_node(aux->expr, aux, reset_match_cache);
   if (reset_placeholders) {
+    _jql_reset_op_caches(aux);
     for (JQP_STRING *pv = aux->start_placeholder; pv; pv = pv->placeholder_next) { // Cleanup placeholders
       _jql_jqval_destroy(pv);
     }
@@ -363,13 +464,7 @@ void jql_destroy(JQL *qptr) {
     for (JQP_STRING *pv = aux->start_placeholder; pv; pv = pv->placeholder_next) { // Cleanup placeholders
       _jql_jqval_destroy(pv);
     }
-    for (JQP_OP *op = aux->start_op; op; op = op->next) {
-      if (op->opaque) {
-        if (op->value == JQP_OP_RE) {
-          lwre_free(op->opaque);
-        }
-      }
-    }
+    _jql_reset_op_caches(aux);
     jqp_aux_destroy(&aux);
   }
   *qptr = 0;
@@ -628,35 +723,160 @@ int jql_cmp_jqval_pair(const JQVAL *left, const JQVAL *right, iwrc *rcp) {
   return _jql_cmp_jqval_pair(left, right, rcp);
 }
 
-static bool _jql_match_regexp(JQP_AUX *aux,
-                              JQVAL *left, JQP_OP *jqop, JQVAL *right,
-                              iwrc *rcp) {
-  struct re *rx;
-  char nbuf[JBNUMBUF_SIZE];
-  static_assert(JBNUMBUF_SIZE >= IWFTOA_BUFSIZE, "JBNUMBUF_SIZE >= IWFTOA_BUFSIZE");
-  JQVAL sleft, sright; // Stack allocated left/right converted values
-  JQVAL *lv = left, *rv = right;
-  char *input = 0;
-  size_t rci, match_end = 0;
-  const char *expr = 0;
-  bool match_start = false;
+/**
+ * Skips `(...)`, `{...}` group or `[...]` character class
+ * starting at `p`. Returns pointer to the next char after group or zero if group is not terminated.
+ */
+static const char *_jql_regexp_skip_group(const char *p) {
+  int depth = 0;
+  while (*p) {
+    switch (*p) {
+      case '\\':
+        if (p[1]) ++p;
+        break;
+      case '[':
+        for (++p; *p && *p != ']'; ++p) {
+          if (*p == '\\' && p[1]) ++p;
+        }
+        if (!*p) return 0;
+        if (!depth) return p + 1;
+        break;
+      case '(':
+      case '{':
+        ++depth;
+        break;
+      case ')':
+      case '}':
+        if (--depth == 0) return p + 1;
+        break;
+      default:
+        if (!depth) return p + 1;
+        break;
+    }
+    ++p;
+  }
+  return 0;
+}
 
-  if (lv->type == JQVAL_JBLNODE) {
-    _jql_node_to_jqval(lv->vnode, &sleft);
-    lv = &sleft;
-  } else if (lv->type == JQVAL_BINN) {
-    _jql_binn_to_jqval(lv->vbinn, &sleft);
-    lv = &sleft;
+/**
+ * Extracts literals required to be in any input matched by `expr`.
+ * Since regexp matching is anchored at the start of input the leading literal
+ * of expression is a prefix of any matched input.
+ */
+static void _jql_regexp_literals(const char *expr, JQREGEX *jr, char *pbuf, char *ibuf) {
+  const char *p = expr;
+  char *rbuf = pbuf;       // Current literal run buffer
+  size_t rlen = 0;         // Current literal run length
+  bool prefix = true;      // Current run is the expression prefix
+  bool literal = true;     // Whole expression is literal
+
+  jr->prefix = pbuf;
+  jr->infix = ibuf;
+  jr->prefix_len = 0;
+  jr->infix_len = 0;
+
+#define _FINISH_RUN()                                  \
+  if (prefix) {                                        \
+    jr->prefix_len = rlen;                             \
+    prefix = false;                                    \
+    rbuf = ibuf + jr->infix_len + 1;                   \
+  } else if (rlen > jr->infix_len) {                   \
+    memmove(ibuf, rbuf, rlen);                         \
+    jr->infix_len = rlen;                              \
+    rbuf = ibuf + rlen + 1;                            \
+  }                                                    \
+  rlen = 0
+
+  while (*p) {
+    char c = *p;
+    switch (c) {
+      case '|':
+      case ')':
+      case '}':
+      case '>':
+      case '?':
+      case '*':
+      case '+':
+        // Alternation or unexpected chars, no literals can be safely extracted
+        jr->prefix_len = 0;
+        jr->infix_len = 0;
+        jr->literal = false;
+        return;
+      case '.':
+      case '[':
+      case '(':
+      case '{':
+        literal = false;
+        _FINISH_RUN();
+        if (c == '.') {
+          ++p;
+        } else {
+          p = _jql_regexp_skip_group(p);
+          if (!p) {
+            jr->prefix_len = 0;
+            jr->infix_len = 0;
+            jr->literal = false;
+            return;
+          }
+        }
+        if (*p == '?' || *p == '*' || *p == '+') {
+          ++p;
+          if (*p == '?') ++p;
+        }
+        continue;
+      case '\\':
+        if (p[1]) {
+          c = *++p;
+        }
+      // fall through
+      default:
+        ++p;
+        break;
+    }
+    if (*p == '?' || *p == '*') { // Optional char
+      literal = false;
+      _FINISH_RUN();
+      ++p;
+      if (*p == '?') ++p;
+    } else if (*p == '+') {       // Char is required at least once
+      literal = false;
+      rbuf[rlen++] = c;
+      _FINISH_RUN();
+      ++p;
+      if (*p == '?') ++p;
+    } else {
+      rbuf[rlen++] = c;
+    }
   }
-  if (lv->type >= JQVAL_JBLNODE) {
-    *rcp = _JQL_ERROR_UNMATCHED;
-    return false;
+  _FINISH_RUN();
+  pbuf[jr->prefix_len] = '\0';
+  ibuf[jr->infix_len] = '\0';
+  jr->literal = literal;
+
+#undef _FINISH_RUN
+}
+
+static void _jql_regexp_destroy(JQREGEX *jr) {
+  if (!jr) return;
+  if (jr->rx_owned) {
+    lwre_free(jr->rx);
+  }
+  free(jr);
+}
+
+static JQREGEX *_jql_regexp_get(JQP_AUX *aux, JQP_OP *jqop, JQVAL *right, iwrc *rcp) {
+  JQREGEX *jr = jqop->opaque;
+  if (jr) {
+    return jr;
   }
+  char nbuf[JBNUMBUF_SIZE];
+  JQVAL sright;
+  JQVAL *rv = right;
+  const char *expr = 0;
+  size_t rci, match_end = 0;
 
-  if (jqop->opaque) {
-    rx = jqop->opaque;
-  } else if (right->type == JQVAL_RE) {
-    rx = right->vre;
+  if (right->type == JQVAL_RE) {
+    expr = right->vre->expression;
   } else {
     if (rv->type == JQVAL_JBLNODE) {
       _jql_node_to_jqval(rv->vnode, &sright);
@@ -669,15 +889,14 @@ static bool _jql_match_regexp(JQP_AUX *aux,
       case JQVAL_I64: {
         iwitoa(rv->vi64, nbuf, JBNUMBUF_SIZE);
         expr = iwpool_strdup(aux->pool, nbuf, rcp);
-        if (*rcp) return false;
+        if (*rcp) return 0;
         break;
       }
       case JQVAL_F64: {
         size_t osz;
-        char nbuf[JBNUMBUF_SIZE];
         jbi_ftoa(rv->vf64, nbuf, &osz);
         expr = iwpool_strdup(aux->pool, nbuf, rcp);
-        if (*rcp) return false;
+        if (*rcp) return 0;
         break;
       }
       case JQVAL_BOOL:
@@ -685,33 +904,227 @@ static bool _jql_match_regexp(JQP_AUX *aux,
         break;
       default:
         *rcp = _JQL_ERROR_UNMATCHED;
-        return false;
+        return 0;
     }
-
     assert(expr);
-    if (expr[0] == '^') {
+    if (expr[0] == '^') { // Implied, lwre matches from the input start
       expr += 1;
-      match_start = true;
     }
     rci = strlen(expr);
     if (rci && expr[rci - 1] == '$') {
       char *aexpr = iwpool_alloc(rci, aux->pool);
       if (!aexpr) {
         *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-        return false;
+        return 0;
       }
       match_end = rci - 1;
       memcpy(aexpr, expr, match_end);
       aexpr[rci - 1] = '\0';
       expr = aexpr;
     }
-    rx = lwre_new(expr);
-    if (!rx) {
+  }
+
+  rci = strlen(expr) + 1;
+  jr = malloc(sizeof(*jr) + 2 * rci);
+  if (!jr) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return 0;
+  }
+  jr->match_end = match_end;
+  if (right->type == JQVAL_RE) {
+    jr->rx = right->vre;
+    jr->rx_owned = false;
+  } else {
+    jr->rx = lwre_new(expr);
+    if (!jr->rx) {
       *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-      return false;
+      free(jr);
+      return 0;
+    }
+    jr->rx_owned = true;
+  }
+  char *pbuf = (char *) (jr + 1);
+  _jql_regexp_literals(expr, jr, pbuf, pbuf + rci);
+  jqop->opaque = jr;
+  return jr;
+}
+
+static char *_jql_icase_fold(const char *str, size_t len, bool regexp, IWPOOL *pool, iwrc *rcp) {
+  char *out = iwpool_alloc(len + 1, pool);
+  if (!out) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return 0;
+  }
+  if (!regexp) {
+    ftstok_casefold(str, len, out);
+    return out;
+  }
+  // Keep escaped characters of regexp as is, eg: `\W`
+  char *wp = out;
+  const char *rp = str, *ep = str + len;
+  while (rp < ep) {
+    const char *sp = rp;
+    while (rp < ep && *rp != '\\') ++rp;
+    wp += ftstok_casefold(sp, rp - sp, wp);
+    if (rp < ep) {
+      *wp++ = *rp++;
+      if (rp < ep) *wp++ = *rp++;
+    }
+  }
+  *wp = '\0';
+  return out;
+}
+
+static JQVAL *_jql_icase_right(JQP_OP *jqop, JQVAL *right, iwrc *rcp) {
+  JQICASE *ic = jqop->opaque_icase;
+  if (ic) {
+    return &ic->rv;
+  }
+  bool regexp = (jqop->value == JQP_OP_RE);
+  IWPOOL *pool = iwpool_create(128);
+  if (!pool) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return 0;
+  }
+  ic = iwpool_calloc(sizeof(*ic), pool);
+  if (!ic) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  ic->pool = pool;
+  ic->rv = *right;
+  ic->rv.freefn = 0;
+  ic->rv.freefn_op = 0;
+  JQVAL *rv = &ic->rv;
+  if (rv->type == JQVAL_JBLNODE && rv->vnode->type != JBV_ARRAY) {
+    _jql_node_to_jqval(rv->vnode, rv);
+  }
+  switch (rv->type) {
+    case JQVAL_STR:
+      rv->vstr = _jql_icase_fold(rv->vstr, strlen(rv->vstr), regexp, pool, rcp);
+      break;
+    case JQVAL_RE:
+      rv->type = JQVAL_STR;
+      rv->vstr = _jql_icase_fold(right->vre->expression, strlen(right->vre->expression), true, pool, rcp);
+      break;
+    case JQVAL_JBLNODE: { // Shallow copy of array with folded string elements
+      JBL_NODE arr = iwpool_alloc(sizeof(*arr), pool), last = 0;
+      if (!arr) {
+        *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        break;
+      }
+      memcpy(arr, rv->vnode, sizeof(*arr));
+      arr->child = 0;
+      for (JBL_NODE n = rv->vnode->child; n; n = n->next) {
+        JBL_NODE nn = iwpool_alloc(sizeof(*nn), pool);
+        if (!nn) {
+          *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+          break;
+        }
+        memcpy(nn, n, sizeof(*nn));
+        nn->parent = arr;
+        nn->next = 0;
+        nn->prev = last;
+        if (nn->type == JBV_STR) {
+          nn->vptr = _jql_icase_fold(n->vptr, n->vsize, false, pool, rcp);
+          if (!nn->vptr) break;
+          nn->vsize = (int) strlen(nn->vptr);
+        }
+        if (last) {
+          last->next = nn;
+        } else {
+          arr->child = nn;
+        }
+        last = nn;
+      }
+      rv->vnode = arr;
+      break;
     }
-    jqop->opaque = rx;
+    default:
+      break;
   }
+
+finish:
+  if (*rcp) {
+    iwpool_destroy(pool);
+    return 0;
+  }
+  jqop->opaque_icase = ic;
+  return &ic->rv;
+}
+
+JQVAL *jql_icase_jqval(JQP_OP *jqop, JQVAL *right, iwrc *rcp) {
+  if (!jqop->icase) {
+    return right;
+  }
+  return _jql_icase_right(jqop, right, rcp);
+}
+
+/**
+ * Converts left value of case insensitive operation to scalar and folds it if it is a string.
+ * Folded string is placed into `buf` if it fits, otherwise into allocated `*bufp`.
+ */
+static JQVAL *_jql_icase_left(JQVAL *left, JQVAL *fleft, char *buf, size_t bufsz, char **bufp, iwrc *rcp) {
+  if (left->type == JQVAL_JBLNODE) {
+    _jql_node_to_jqval(left->vnode, fleft);
+  } else if (left->type == JQVAL_BINN) {
+    _jql_binn_to_jqval(left->vbinn, fleft);
+  } else {
+    *fleft = *left;
+  }
+  if (fleft->type != JQVAL_STR) {
+    return fleft;
+  }
+  size_t len = strlen(fleft->vstr);
+  if (len >= bufsz) {
+    buf = malloc(len + 1);
+    if (!buf) {
+      *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      return 0;
+    }
+    *bufp = buf;
+  }
+  ftstok_casefold(fleft->vstr, len, buf);
+  fleft->vstr = buf;
+  return fleft;
+}
+
+const char *jql_regexp_prefix(JQP_AUX *aux, JQP_OP *jqop, JQVAL *right, size_t *lenp, iwrc *rcp) {
+  *lenp = 0;
+  if (jqop->icase) {
+    right = _jql_icase_right(jqop, right, rcp);
+    if (!right) return 0;
+  }
+  JQREGEX *jr = _jql_regexp_get(aux, jqop, right, rcp);
+  if (!jr) return 0;
+  *lenp = jr->prefix_len;
+  return jr->prefix;
+}
+
+static bool _jql_match_regexp(JQP_AUX *aux,
+                              JQVAL *left, JQP_OP *jqop, JQVAL *right,
+                              iwrc *rcp) {
+  char nbuf[JBNUMBUF_SIZE];
+  static_assert(JBNUMBUF_SIZE >= IWFTOA_BUFSIZE, "JBNUMBUF_SIZE >= IWFTOA_BUFSIZE");
+  JQVAL sleft; // Stack allocated left converted value
+  JQVAL *lv = left;
+  char *input = 0;
+
+  if (lv->type == JQVAL_JBLNODE) {
+    _jql_node_to_jqval(lv->vnode, &sleft);
+    lv = &sleft;
+  } else if (lv->type == JQVAL_BINN) {
+    _jql_binn_to_jqval(lv->vbinn, &sleft);
+    lv = &sleft;
+  }
+  if (lv->type >= JQVAL_JBLNODE) {
+    *rcp = _JQL_ERROR_UNMATCHED;
+    return false;
+  }
+
+  JQREGEX *jr = _jql_regexp_get(aux, jqop, right, rcp);
+  if (!jr) return false;
+  struct re *rx = jr->rx;
   assert(rx);
 
   switch (lv->type) {
@@ -724,7 +1137,6 @@ static bool _jql_match_regexp(JQP_AUX *aux,
       break;
     case JQVAL_F64: {
       size_t osz;
-      char nbuf[JBNUMBUF_SIZE];
       jbi_ftoa(lv->vf64, nbuf, &osz);
       input = nbuf;
     }
@@ -738,6 +1150,18 @@ static bool _jql_match_regexp(JQP_AUX *aux,
   }
 
   assert(input);
+  // Prefilter input using literals extracted from expression
+  if (jr->prefix_len && strncmp(input, jr->prefix, jr->prefix_len)) {
+    return false;
+  }
+  if (jr->literal) {
+    // Plain literal expression, no need to run regexp engine
+    return jr->prefix_len && (!jr->match_end || input[jr->prefix_len] == '\0');
+  }
+  if (jr->infix_len && !strstr(input + jr->prefix_len, jr->infix)) {
+    return false;
+  }
+
   int mret = lwre_match(rx, input);
   switch (mret) {
     case RE_ERROR_NOMATCH:
@@ -760,15 +1184,65 @@ static bool _jql_match_regexp(JQP_AUX *aux,
       return false;
   }
   if (mret > 0) {
-    if (match_start && rx->position - mret != input) {
-      return false;
+    // Matches of lwre always start at the input start and `mret` is the match length,
+    // so `^` is implied and `$` requires the match to reach the end of input
+    return !jr->match_end || input[mret] == '\0';
+  }
+  return false;
+}
+
+/**
+ * Builds hash set over `in` array if all its elements
+ * are of the same `int` or `string` type. Otherwise returned
+ * set type is `JBV_NONE` and linear scan should be used.
+ */
+static JQINSET *_jql_inset_create(JBL_NODE arr, iwrc *rcp) {
+  int cnt = 0;
+  jbl_type_t type = JBV_NONE;
+  JQINSET *set = calloc(1, sizeof(*set));
+  if (!set) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return 0;
+  }
+  for (JBL_NODE n = arr->child; n; n = n->next, ++cnt) {
+    if (n->type != JBV_I64 && n->type != JBV_STR) {
+      return set;
     }
-    if (match_end && rx->position != input + match_end) {
-      return false;
+    if (!type) {
+      type = n->type;
+    } else if (n->type != type) {
+      return set;
     }
-    return true;
   }
-  return false;
+  if (cnt < JQL_INOP_HASH_MIN_SIZE) {
+    return set;
+  }
+  int rci;
+  if (type == JBV_I64) {
+    set->si64 = kh_init(JQI64S);
+    if (!set->si64) goto alloc_error;
+    set->type = type;
+    if (kh_resize(JQI64S, set->si64, cnt) < 0) goto alloc_error;
+    for (JBL_NODE n = arr->child; n; n = n->next) {
+      kh_put(JQI64S, set->si64, n->vi64, &rci);
+      if (rci < 0) goto alloc_error;
+    }
+  } else {
+    set->sstr = kh_init(JQSTRS);
+    if (!set->sstr) goto alloc_error;
+    set->type = type;
+    if (kh_resize(JQSTRS, set->sstr, cnt) < 0) goto alloc_error;
+    for (JBL_NODE n = arr->child; n; n = n->next) {
+      kh_put(JQSTRS, set->sstr, n->vptr, &rci);
+      if (rci < 0) goto alloc_error;
+    }
+  }
+  return set;
+
+alloc_error:
+  *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  _jql_inset_destroy(set);
+  return 0;
 }
 
 static bool _jql_match_in(JQVAL *left, JQP_OP *jqop, JQVAL *right,
@@ -776,7 +1250,7 @@ static bool _jql_match_in(JQVAL *left, JQP_OP *jqop, JQVAL *right,
 
   JQVAL sleft; // Stack allocated left/right converted values
   JQVAL *lv = left, *rv = right;
-  if (rv->type != JQVAL_JBLNODE && rv->vnode->type != JBV_ARRAY) {
+  if (rv->type != JQVAL_JBLNODE || rv->vnode->type != JBV_ARRAY) {
     *rcp = _JQL_ERROR_UNMATCHED;
     return false;
   }
@@ -787,6 +1261,17 @@ static bool _jql_match_in(JQVAL *left, JQP_OP *jqop, JQVAL *right,
     _jql_binn_to_jqval(lv->vbinn, &sleft);
     lv = &sleft;
   }
+  JQINSET *set = jqop->opaque;
+  if (!set) {
+    set = _jql_inset_create(rv->vnode, rcp);
+    if (*rcp) return false;
+    jqop->opaque = set;
+  }
+  if (set->type == JBV_I64 && lv->type == JQVAL_I64) {
+    return kh_get(JQI64S, set->si64, lv->vi64) != kh_end(set->si64);
+  } else if (set->type == JBV_STR && lv->type == JQVAL_STR) {
+    return kh_get(JQSTRS, set->sstr, lv->vstr) != kh_end(set->sstr);
+  }
   for (JBL_NODE n = rv->vnode->child; n; n = n->next) {
     JQVAL qv = {
       .type = JQVAL_JBLNODE,
@@ -842,11 +1327,225 @@ static bool _jql_match_ni(JQVAL *left, JQP_OP *jqop, JQVAL *right,
   return false;
 }
 
+/** Query parsing context of `fts` operator */
+struct _JQFTS_PCTX {
+  JQFTS *jf;
+  const char *ep;             /**< End of currently parsed query segment */
+  bool phrase;                /**< Segment is double quoted phrase */
+  bool phrase_start;          /**< Next term starts a new phrase */
+  iwrc rc;
+};
+
+static bool _jql_fts_parse_visitor(const FTSTOK *tok, void *op) {
+  struct _JQFTS_PCTX *pctx = op;
+  JQFTS *jf = pctx->jf;
+  if (!jf->terms) { // Counting pass
+    ++jf->nterms;
+    return true;
+  }
+  JQFTS_TERM *t = &jf->terms[jf->nterms];
+  t->term = iwpool_strdup(jf->pool, tok->term, &pctx->rc);
+  if (!t->term) {
+    return false;
+  }
+  t->len = tok->len;
+  t->prefix = tok->end < pctx->ep && *tok->end == '*';
+  t->first = !pctx->phrase || pctx->phrase_start;
+  if (t->first) {
+    t->clause = jf->nclauses++;
+  } else {
+    t->clause = t[-1].clause;
+    t[-1].last = false;
+  }
+  t->last = true;
+  pctx->phrase_start = false;
+  ++jf->nterms;
+  return true;
+}
+
+/**
+ * Parses `fts` query: whitespace separated words, which all should be present in text.
+ * Word ended with `*` is a prefix, words within double quotes is a phrase.
+ */
+static JQFTS *_jql_fts_get(JQP_OP *jqop, JQVAL *right, iwrc *rcp) {
+  JQFTS *jf = jqop->opaque;
+  if (jf) {
+    return jf;
+  }
+  JQVAL sright;
+  JQVAL *rv = right;
+  if (rv->type == JQVAL_JBLNODE) {
+    _jql_node_to_jqval(rv->vnode, &sright);
+    rv = &sright;
+  }
+  if (rv->type != JQVAL_STR) {
+    *rcp = _JQL_ERROR_UNMATCHED;
+    return 0;
+  }
+  IWPOOL *pool = iwpool_create(256);
+  if (!pool) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return 0;
+  }
+  jf = iwpool_calloc(sizeof(*jf), pool);
+  if (!jf) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    iwpool_destroy(pool);
+    return 0;
+  }
+  jf->pool = pool;
+  jf->iterm = -1;
+
+  struct _JQFTS_PCTX pctx = {.jf = jf};
+  for (int pass = 0; pass < 2; ++pass) {
+    const char *sp = rv->vstr;
+    pctx.phrase = false;
+    if (pass) {
+      jf->terms = iwpool_calloc(jf->nterms * sizeof(*jf->terms) + 1, pool);
+      if (!jf->terms) {
+        pctx.rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      jf->nterms = 0;
+    }
+    while (*sp) {
+      pctx.ep = strchr(sp, '"');
+      if (!pctx.ep) {
+        pctx.ep = sp + strlen(sp);
+      }
+      pctx.phrase_start = true;
+      ftstok_tokenize(sp, pctx.ep - sp, _jql_fts_parse_visitor, &pctx);
+      RCGO(pctx.rc, finish);
+      sp = *pctx.ep ? pctx.ep + 1 : pctx.ep;
+      pctx.phrase = !pctx.phrase;
+    }
+  }
+  jf->cmatched = iwpool_calloc(jf->nclauses * sizeof(*jf->cmatched) + 1, pool);
+  if (!jf->cmatched) {
+    pctx.rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  // Select the most selective term for index lookup
+  for (int i = 0; i < jf->nterms; ++i) {
+    JQFTS_TERM *t = &jf->terms[i];
+    if (jf->iterm < 0) {
+      jf->iterm = i;
+    } else {
+      JQFTS_TERM *it = &jf->terms[jf->iterm];
+      if ((it->prefix && !t->prefix) || (it->prefix == t->prefix && t->len > it->len)) {
+        jf->iterm = i;
+      }
+    }
+  }
+
+finish:
+  if (pctx.rc) {
+    *rcp = pctx.rc;
+    iwpool_destroy(pool);
+    return 0;
+  }
+  jqop->opaque = jf;
+  return jf;
+}
+
+const char *jql_fts_term(JQP_OP *jqop, JQVAL *right, bool *prefixp, iwrc *rcp) {
+  *prefixp = false;
+  JQFTS *jf = _jql_fts_get(jqop, right, rcp);
+  if (!jf || jf->iterm < 0) {
+    if (*rcp == _JQL_ERROR_UNMATCHED) {
+      *rcp = 0;
+    }
+    return 0;
+  }
+  *prefixp = jf->terms[jf->iterm].prefix;
+  return jf->terms[jf->iterm].term;
+}
+
+static bool _jql_fts_match_visitor(const FTSTOK *tok, void *op) {
+  JQFTS *jf = op;
+  // Iterate backward, so `active` flag of preceding term relates to the previous word
+  for (int i = jf->nterms - 1; i >= 0; --i) {
+    JQFTS_TERM *t = &jf->terms[i];
+    t->active = (t->first || t[-1].active)
+                && (t->prefix ? tok->len >= t->len : tok->len == t->len)
+                && !memcmp(tok->term, t->term, t->len);
+    if (t->active && t->last && !jf->cmatched[t->clause]) {
+      jf->cmatched[t->clause] = true;
+      ++jf->nmatched;
+    }
+  }
+  return jf->nmatched < jf->nclauses;
+}
+
+static void _jql_fts_match_text(JQFTS *jf, const char *text, size_t len) {
+  for (int i = 0; i < jf->nterms; ++i) {
+    jf->terms[i].active = false;
+  }
+  ftstok_tokenize(text, len, _jql_fts_match_visitor, jf);
+}
+
+static bool _jql_match_fts(JQVAL *left, JQP_OP *jqop, JQVAL *right,
+                           iwrc *rcp) {
+  JQVAL sleft;
+  JQVAL *lv = left;
+  JQFTS *jf = _jql_fts_get(jqop, right, rcp);
+  if (!jf || !jf->nclauses) {
+    return false;
+  }
+  jf->nmatched = 0;
+  memset(jf->cmatched, 0, jf->nclauses * sizeof(*jf->cmatched));
+
+  if (lv->type == JQVAL_JBLNODE) {
+    if (lv->vnode->type == JBV_ARRAY) { // Array of texts
+      for (JBL_NODE n = lv->vnode->child; n && jf->nmatched < jf->nclauses; n = n->next) {
+        if (n->type == JBV_STR) {
+          _jql_fts_match_text(jf, n->vptr, n->vsize);
+        }
+      }
+      return jf->nmatched == jf->nclauses;
+    }
+    _jql_node_to_jqval(lv->vnode, &sleft);
+    lv = &sleft;
+  } else if (lv->type == JQVAL_BINN) {
+    if (lv->vbinn->type == BINN_LIST) { // Array of texts
+      binn bv;
+      binn_iter iter;
+      if (!binn_iter_init(&iter, lv->vbinn, BINN_LIST)) {
+        *rcp = JBL_ERROR_INVALID;
+        return false;
+      }
+      while (jf->nmatched < jf->nclauses && binn_list_next(&iter, &bv)) {
+        if (bv.type == BINN_STRING) {
+          _jql_fts_match_text(jf, bv.ptr, strlen(bv.ptr));
+        }
+      }
+      return jf->nmatched == jf->nclauses;
+    }
+    _jql_binn_to_jqval(lv->vbinn, &sleft);
+    lv = &sleft;
+  }
+  if (lv->type != JQVAL_STR) {
+    *rcp = _JQL_ERROR_UNMATCHED;
+    return false;
+  }
+  _jql_fts_match_text(jf, lv->vstr, strlen(lv->vstr));
+  return jf->nmatched == jf->nclauses;
+}
+
 static bool _jql_match_jqval_pair(JQP_AUX *aux,
                                   JQVAL *left, JQP_OP *jqop, JQVAL *right,
                                   iwrc *rcp) {
   bool match = false;
   jqp_op_t op = jqop->value;
+  char lbuf[256];
+  char *lstr = 0;
+  JQVAL fleft;
+  if (jqop->icase) {
+    right = _jql_icase_right(jqop, right, rcp);
+    if (*rcp) goto finish;
+    left = _jql_icase_left(left, &fleft, lbuf, sizeof(lbuf), &lstr, rcp);
+    if (*rcp) goto finish;
+  }
   if (op >= JQP_OP_EQ && op <= JQP_OP_LTE) {
     int cmp = _jql_cmp_jqval_pair(left, right, rcp);
     if (*rcp) {
@@ -882,12 +1581,16 @@ static bool _jql_match_jqval_pair(JQP_AUX *aux,
       case JQP_OP_NI:
         match = _jql_match_ni(right, jqop, left, rcp);
         break;
+      case JQP_OP_FTS:
+        match = _jql_match_fts(left, jqop, right, rcp);
+        break;
       default:
         break;
     }
   }
 
 finish:
+  free(lstr);
   if (*rcp) {
     if (*rcp == _JQL_ERROR_UNMATCHED) {
       *rcp = 0;
@@ -1221,28 +1924,180 @@ static jbl_visitor_cmd_t _jql_match_visitor(int lvl, binn *bv, const char *key,
   return 0;
 }
 
-iwrc jql_matched(JQL q, JBL jbl, bool *out) {
-  JBL_VCTX vctx = {
-    .bn = &jbl->bn,
-    .op = q
-  };
-  *out = false;
-  jql_reset(q, false, false);
+#define JQL_ROOT_KEYS_MAX 16
+
+static bool _jql_root_keys_add(const char *key, const char **keys, int *nkeys) {
+  for (int i = 0; i < *nkeys; ++i) {
+    if (!strcmp(keys[i], key)) {
+      return true;
+    }
+  }
+  if (*nkeys >= JQL_ROOT_KEYS_MAX) {
+    return false;
+  }
+  keys[(*nkeys)++] = key;
+  return true;
+}
+
+/**
+ * Collects names of top level document fields the query depends on.
+ * Returns false if matching result may depend on other fields or on order of fields
+ * (wildcards, negations, prematched expressions) or if there are too many fields.
+ */
+static bool _jql_root_keys(JQP_EXPR_NODE *en, const char **keys, int *nkeys) {
+  for (en = en->chain; en; en = en->next) {
+    if (en->join && en->join->negate) {
+      return false;
+    }
+    if (en->type == JQP_EXPR_NODE_TYPE) {
+      if (!_jql_root_keys(en, keys, nkeys)) {
+        return false;
+      }
+    } else if (en->type == JQP_FILTER_TYPE) {
+      JQP_NODE *n = ((JQP_FILTER *) en)->node;
+      if (!n) {
+        return false;
+      }
+      if (n->ntype == JQP_NODE_FIELD) {
+        if (n->value->type != JQP_STRING_TYPE || !_jql_root_keys_add(n->value->string.value, keys, nkeys)) {
+          return false;
+        }
+      } else if (n->ntype == JQP_NODE_EXPR && n->value->type == JQP_EXPR_TYPE) {
+        for (JQP_EXPR *expr = &n->value->expr; expr; expr = expr->next) {
+          JQPUNIT *left = expr->left;
+          if (expr->prematched
+              || (expr->join && expr->join->negate)
+              || left->type != JQP_STRING_TYPE
+              || (left->string.flavour & (JQP_STR_STAR | JQP_STR_DBL_STAR))
+              || !_jql_root_keys_add(left->string.value, keys, nkeys)) {
+            return false;
+          }
+        }
+      } else {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Visits only given top level fields of document object.
+ * Fields are fetched directly from object, so sorted keys directory
+ * of wide documents is used if present.
+ */
+static iwrc _jql_match_root_keys(JBL_VCTX *vctx, const char **keys, int nkeys) {
+  iwrc rc = 0;
+  binn bv;
+  for (int i = 0; i < nkeys && !vctx->terminate; ++i) {
+    if (!binn_object_get_value2(vctx->bn, keys[i], strlen(keys[i]), &bv)) {
+      continue;
+    }
+    jbl_visitor_cmd_t cmd = _jql_match_visitor(0, &bv, keys[i], -1, vctx, &rc);
+    RCRET(rc);
+    if (cmd & JBL_VCMD_TERMINATE) {
+      vctx->terminate = true;
+      break;
+    }
+    if (!(cmd & JBL_VCMD_SKIP_NESTED) && BINN_IS_CONTAINER_TYPE(bv.type)) {
+      binn_iter it;
+      if (!binn_iter_init(&it, &bv, bv.type)) {
+        return JBL_ERROR_INVALID;
+      }
+      rc = _jbl_visit(&it, 1, vctx, _jql_match_visitor);
+      RCRET(rc);
+    }
+  }
+  return rc;
+}
+
+bool jql_is_match_all(JQL q) {
   JQP_EXPR_NODE *en = q->aux->expr;
   if (en->chain && !en->chain->next && !en->next) {
     en = en->chain;
     if (en->type == JQP_FILTER_TYPE) {
       JQP_NODE *n = ((JQP_FILTER *) en)->node;
-      if (n && (n->ntype == JQP_NODE_ANYS || n->ntype == JQP_NODE_ANY) && !n->next) {
-        // Single /* | /** matches anything
-        q->matched = true;
-        *out = true;
-        return 0;
+      // Single /* | /** matches anything
+      return n && (n->ntype == JQP_NODE_ANYS || n->ntype == JQP_NODE_ANY) && !n->next;
+    }
+  }
+  return false;
+}
+
+bool jql_implies(JQL q, JQL cond, iwrc *rcp) {
+  iwrc rc = 0;
+  bool ret = false;
+  JQP_EXPR_NODE *en, *cn;
+  IWXSTR *qstr = 0, *cstr = 0;
+  if (jql_is_match_all(cond)) {
+    *rcp = 0;
+    return true;
+  }
+  for (en = q->aux->expr->chain; en; en = en->next) {
+    if (en->join && en->join->value == JQP_JOIN_OR) {
+      goto finish;
+    }
+  }
+  qstr = iwxstr_new();
+  cstr = iwxstr_new();
+  if (!qstr || !cstr) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  for (cn = cond->aux->expr->chain; cn; cn = cn->next) {
+    bool found = false;
+    if (cn->type != JQP_FILTER_TYPE || (cn->join && (cn->join->negate || cn->join->value == JQP_JOIN_OR))) {
+      goto finish;
+    }
+    iwxstr_clear(cstr);
+    rc = jqp_print_filter((JQP_FILTER *) cn, jbl_xstr_json_printer, cstr);
+    RCGO(rc, finish);
+    for (en = q->aux->expr->chain; en && !found; en = en->next) {
+      if (en->type != JQP_FILTER_TYPE || (en->join && en->join->negate)) {
+        continue;
       }
+      iwxstr_clear(qstr);
+      rc = jqp_print_filter((JQP_FILTER *) en, jbl_xstr_json_printer, qstr);
+      RCGO(rc, finish);
+      found = !strcmp(iwxstr_ptr(qstr), iwxstr_ptr(cstr));
+    }
+    if (!found) {
+      goto finish;
     }
   }
+  ret = true;
+
+finish:
+  iwxstr_destroy(qstr);
+  iwxstr_destroy(cstr);
+  *rcp = rc;
+  return ret && !rc;
+}
+
+iwrc jql_matched(JQL q, JBL jbl, bool *out) {
+  JBL_VCTX vctx = {
+    .bn = &jbl->bn,
+    .op = q
+  };
+  *out = false;
+  jql_reset(q, false, false);
+  if (jql_is_match_all(q)) {
+    q->matched = true;
+    *out = true;
+    return 0;
+  }
 
-  iwrc rc = _jbl_visit(0, 0, &vctx, _jql_match_visitor);
+  iwrc rc;
+  int nkeys = 0;
+  const char *keys[JQL_ROOT_KEYS_MAX];
+  if (jbl->bn.type == BINN_OBJECT && _jql_root_keys(q->aux->expr, keys, &nkeys)) {
+    // Order of visited fields does not matter for query without negations
+    rc = _jql_match_root_keys(&vctx, keys, nkeys);
+  } else {
+    rc = _jbl_visit(0, 0, &vctx, _jql_match_visitor);
+  }
   if (vctx.pool) {
     iwpool_destroy(vctx.pool);
   }
@@ -1314,6 +2169,21 @@ iwrc jql_get_limit(JQL q, int64_t *out) {
   return 0;
 }
 
+iwrc jql_get_after(JQL q, const char **out) {
+  iwrc rc = 0;
+  *out = 0;
+  struct JQP_AUX *aux = q->aux;
+  JQPUNIT *after = aux->after;
+  if (!after) return 0;
+  JQVAL *val = _jql_unit_to_jqval(aux, after, &rc);
+  RCRET(rc);
+  if (val->type != JQVAL_STR) {
+    return JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE;
+  }
+  *out = val->vstr;
+  return 0;
+}
+
 // ----------- JQL Projection
 
 #define PROJ_MARK_PATH    1
@@ -1471,6 +2341,37 @@ iwrc jql_apply(JQL q, JBL_NODE root, IWPOOL *pool) {
   }
 }
 
+iwrc jql_apply_ptrs(JQL q, JBL_PTR **ptrsp, int *cntp, IWPOOL *pool) {
+  *ptrsp = 0;
+  *cntp = 0;
+  if (q->aux->apply_placeholder) {
+    JQVAL *pv = _jql_find_placeholder(q, q->aux->apply_placeholder);
+    if (!pv || pv->type != JQVAL_JBLNODE || !pv->vnode) {
+      return JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE;
+    }
+    return jbl_patch_auto_ptrs(pv->vnode, ptrsp, cntp, pool);
+  } else if (q->aux->apply) {
+    return jbl_patch_auto_ptrs(q->aux->apply, ptrsp, cntp, pool);
+  } else {
+    return 0;
+  }
+}
+
+iwrc jql_apply_inplace(JQL q, JBL jbl, IWPOOL *pool, bool *applied) {
+  *applied = false;
+  if (q->aux->apply_placeholder) {
+    JQVAL *pv = _jql_find_placeholder(q, q->aux->apply_placeholder);
+    if (!pv || pv->type != JQVAL_JBLNODE || !pv->vnode) {
+      return JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE;
+    }
+    return jbl_patch_auto_inplace(jbl, pv->vnode, pool, applied);
+  } else if (q->aux->apply) {
+    return jbl_patch_auto_inplace(jbl, q->aux->apply, pool, applied);
+  } else {
+    return 0;
+  }
+}
+
 iwrc jql_project(JQL q, JBL_NODE root) {
   if (q->aux->projection) {
     return _jql_project(root, q);
@@ -1532,6 +2433,11 @@ static const char *_ecodefn(locale_t locale, uint32_t ecode) {
       return "No collection specified in query (JQL_ERROR_NO_COLLECTION)";
     case JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE:
       return "Invalid type of placeholder value (JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE)";
+    case JQL_ERROR_AFTER_ALREADY_SET:
+      return "After clause already specified (JQL_ERROR_AFTER_ALREADY_SET)";
+    case JQL_ERROR_INVALID_AGGREGATE:
+      return "Aggregation cannot be combined with apply, projection, orderby or after clauses "
+             "(JQL_ERROR_INVALID_AGGREGATE)";
     default:
       break;
   }
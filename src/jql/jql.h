@@ -60,6 +60,8 @@ typedef enum {
   JQL_ERROR_ORDERBY_MAX_LIMIT,    /**< Reached max number of asc/desc order clauses: 64 (JQL_ERROR_ORDERBY_MAX_LIMIT) */
   JQL_ERROR_NO_COLLECTION,        /**< No collection specified in query (JQL_ERROR_NO_COLLECTION) */
   JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE, /**< Invalid type of placeholder value (JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE) */
+  JQL_ERROR_AFTER_ALREADY_SET,    /**< After clause already specified (JQL_ERROR_AFTER_ALREADY_SET) */
+  JQL_ERROR_INVALID_AGGREGATE,    /**< Aggregation cannot be combined with apply, projection, orderby or after clauses (JQL_ERROR_INVALID_AGGREGATE) */
   _JQL_ERROR_END,
   _JQL_ERROR_UNMATCHED
 } jql_ecode_t;
@@ -149,8 +151,27 @@ IW_EXPORT iwrc jql_get_skip(JQL q, int64_t *out);
 
 IW_EXPORT iwrc jql_get_limit(JQL q, int64_t *out);
 
+/**
+ * @brief Get query resume token specified by `after` clause.
+ * `out` is set to zero if no `after` clause.
+ */
+IW_EXPORT iwrc jql_get_after(JQL q, const char **out);
+
 IW_EXPORT WUR iwrc jql_apply(JQL q, JBL_NODE root, IWPOOL *pool);
 
+/**
+ * @brief Get JSON pointers to document parts which may be changed by query `apply` clause.
+ * `ptrsp` is set to zero if query has no `apply` clause.
+ * @see jbl_patch_auto_ptrs()
+ */
+IW_EXPORT WUR iwrc jql_apply_ptrs(JQL q, JBL_PTR **ptrsp, int *cntp, IWPOOL *pool);
+
+/**
+ * @brief Apply query `apply` clause directly to the serialized buffer of `jbl` if possible.
+ * @see jbl_patch_auto_inplace()
+ */
+IW_EXPORT WUR iwrc jql_apply_inplace(JQL q, JBL jbl, IWPOOL *pool, bool *applied);
+
 IW_EXPORT WUR iwrc jql_project(JQL q, JBL_NODE root);
 
 IW_EXPORT WUR iwrc jql_apply_and_project(JQL q, JBL jbl, JBL_NODE *out, IWPOOL *pool);
@@ -49,6 +49,19 @@ typedef struct {
 
 JQVAL *jql_unit_to_jqval(JQP_AUX *aux, JQPUNIT *unit, iwrc *rcp);
 
+/**
+ * @brief Returns true if query filter is a single any field node (`*` or `**`) matching any document.
+ */
+bool jql_is_match_all(JQL q);
+
+/**
+ * @brief Returns true if every document matched by query `q` is matched by `cond` query.
+ *
+ * Checked conservatively: every filter of `cond` joined by `and`
+ * must be present among top level `and` filters of `q`.
+ */
+bool jql_implies(JQL q, JQL cond, iwrc *rcp);
+
 jqval_type_t jql_binn_to_jqval(binn *vbinn, JQVAL *qval);
 
 void jql_node_to_jqval(JBL_NODE jn, JQVAL *qv);
@@ -57,5 +70,33 @@ int jql_cmp_jqval_pair(const JQVAL *left, const JQVAL *right, iwrc *rcp);
 
 bool jql_match_jqval_pair(JQP_AUX *aux, JQVAL *left, JQP_OP *jqop, JQVAL *right, iwrc *rcp);
 
+/**
+ * @brief Returns literal prefix of any string matched by `re` operator expression.
+ *
+ * @param aux Query auxiliary data
+ * @param jqop `re` operator
+ * @param right Right side value of `re` expression
+ * @param [out] lenp Length of prefix, zero if expression has no literal prefix
+ */
+const char *jql_regexp_prefix(JQP_AUX *aux, JQP_OP *jqop, JQVAL *right, size_t *lenp, iwrc *rcp);
+
+/**
+ * @brief Returns right side value as it is matched by operation.
+ *
+ * For case insensitive operations (`ieq`, `iin`, `ire`) it is a case folded
+ * copy of `right` value, otherwise `right` value itself.
+ */
+JQVAL *jql_icase_jqval(JQP_OP *jqop, JQVAL *right, iwrc *rcp);
+
+/**
+ * @brief Returns case folded term of `fts` operator query used to lookup full text index.
+ *
+ * @param jqop `fts` operator
+ * @param right Right side value of `fts` expression
+ * @param [out] prefixp Set to `true` if returned term is a word prefix
+ * @return Zero if query has no terms
+ */
+const char *jql_fts_term(JQP_OP *jqop, JQVAL *right, bool *prefixp, iwrc *rcp);
+
 #endif
 
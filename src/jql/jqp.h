@@ -92,6 +92,7 @@ typedef enum { // Do not reorder members
   JQP_OP_IN,
   JQP_OP_NI,
   JQP_OP_RE,
+  JQP_OP_FTS,
 } jqp_op_t;
 
 struct JQP_AUX;
@@ -161,9 +162,11 @@ typedef struct JQP_DOUBLE {
 typedef struct JQP_OP {
   jqp_unit_t type;
   bool negate;
+  bool icase;             /**< Case insensitive operation: `ieq`, `iin`, `ire` */
   jqp_op_t value;
   struct JQP_OP *next;
   void *opaque;
+  void *opaque_icase;     /**< Case folded right value of case insensitive operation */
 } JQP_OP;
 
 typedef struct JQP_JOIN {
@@ -191,6 +194,22 @@ typedef struct JQP_PROJECTION {
   struct JQP_PROJECTION *next;
 } JQP_PROJECTION;
 
+typedef enum {
+  JQP_AGGR_COUNT = 1,
+  JQP_AGGR_SUM,
+  JQP_AGGR_MIN,
+  JQP_AGGR_MAX,
+  JQP_AGGR_AVG,
+  JQP_AGGR_DISTINCT,
+} jqp_aggr_t;
+
+typedef struct JQP_AGGREGATE {
+  jqp_aggr_t fn;                /**< Aggregate function */
+  JQP_STRING *value;            /**< Field path nodes, zero for `count` */
+  JBL_PTR ptr;                  /**< Field pointer, zero for `count` */
+  struct JQP_AGGREGATE *next;
+} JQP_AGGREGATE;
+
 typedef struct JQP_QUERY {
   jqp_unit_t type;
   struct JQP_AUX *aux;
@@ -241,6 +260,7 @@ typedef uint8_t jqp_query_mode_t;
 #define JQP_QRY_NOIDX       ((jqp_query_mode_t) 0x02U)
 #define JQP_QRY_APPLY_DEL   ((jqp_query_mode_t) 0x04U)
 #define JQP_QRY_INVERSE     ((jqp_query_mode_t) 0x08U)
+#define JQP_QRY_GROUP       ((jqp_query_mode_t) 0x10U)
 
 #define JQP_QRY_AGGREGATE (JQP_QRY_COUNT)
 
@@ -249,6 +269,7 @@ typedef struct JQP_AUX {
   int stackn;
   int num_placeholders;
   int orderby_num;                      /**< Number of order-by blocks */
+  int groupby_num;                      /**< Number of group-by fields */
   iwrc rc;
   jmp_buf fatal_jmp;
   const char *buf;
@@ -264,10 +285,14 @@ typedef struct JQP_AUX {
   JQP_STRING *end_placeholder;
   JQP_STRING *orderby;
   JBL_PTR *orderby_ptrs;              /**< Order-by pointers, orderby_num - number of pointers allocated */
+  JQP_STRING *groupby;
+  JBL_PTR *groupby_ptrs;              /**< Group-by pointers, groupby_num - number of pointers allocated */
+  JQP_AGGREGATE *aggregates;          /**< Aggregate functions applied to groups */
   JQP_OP *start_op;
   JQP_OP *end_op;
   JQPUNIT *skip;
   JQPUNIT *limit;
+  JQPUNIT *after;
   JBL_NODE apply;
   const char *apply_placeholder;
   const char *first_anchor;
@@ -288,4 +313,8 @@ iwrc jqp_alloc_orderby_pointers(const JQP_QUERY *q, JBL_PTR *optr, size_t *nptr)
 
 iwrc jqp_print_filter_node_expr(const JQP_EXPR *e, jbl_json_printer pt, void *op);
 
+iwrc jqp_print_filter(const JQP_FILTER *f, jbl_json_printer pt, void *op);
+
+const char *jqp_aggregate_name(jqp_aggr_t fn);
+
 #endif
@@ -70,9 +70,12 @@ void jql_test1_1() {
   for (int i = 11; i <= 13; ++i) {
     _jql_test1_1(i, JQL_ERROR_QUERY_PARSE);
   }
-  for (int i = 14; i <= 19; ++i) {
+  for (int i = 14; i <= 21; ++i) {
     _jql_test1_1(i, 0);
   }
+  _jql_test1_1(22, JQL_ERROR_AFTER_ALREADY_SET);
+  _jql_test1_1(23, 0);
+  _jql_test1_1(24, JQL_ERROR_INVALID_AGGREGATE);
 }
 
 static void _jql_test1_2(const char *jsondata, const char *q, bool match) {
@@ -136,6 +139,31 @@ void jql_test1_2() {
   _jql_test1_2("{'foo':{'bar':22}}", "/[* not re ^fo$]", true);
   _jql_test1_2("{'foo':{'bar':22}}", "/foo/[bar re 22]", true);
   _jql_test1_2("{'foo':{'bar':22}}", "/foo/[bar re \"2+\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"fo+ba\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"foo.*az\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"foo.*ax\"]", false);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"f[a-z]+baz\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"boo|foo\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"^foobarbaz$\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"^foobar$\"]", false);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"^foobar\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"^foo\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"^bar\"]", false);
+  _jql_test1_2("{'foo':'foo'}", "/[foo re \"^foo\"]", true);
+  _jql_test1_2("{'foo':'foobarbaz'}", "/[foo re \"bar\"]", false);
+  _jql_test1_2("{'foo':'foo.bar'}", "/[foo re \"foo\\\\.b\"]", true);
+  // Literal and non literal expressions share the meaning of anchors
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^foo\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^fo.\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^f[o]o\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"foo\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"fo.\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^foo$\"]", false);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^fo.$\"]", false);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^foobar$\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"^fooba.$\"]", true);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"oba\"]", false);
+  _jql_test1_2("{'foo':'foobar'}", "/[foo re \"o.a\"]", false);
 
   // in
   _jql_test1_2("{'foo':{'bar':22}}", "/foo/[bar in [21, \"22\"]]", true);
@@ -143,6 +171,30 @@ void jql_test1_2() {
   _jql_test1_2("{'foo':{'bar':22}}", "/[* in [\"foo\"]]/[bar in [21, 22]]", true);
   _jql_test1_2("{'foo':{'bar':22}}", "/[* not in [\"foo\"]]/[bar in [21, 22]]", false);
 
+  // case insensitive
+  _jql_test1_2("{'foo':'John.Doe@Example.com'}", "/[foo ieq \"john.doe@example.COM\"]", true);
+  _jql_test1_2("{'foo':'John.Doe@Example.com'}", "/[foo ieq \"john.doe@example.co\"]", false);
+  _jql_test1_2("{'foo':'John.Doe@Example.com'}", "/[foo not ieq \"JOHN.DOE@EXAMPLE.COM\"]", false);
+  _jql_test1_2("{'foo':'ÜBER'}", "/[foo ieq \"über\"]", true);
+  _jql_test1_2("{'foo':'Bar'}", "/[foo iin [\"baz\", \"BAR\"]]", true);
+  _jql_test1_2("{'foo':'Bar'}", "/[foo iin [\"baz\", \"bax\"]]", false);
+  _jql_test1_2("{'foo':'FooBarBaz'}", "/[foo ire \"^fOOb.*\"]", true);
+  _jql_test1_2("{'foo':'FooBarBaz'}", "/[foo ire \"^foo\\\\W\"]", false);
+  _jql_test1_2("{'foo':'FooBarBaz'}", "/[foo re \"^foob.*\"]", false);
+
+  // full text
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"quick FOX\"]", true);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"quick dog\"]", false);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"qui* jump*\"]", true);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"jumpss*\"]", false);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"\\\"quick brown\\\" fox\"]", true);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo fts \"\\\"brown quick\\\"\"]", false);
+  _jql_test1_2("{'foo':'The Quick brown fox, jumps!'}", "/[foo not fts \"dog\"]", true);
+  _jql_test1_2("{'foo':'Über Straße'}", "/[foo fts \"über straße\"]", true);
+  _jql_test1_2("{'foo':['red apple', 'green pear']}", "/[foo fts \"apple pear\"]", true);
+  _jql_test1_2("{'foo':['red apple', 'green pear']}", "/[foo fts \"\\\"apple green\\\"\"]", false);
+  _jql_test1_2("{'foo':22}", "/[foo fts \"22\"]", false);
+
   // Array element
   _jql_test1_2("{'tags':['bar', 'foo']}", "/tags/[** in [\"bar\", \"baz\"]]", true);
   _jql_test1_2("{'tags':['bar', 'foo']}", "/tags/[** in [\"zaz\", \"gaz\"]]", false);
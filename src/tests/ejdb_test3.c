@@ -798,6 +798,24 @@ static void ejdb_test3_4() {
   ejdb_list_destroy(&list);
   iwxstr_clear(log);
 
+  // Update {"tags":["boo","gaz","boo"], "n":2}, `zaz` removed, `boo` duplicated
+  rc = put_json2(db, "a3", "{\"tags\": [\"boo\",\"gaz\",\"boo\"],\"n\":2}", &docId);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = jbl_node_from_json("[\"zaz\"]", &qtags, pool);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jql_set_json(q, "tags", 0, qtags);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_list4(db, q, 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log),
+                                "[INDEX] SELECTED STR|5 /tags EXPR1: '** in :tags' "
+                                "INIT: IWKV_CURSOR_EQ"));
+  CU_ASSERT_PTR_NULL(list->first);
+  ejdb_list_destroy(&list);
+  iwxstr_clear(log);
+
   // Remove last
   rc =  ejdb_del(db, "a3", docId);
   CU_ASSERT_EQUAL_FATAL(rc, 0);
@@ -1028,6 +1046,1688 @@ void ejdb_test3_7() {
   CU_ASSERT_EQUAL_FATAL(rc, 0);
 }
 
+// Large `in` arrays are matched using hash set
+void ejdb_test3_8() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_8.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  JBL_NODE n;
+  char buf[64];
+  int64_t count = 0;
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  IWPOOL *pool = iwpool_create(255);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(pool);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 0; i < 100; ++i) {
+    snprintf(buf, sizeof(buf), "{'n':%d,'s':'v%d'}", i, i);
+    rc = put_json(db, "c1", buf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  // Integers, including duplicates and values which are not in collection
+  iwxstr_cat2(xstr, "/[n in [");
+  for (int i = 0; i < 40; ++i) {
+    iwxstr_printf(xstr, "%s%d", (i ? "," : ""), (i % 30) * 2);
+  }
+  iwxstr_cat2(xstr, ",1000,-1]]");
+  rc = jql_create(&q, "c1", iwxstr_ptr(xstr));
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 30);
+  jql_destroy(&q);
+
+  // Strings
+  iwxstr_clear(xstr);
+  iwxstr_cat2(xstr, "/[s in [");
+  for (int i = 0; i < 20; ++i) {
+    iwxstr_printf(xstr, "%s\"v%d\"", (i ? "," : ""), i);
+  }
+  iwxstr_cat2(xstr, ",\"v\"]]");
+  rc = jql_create(&q, "c1", iwxstr_ptr(xstr));
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 20);
+  jql_destroy(&q);
+
+  // Placeholder value replaced between executions
+  rc = jql_create(&q, "c1", "/[n in :?]");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_node_from_json("[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]", &n, pool);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jql_set_json(q, 0, 0, n);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 20);
+
+  rc = jbl_node_from_json("[90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105]", &n, pool);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jql_set_json(q, 0, 0, n);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 10);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwpool_destroy(pool);
+  iwxstr_destroy(xstr);
+}
+
+// `re` queries use index range scan bounded by regexp literal prefix
+void ejdb_test3_9() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_9.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  EJDB_LIST list = 0;
+  const char *names[] = { "abc", "abd", "abcd", "ab", "bcd", "abc1", "ab2", "xabc" };
+  char buf[64];
+  int i;
+
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/name", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    snprintf(buf, sizeof(buf), "{'name':'%s'}", names[i]);
+    rc = put_json(db, "c1", buf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  rc = ejdb_list3(db, "c1", "/[name re \"abc.*\"]", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_GE STEP: IWKV_CURSOR_PREV"));
+  i = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {}
+  CU_ASSERT_EQUAL(i, 3);
+  ejdb_list_destroy(&list);
+  iwxstr_clear(log);
+
+  rc = ejdb_list3(db, "c1", "/[name re \"ab[0-9]\"]", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_GE STEP: IWKV_CURSOR_PREV"));
+  i = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {}
+  CU_ASSERT_EQUAL(i, 1);
+  ejdb_list_destroy(&list);
+  iwxstr_clear(log);
+
+  // No literal prefix, index is not used
+  rc = ejdb_list3(db, "c1", "/[name re \".*bc\"]", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED"));
+  i = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {}
+  CU_ASSERT_EQUAL(i, 5);
+  ejdb_list_destroy(&list);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+static int _ejdb_test3_count(EJDB db, const char *q, IWXSTR *log) {
+  EJDB_LIST list = 0;
+  iwrc rc = ejdb_list3(db, "c1", q, 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  int i = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {}
+  ejdb_list_destroy(&list);
+  return i;
+}
+
+void ejdb_test3_10() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_10.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_FTS | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_MODE);
+
+  rc = put_json(db, "c1", "{'text':'The quick brown fox'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_FTS);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json(db, "c1", "{'text':'Quick, quicker, quickest!'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'text':['Brown dog', 'lazy fox']}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'text':'Slow brown turtle'}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"BROWN\"]", log), 3);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED FTS|"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_EQ"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"brown fox\"]", log), 2);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"\\\"brown fox\\\"\"]", log), 1);
+
+  // Every document is returned once regardless of number of words with matched prefix
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"qui*\"]", log), 2);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_GE"));
+  iwxstr_clear(log);
+
+  // Full text index is not used for ordering
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/* | asc /text", log), 4);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED FTS|"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] SORTER"));
+  iwxstr_clear(log);
+
+  rc = ejdb_patch(db, "c1", "{\"text\":\"Fast red turtle\"}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"brown\"]", log), 2);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"turtle\"]", log), 1);
+
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text fts \"turtle\"]", log), 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+void ejdb_test3_11() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_11.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_I64 | EJDB_IDX_ICASE);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_MODE);
+
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_UNIQUE | EJDB_IDX_STR | EJDB_IDX_ICASE);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json(db, "c1", "{'text':'John.Doe@Example.com'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'text':'jane@example.com'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'text':'JOHN@Example.org'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Case insensitive uniqueness
+  rc = put_json(db, "c1", "{'text':'JANE@EXAMPLE.COM'}");
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text ieq \"john.doe@example.COM\"]", log), 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED UNIQUE|STR|ICASE|"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_EQ"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text iin [\"JANE@example.com\", \"john@example.org\"]]", log), 2);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED UNIQUE|STR|ICASE|"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text ire \"^JOHN.*\"]", log), 2);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "INIT: IWKV_CURSOR_GE STEP: IWKV_CURSOR_PREV"));
+  iwxstr_clear(log);
+
+  // Case insensitive index is not used for ordering
+  EJDB_LIST list = 0;
+  rc = ejdb_list3(db, "c1", "/* | asc /text", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED"));
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first);
+  CU_ASSERT_EQUAL(list->first->id, 3);
+  ejdb_list_destroy(&list);
+  iwxstr_clear(log);
+
+  // Case sensitive operation is not served by case insensitive index
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[text = \"jane@example.com\"]", log), 1);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED"));
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+void ejdb_test3_12() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_12.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/v", EJDB_IDX_F64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  const char *docs[] = {
+    "{'v':-1e10}", "{'v':-1.5}", "{'v':-0.25}", "{'v':0}", "{'v':0.1234567}",
+    "{'v':0.1234568}", "{'v':2.5}", "{'v':1e10}"
+  };
+  for (int i = 0; i < sizeof(docs) / sizeof(docs[0]); ++i) {
+    rc = put_json(db, "c1", docs[i]);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  // Values differ in the seventh digit after decimal point
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[v > 0.1234567]", log), 3);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED F64|"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[v = 0.1234568]", log), 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED F64|"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[v < 0]", log), 3);
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[v >= -1.5] and /[v <= 0.1234567]", log), 4);
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[v > -1e11] | asc /v", log), 8);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED F64|"));
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+void ejdb_test3_13() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_13.db",
+      .oflags = IWKV_TRUNC
+    },
+    .keys_dir_threshold = 4
+  };
+  EJDB db;
+  JBL jbl;
+  int64_t id = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/f4", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'f1':'a','f2':'b','f3':{'n1':1,'n2':2,'n3':3,'n4':4},'f4':10,'f5':[1,2]}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'f1':'b','f2':'c','f3':{'n1':2},'f4':20,'f5':[3]}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'f1':'c','f4':30}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_get(db, "c1", id, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(*(unsigned char *) binn_ptr(&jbl->bn), BINN_OBJECT_IDX);
+  jbl_destroy(&jbl);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f4 >= 20]", log), 2);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|"));
+  iwxstr_clear(log);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/f3/[n4 = 4]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f1 = b] or /f3/[n1 = 1]", log), 2);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f1 = c] and not /[f4 = 30]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/f5/[** = 3]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f2 = c] | asc /f4", log), 1);
+
+  rc = ejdb_patch(db, "c1", "{\"f4\":40, \"f6\":true}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f4 = 40] and /[f6 = true] and /f3/[n3 = 3]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[f4 = 10]", log), 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+void ejdb_test3_14() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_14.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JBL jbl, meta;
+  int64_t id = 0;
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_set_keys_dict(db, "c1", true);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/name", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'name':'a','age':10,'address':{'city':'x','name':'h1'},'tags':[{'name':'t1'}]}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'name':'b','age':20,'address':{'city':'y'}}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_get(db, "c1", id, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(jbl, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr),
+                         "{\"name\":\"a\",\"age\":10,\"address\":{\"city\":\"x\",\"name\":\"h1\"},"
+                         "\"tags\":[{\"name\":\"t1\"}]}");
+  jbl_destroy(&jbl);
+  iwxstr_clear(xstr);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[name = b]", log), 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED STR|"));
+  iwxstr_clear(log);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/address/[city = x]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/tags/*/[name = t1]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[age > 0] | desc /age", log), 2);
+
+  rc = ejdb_patch(db, "c1", "{\"age\":30, \"extra\":true}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"kdict\":true"));
+  jbl_destroy(&meta);
+  iwxstr_clear(xstr);
+
+  // Keys dictionary is loaded on reopen
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[age = 30] and /[extra = true] and /address/[name = h1]", log), 1);
+
+  // Documents stored with and without dictionary coexist
+  rc = ejdb_set_keys_dict(db, "c1", false);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'name':'c','age':40}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[age >= 20]", log), 3);
+
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[name = a]", log), 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+void ejdb_test3_15() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_15.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JBL jbl, meta;
+  int64_t id = 0;
+  char buf[512];
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_set_compression(db, "c1", 64, false);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 0; i < 20; ++i) {
+    snprintf(buf, sizeof(buf),
+             "{'n':%d,'descr':'description description description description','tags':['aaaa','bbbb','aaaa']}", i);
+    rc = put_json(db, "c1", buf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = put_json2(db, "c1", "{'n':100}", &id); // Below compression threshold
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n >= 10]", log), 11);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|"));
+  iwxstr_clear(log);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/tags/[** = bbbb] | desc /n", log), 20);
+
+  rc = ejdb_get(db, "c1", 1, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(jbl, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr),
+                         "{\"n\":0,\"descr\":\"description description description description\","
+                         "\"tags\":[\"aaaa\",\"bbbb\",\"aaaa\"]}");
+  jbl_destroy(&jbl);
+  iwxstr_clear(xstr);
+
+  // Compression dictionary along with keys dictionary
+  rc = ejdb_set_keys_dict(db, "c1", true);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_set_compression(db, "c1", 16, true);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'n':200,'descr':'description description','tags':['aaaa']}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"descr\":\"description of small document\"}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"zthr\":16"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"zdict\":"));
+  jbl_destroy(&meta);
+  iwxstr_clear(xstr);
+
+  // Compression options and dictionary are loaded on reopen
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[descr re small] and /[n = 100]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 200] and /tags/[** = aaaa]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/* | asc /descr", log), 22);
+
+  // Encoded documents are sorted after collection options are reset
+  rc = ejdb_set_keys_dict(db, "c1", false);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_set_compression(db, "c1", 0, false);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/* | desc /n", log), 22);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[descr re small] | asc /descr", log), 1);
+
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n >= 100]", log), 1);
+
+  rc = ejdb_remove_collection(db, "c1");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+void ejdb_test3_16() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_16.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  int64_t id = 0, count;
+  char buf[128];
+  EJDB_LIST list = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Number of matched documents exceeds size of fetch batch
+  for (int i = 0; i < 3 * JB_BATCH_SIZE; ++i) {
+    snprintf(buf, sizeof(buf), "{'n':%d,'s':%d}", i % 2, 3 * JB_BATCH_SIZE - i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_list3(db, "c1", "/[n = 1] | asc /s", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] SORTER"));
+  count = 0;
+  int64_t prev = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++count) {
+    JBL jbl;
+    rc = jbl_at(doc->raw, "/s", &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    int64_t s = jbl_get_i64(jbl);
+    CU_ASSERT_TRUE(s > prev);
+    prev = s;
+    jbl_destroy(&jbl);
+  }
+  CU_ASSERT_EQUAL(count, 3 * JB_BATCH_SIZE / 2 - 1);
+  ejdb_list_destroy(&list);
+
+  rc = jql_create(&q, "c1", "/[n = 0]");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 3 * JB_BATCH_SIZE / 2);
+  rc = ejdb_count(db, q, &count, JB_BATCH_SIZE + 1);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, JB_BATCH_SIZE + 1);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+static iwrc ejdb_test3_17_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
+  int *visits = ux->opaque;
+  visits[doc->id]++;
+  return 0;
+}
+
+static iwrc ejdb_test3_17_pages(EJDB db, const char *query, int *visits, int64_t *count) {
+  JQL q;
+  char after[128] = { 0 };
+  IWXSTR *next = iwxstr_new();
+  if (!next) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  iwrc rc = jql_create(&q, "c1", query);
+  RCGO(rc, finish);
+  *count = 0;
+  do {
+    EJDB_EXEC ux = {
+      .db = db,
+      .q = q,
+      .visitor = ejdb_test3_17_visitor,
+      .opaque = visits,
+      .limit = 7,
+      .after = after[0] ? after : 0,
+      .next = next
+    };
+    rc = ejdb_exec(&ux);
+    RCGO(rc, finish);
+    *count += ux.cnt;
+    if (iwxstr_size(next) >= sizeof(after)) {
+      rc = IW_ERROR_OVERFLOW;
+      goto finish;
+    }
+    memcpy(after, iwxstr_ptr(next), iwxstr_size(next) + 1);
+  } while (after[0]);
+
+finish:
+  jql_destroy(&q);
+  iwxstr_destroy(next);
+  return rc;
+}
+
+void ejdb_test3_17() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_17.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  int64_t id, count;
+  char buf[64];
+  int visits[101] = { 0 };
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/i", EJDB_IDX_I64 | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 100; ++i) {
+    snprintf(buf, sizeof(buf), "{'n':%d,'i':%d}", i % 10, i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  // Collection scan
+  rc = ejdb_test3_17_pages(db, "/*", visits, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 100);
+  for (int i = 1; i <= 100; ++i) {
+    CU_ASSERT_EQUAL(visits[i], 1);
+  }
+
+  // Non unique index scan
+  memset(visits, 0, sizeof(visits));
+  rc = ejdb_test3_17_pages(db, "/[n >= 3]", visits, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 70);
+  for (int i = 1; i <= 100; ++i) {
+    CU_ASSERT_EQUAL(visits[i], (i % 10 >= 3) ? 1 : 0);
+  }
+
+  // Unique index scan
+  memset(visits, 0, sizeof(visits));
+  rc = ejdb_test3_17_pages(db, "/[i < 50]", visits, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 49);
+  for (int i = 1; i <= 100; ++i) {
+    CU_ASSERT_EQUAL(visits[i], (i < 50) ? 1 : 0);
+  }
+
+  // Malformed token
+  rc = jql_create(&q, "c1", "/* | after \"c.x.1\"");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  jql_destroy(&q);
+
+  // Token of collection scan passed to index scan
+  rc = jql_create(&q, "c1", "/[n = 1] | after \"c.n.10\"");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static iwrc ejdb_test3_18_count(EJDB db, const char *query, IWXSTR *log, int64_t *count) {
+  JQL q;
+  iwxstr_clear(log);
+  iwrc rc = jql_create(&q, "c1", query);
+  RCRET(rc);
+  EJDB_EXEC ux = {
+    .db = db,
+    .q = q,
+    .log = log
+  };
+  rc = ejdb_exec(&ux);
+  *count = ux.cnt;
+  jql_destroy(&q);
+  return rc;
+}
+
+void ejdb_test3_18() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_18.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id, count;
+  char buf[64];
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/i", EJDB_IDX_I64 | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 100; ++i) {
+    snprintf(buf, sizeof(buf), "{'n':%d,'i':%d,'m':%d}", i % 10, i, i % 2);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_del(db, "c1", 50);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_test3_18_count(db, "/* | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] NO [COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 99);
+
+  rc = ejdb_test3_18_count(db, "/* | skip 90 limit 5 count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 5);
+
+  rc = ejdb_test3_18_count(db, "/* | skip 95 count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 4);
+
+  rc = ejdb_test3_18_count(db, "/[n = 1] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 10);
+
+  rc = ejdb_test3_18_count(db, "/[n in [1, 2, 3]] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 30);
+
+  rc = ejdb_test3_18_count(db, "/[i = 50] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 0);
+
+  rc = ejdb_test3_18_count(db, "/[i >= 10 and i < 60] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 49);
+
+  rc = ejdb_test3_18_count(db, "/[i > 90]", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] COUNT"));
+  CU_ASSERT_EQUAL(count, 10);
+
+  // Filter is not served by index alone
+  rc = ejdb_test3_18_count(db, "/[n = 1 and m = 1] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] PLAIN"));
+  CU_ASSERT_EQUAL(count, 10);
+
+  rc = ejdb_test3_18_count(db, "/[n = 1] and /[m = 0] | count", log, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] PLAIN"));
+  CU_ASSERT_EQUAL(count, 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+static iwrc ejdb_test3_19_group(EJDB db, const char *query, IWXSTR *log, IWXSTR *xstr, int64_t *count) {
+  EJDB_LIST list = 0;
+  iwxstr_clear(log);
+  iwxstr_clear(xstr);
+  *count = 0;
+  iwrc rc = ejdb_list3(db, "c1", query, 0, log, &list);
+  RCRET(rc);
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++*count) {
+    rc = jbl_as_json(doc->raw, jbl_xstr_json_printer, xstr, 0);
+    RCGO(rc, finish);
+    rc = iwxstr_cat(xstr, "\n", 1);
+    RCGO(rc, finish);
+  }
+
+finish:
+  ejdb_list_destroy(&list);
+  return rc;
+}
+
+void ejdb_test3_19() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_19.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  int64_t id, count;
+  char buf[64];
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/dept", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 30; ++i) {
+    snprintf(buf, sizeof(buf), "{'dept':'%c','sal':%d,'tag':'x'}", "abc"[i % 3], i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  rc = ejdb_test3_19_group(db, "/* | group /dept count sum /sal", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP\n"));
+  CU_ASSERT_EQUAL(count, 3);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "{\"/dept\":\"a\",\"count\":10,\"sum /sal\":165}"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "{\"/dept\":\"b\",\"count\":10,\"sum /sal\":145}"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "{\"/dept\":\"c\",\"count\":10,\"sum /sal\":155}"));
+
+  // Groups are streamed in order of index scan
+  rc = ejdb_test3_19_group(db, "/[dept in [\"a\", \"b\"]] | group /dept min /sal max /sal distinct /tag",
+                           log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP ORDERED"));
+  CU_ASSERT_EQUAL(count, 2);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr),
+                                "{\"/dept\":\"a\",\"min /sal\":3,\"max /sal\":30,\"distinct /tag\":[\"x\"]}"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr),
+                                "{\"/dept\":\"b\",\"min /sal\":1,\"max /sal\":28,\"distinct /tag\":[\"x\"]}"));
+
+  rc = ejdb_test3_19_group(db, "/[sal > 20] | count avg /sal", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 1);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"count\":10,\"avg /sal\":25.5}\n");
+
+  // Aggregates over empty result set
+  rc = ejdb_test3_19_group(db, "/[sal > 100] | count sum /sal", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 1);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"count\":0,\"sum /sal\":null}\n");
+
+  rc = ejdb_test3_19_group(db, "/* | group /dept count skip 1 limit 1", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 1);
+
+  rc = jql_create(&q, "c1", "/* | group /dept asc /sal");
+  CU_ASSERT_EQUAL(rc, JQL_ERROR_INVALID_AGGREGATE);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+void ejdb_test3_20() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_20.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id, count;
+  char buf[64];
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/dept", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/sal", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 30; ++i) {
+    snprintf(buf, sizeof(buf), "{'dept':'%c','sal':%d}", "abc"[i % 3], i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = put_json2(db, "c1", "{'dept':'d','sal':30}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Facet counts are computed from index keys
+  rc = ejdb_test3_19_group(db, "/* | group /dept count", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+  CU_ASSERT_EQUAL(count, 4);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr),
+                         "{\"/dept\":\"a\",\"count\":10}\n"
+                         "{\"/dept\":\"b\",\"count\":10}\n"
+                         "{\"/dept\":\"c\",\"count\":10}\n"
+                         "{\"/dept\":\"d\",\"count\":1}\n");
+
+  rc = ejdb_test3_19_group(db, "/* | group /dept count skip 1 limit 2", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr),
+                         "{\"/dept\":\"b\",\"count\":10}\n"
+                         "{\"/dept\":\"c\",\"count\":10}\n");
+
+  rc = ejdb_test3_19_group(db, "/* | min /sal max /sal", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"min /sal\":1,\"max /sal\":30}\n");
+
+  rc = ejdb_test3_19_group(db, "/** | distinct /dept", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"distinct /dept\":[\"a\",\"b\",\"c\",\"d\"]}\n");
+
+  // Mixed fields and filtered queries are computed from documents
+  rc = ejdb_test3_19_group(db, "/* | min /sal distinct /dept", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "{\"min /sal\":1,\"distinct /dept\":["));
+
+  rc = ejdb_test3_19_group(db, "/[sal > 20] | group /dept count", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP INDEX"));
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+void ejdb_test3_21() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_21.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JBL meta;
+  int64_t id, id3 = 0, count;
+  char buf[64];
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index2(db, "c1", "/amount", EJDB_IDX_I64, "/[status = :s]");
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_FILTER);
+  rc = ejdb_ensure_index2(db, "c1", "/amount", EJDB_IDX_I64, "/[status = active] | limit 1");
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_FILTER);
+  rc = ejdb_ensure_index2(db, "c1", "/amount", EJDB_IDX_I64, "/[status = active]");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index2(db, "c1", "/amount", EJDB_IDX_I64, "/[status = active]");
+  CU_ASSERT_EQUAL(rc, 0);
+  rc = ejdb_ensure_index2(db, "c1", "/amount", EJDB_IDX_I64, "/[status = archived]");
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_MISMATCHED_INDEX_FILTER);
+  rc = ejdb_ensure_index(db, "c1", "/amount", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_MISMATCHED_INDEX_FILTER);
+
+  for (int i = 1; i <= 20; ++i) {
+    snprintf(buf, sizeof(buf), "{'status':'%s','amount':%d}", (i % 4) ? "archived" : "active", i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    if (i == 15) {
+      id3 = id;
+    }
+  }
+
+  // Query implying index filter is served by partial index
+  rc = ejdb_test3_19_group(db, "/[amount > 10] and /[status = active]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|5 /amount"));
+  CU_ASSERT_EQUAL(count, 3);
+
+  rc = ejdb_test3_19_group(db, "/[amount > 10]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED"));
+  CU_ASSERT_EQUAL(count, 10);
+
+  rc = ejdb_test3_19_group(db, "/[status = active] or /[amount > 10]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED"));
+  CU_ASSERT_EQUAL(count, 12);
+
+  // Document enters and leaves partial index on update
+  rc = ejdb_merge_or_put(db, "c1", "{\"status\":\"active\"}", id3);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_test3_19_group(db, "/[status = active] and /[amount > 10]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|6 /amount"));
+  CU_ASSERT_EQUAL(count, 4);
+  rc = ejdb_merge_or_put(db, "c1", "{\"status\":\"archived\"}", id3);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_test3_19_group(db, "/[status = active] and /[amount > 10]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|4 /amount"));
+  CU_ASSERT_EQUAL(count, 2);
+
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"filter\":\"/[status = active]\""));
+  jbl_destroy(&meta);
+
+  // Index filter is loaded on reopen
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'status':'archived','amount':100}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_test3_19_group(db, "/[status = active] and /[amount > 10]", log, xstr, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|4 /amount"));
+  CU_ASSERT_EQUAL(count, 2);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+// Index records are kept in sync by patches touching unrelated or indexed fields
+void ejdb_test3_22() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_22.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id = 0, id2 = 0;
+  EJDB_LIST list = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/a/b", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/tags", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'n':1,'a':{'b':'x'},'tags':['t1','t2'],'cnt':0}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'n':2,'a':{'b':'y'},'tags':['t2'],'cnt':0}", &id2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Unrelated fields
+  rc = ejdb_patch(db, "c1", "[{\"op\":\"increment\", \"path\":\"/cnt\", \"value\":1}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"a\":{\"c\":1}}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 1]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/a/[b = x]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/tags/[** = t1]", log), 1);
+
+  // Indexed fields
+  rc = ejdb_patch(db, "c1", "[{\"op\":\"increment\", \"path\":\"/n\", \"value\":10}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"a\":{\"b\":\"z\"}}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "[{\"op\":\"remove\", \"path\":\"/tags/0\"}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_clear(log);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 1]", log), 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|2 /n"));
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 11]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/a/[b = x]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/a/[b = z]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/tags/[** = t1]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/tags/[** = t2]", log), 2);
+
+  // Query apply
+  rc = ejdb_list3(db, "c1", "/[n = 2] | apply {\"cnt\":5}", 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ejdb_list_destroy(&list);
+  rc = ejdb_list3(db, "c1", "/[n = 2] | apply [{\"op\":\"replace\", \"path\":\"/n\", \"value\":3}]", 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ejdb_list_destroy(&list);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 2]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 3] and /[cnt = 5]", log), 1);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/a/[b = y]", log), 1);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+static void _ejdb_test3_doc_json(EJDB db, int64_t id, IWXSTR *xstr) {
+  JBL jbl;
+  iwxstr_clear(xstr);
+  iwrc rc = ejdb_get(db, "c1", id, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(jbl, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  jbl_destroy(&jbl);
+}
+
+// Fixed size values updated in place and with fallback to document tree patching
+void ejdb_test3_23() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_23.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id = 0;
+  EJDB_LIST list = 0;
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/cnt", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'name':'abc','cnt':250,'f':1.5,'on':true}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_patch(db, "c1", "[{\"op\":\"increment\", \"path\":\"/cnt\", \"value\":5}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"name\":\"xyz\",\"f\":2.5,\"on\":false}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  _ejdb_test3_doc_json(db, id, xstr);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"name\":\"xyz\",\"cnt\":255,\"f\":2.5,\"on\":false}");
+
+  // Value does not fit stored size
+  rc = ejdb_patch(db, "c1", "[{\"op\":\"increment\", \"path\":\"/cnt\", \"value\":1}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"name\":\"abcd\"}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  _ejdb_test3_doc_json(db, id, xstr);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"name\":\"abcd\",\"cnt\":256,\"f\":2.5,\"on\":false}");
+
+  // Query apply
+  rc = ejdb_list3(db, "c1", "/[cnt = 256] | apply [{\"op\":\"increment\", \"path\":\"/cnt\", \"value\":-6}]",
+                  0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first);
+  iwxstr_clear(xstr);
+  rc = jbl_as_json(list->first->raw, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"name\":\"abcd\",\"cnt\":250,\"f\":2.5,\"on\":false}");
+  ejdb_list_destroy(&list);
+
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[cnt = 256]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[cnt = 250]", log), 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|1 /cnt"));
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+// Unique index conflicts are rejected before document is written
+void ejdb_test3_24() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_24.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id = 0, id2 = 0, id3 = 0;
+  IWXSTR *log = iwxstr_new();
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/email", EJDB_IDX_UNIQUE | EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'email':'a@example.com','n':1}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'email':'b@example.com','n':2}", &id2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Document keeps its own unique key on update
+  rc = put_json2(db, "c1", "{'email':'a@example.com','n':3}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'email':'a@example.com','n':4}", &id3);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED);
+  CU_ASSERT_EQUAL(id3, 0);
+  rc = put_json2(db, "c1", "{'email':'a@example.com','n':5}", &id2);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED);
+  rc = ejdb_patch(db, "c1", "{\"email\":\"a@example.com\"}", id2);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_UNIQUE_INDEX_CONSTRAINT_VIOLATED);
+
+  // Rejected documents left no traces
+  _ejdb_test3_doc_json(db, id2, xstr);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\"email\":\"b@example.com\",\"n\":2}");
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/*", log), 2);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n in [4, 5]]", log), 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[n = 2]", log), 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|2 /n"));
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+static void _ejdb_test3_25_listener(EJDB db, EJDB_CHANGE chg, void *op) {
+  IWXSTR *xstr = op;
+  iwrc rc = iwxstr_printf(xstr, "%" PRIu64 " %s %s %" PRId64 " ",
+                          chg->seq, chg->op == EJDB_CHANGE_PUT ? "put" : "del", chg->coll, chg->id);
+  CU_ASSERT_EQUAL(rc, 0);
+  rc = jbl_as_json(chg->doc, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL(rc, 0);
+  rc = iwxstr_cat(xstr, "\n", 1);
+  CU_ASSERT_EQUAL(rc, 0);
+}
+
+// Document changes feed
+void ejdb_test3_25() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_25.db",
+      .oflags = IWKV_TRUNC
+    },
+    .changes_buffer_sz = 3
+  };
+  EJDB db;
+  JQL q;
+  int64_t id = 0;
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_changes_subscribe(db, _ejdb_test3_25_listener, xstr);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'n':1}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"n\":2}", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_patch(db, "c1", "{\"n\":3}", id + 1);
+  CU_ASSERT_EQUAL(rc, IWKV_ERROR_NOTFOUND);
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr),
+                         "1 put c1 1 {\"n\":1}\n"
+                         "2 put c1 1 {\"n\":2}\n"
+                         "3 del c1 1 {\"n\":2}\n");
+
+  for (int i = 1; i <= 5; ++i) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "{'i':%d}", i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  iwxstr_clear(xstr);
+
+  // Only the last changes made by query are kept in changes buffer
+  rc = jql_create(&q, "c1", "/* | apply {\"m\":1}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  EJDB_EXEC ux = {
+    .db = db,
+    .q = q
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  jql_destroy(&q);
+  CU_ASSERT_EQUAL(strncmp(iwxstr_ptr(xstr), "11 put c1 ", 10), 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\n12 put c1 "));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\n13 put c1 "));
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(xstr), "\n14 "));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), ",\"m\":1}\n"));
+
+  rc = ejdb_changes_unsubscribe(db, _ejdb_test3_25_listener, xstr);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_changes_unsubscribe(db, _ejdb_test3_25_listener, xstr);
+  CU_ASSERT_EQUAL(rc, IW_ERROR_NOT_EXISTS);
+  iwxstr_clear(xstr);
+  id = 0;
+  rc = put_json2(db, "c1", "{'n':4}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(iwxstr_size(xstr), 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(xstr);
+}
+
+// Documents expired by TTL index are removed in background
+void ejdb_test3_26() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_26.db",
+      .oflags = IWKV_TRUNC
+    },
+    .ttl_interval_ms = 20
+  };
+  EJDB db;
+  int64_t id;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/exp", EJDB_IDX_STR | EJDB_IDX_TTL);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_MODE);
+  rc = ejdb_ensure_index(db, "c1", "/name", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/exp", EJDB_IDX_I64 | EJDB_IDX_TTL);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // More expired documents than removed by single batch
+  for (int i = 0; i < JB_TTL_BATCH_SIZE + 10; ++i) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "{'name':'a','exp':%d}", 1000 + i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  id = 0;
+  rc = put_json2(db, "c1", "{'name':'b','exp':32503680000000}", &id); // Year 3000
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  id = 0;
+  rc = put_json2(db, "c1", "{'name':'c'}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 0; i < 250 && _ejdb_test3_count(db, "/*", 0) > 2; ++i) {
+    usleep(20 * 1000);
+  }
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/*", 0), 2);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[name = a]", log), 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED STR|"));
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[name in [b, c]]", 0), 2);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+}
+
+void ejdb_test3_27() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_27.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  int64_t id, count;
+  char buf[64];
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64 | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Counters are persisted in the middle and on close
+  for (int i = 0; i < JB_NRECS_SYNC_OPS + 10; ++i) {
+    snprintf(buf, sizeof(buf), "{'n':%d}", i);
+    id = 0;
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = jql_create(&q, "c1", "/*");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, JB_NRECS_SYNC_OPS + 9);
+  jql_destroy(&q);
+
+  JBL meta;
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  snprintf(buf, sizeof(buf), "\"rnum\":%d", JB_NRECS_SYNC_OPS + 9);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), buf));
+  jbl_destroy(&meta);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(xstr);
+}
+
+void ejdb_test3_28() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_28.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  int64_t id;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/name", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c2", "/exp", EJDB_IDX_I64 | EJDB_IDX_TTL);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 3; ++i) {
+    id = 0;
+    rc = put_json2(db, "c1", "{'name':'a'}", &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Collections are loaded on first access
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(_ejdb_test3_count(db, "/[name = a]", log), 3);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED STR|"));
+  id = 0;
+  rc = put_json2(db, "c1", "{'name':'b'}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(id, 4);
+
+  JBL meta;
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"name\":\"c1\",\"dbid\""));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\"name\":\"c2\",\"dbid\""));
+  jbl_destroy(&meta);
+
+  // Removal of collection never accessed after open
+  rc = ejdb_remove_collection(db, "c2");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_clear(xstr);
+  rc = ejdb_get_meta(db, &meta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_as_json(meta, jbl_xstr_json_printer, xstr, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(xstr), "\"name\":\"c2\""));
+  jbl_destroy(&meta);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(xstr);
+  iwxstr_destroy(log);
+}
+
+struct _ejdb_test3_29_ctx {
+  EJDB db;
+  int tid;
+  iwrc rc;
+};
+
+static void *_ejdb_test3_29_worker(void *op) {
+  struct _ejdb_test3_29_ctx *ctx = op;
+  char coll[32];
+  for (int i = 0; !ctx->rc && i < 20; ++i) {
+    int64_t id = 0;
+    snprintf(coll, sizeof(coll), "t%d_%d", ctx->tid, i);
+    ctx->rc = put_json2(ctx->db, coll, "{'a':1}", &id);
+    if (!ctx->rc) {
+      id = 0;
+      ctx->rc = put_json2(ctx->db, "shared", "{'a':1}", &id);
+    }
+  }
+  return 0;
+}
+
+void ejdb_test3_29() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_29.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB db;
+  JQL q;
+  int64_t count;
+  pthread_t threads[4];
+  struct _ejdb_test3_29_ctx ctx[4];
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Collections are created concurrently
+  for (int i = 0; i < 4; ++i) {
+    ctx[i] = (struct _ejdb_test3_29_ctx) {
+      .db = db,
+      .tid = i
+    };
+    CU_ASSERT_EQUAL_FATAL(pthread_create(&threads[i], 0, _ejdb_test3_29_worker, &ctx[i]), 0);
+  }
+  for (int i = 0; i < 4; ++i) {
+    pthread_join(threads[i], 0);
+    CU_ASSERT_EQUAL(ctx[i].rc, 0);
+  }
+
+  rc = jql_create(&q, "shared", "/*");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 80);
+  jql_destroy(&q);
+
+  rc = jql_create(&q, "t3_19", "/*");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 1);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static int64_t _ejdb_test3_30_count(EJDB db) {
+  JQL q;
+  int64_t count = -1;
+  iwrc rc = jql_create(&q, "c1", "/*");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count(db, q, &count, 0);
+  CU_ASSERT_EQUAL(rc, 0);
+  jql_destroy(&q);
+  return count;
+}
+
+void ejdb_test3_30() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_30.db",
+      .oflags = IWKV_TRUNC
+    }
+  };
+  EJDB_OPTS ropts = {
+    .kv = {
+      .path = "ejdb_test3_30_snap.db",
+      .oflags = IWKV_RDONLY
+    }
+  };
+  EJDB db, rdb;
+  int64_t id;
+  uint64_t ts = 0;
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 3; ++i) {
+    id = 0;
+    rc = put_json2(db, "c1", "{'a':1}", &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_snapshot(db, &ts, "ejdb_test3_30_snap.db");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_TRUE(ts > 0);
+
+  // Snapshot is opened read-only while database is written
+  rc = ejdb_open(&ropts, &rdb);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_FALSE(rdb->nrecs_recount); // No writes during snapshot, counters were flushed and marker removed
+  CU_ASSERT_EQUAL(_ejdb_test3_30_count(rdb), 3);
+  id = 0;
+  rc = put_json2(rdb, "c1", "{'a':1}", &id);
+  CU_ASSERT_NOT_EQUAL(rc, 0);
+
+  id = 0;
+  rc = put_json2(db, "c1", "{'a':1}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_snapshot(db, 0, "ejdb_test3_30_snap.db");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Opened snapshot is not affected by the new one
+  CU_ASSERT_EQUAL(_ejdb_test3_30_count(rdb), 3);
+  rc = ejdb_close(&rdb);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_open(&ropts, &rdb);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_FALSE(rdb->nrecs_recount);
+  CU_ASSERT_EQUAL(_ejdb_test3_30_count(rdb), 4);
+  rc = ejdb_close(&rdb);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) return CU_get_error();
@@ -1043,7 +2743,30 @@ int main() {
     (NULL == CU_add_test(pSuite, "ejdb_test3_4", ejdb_test3_4)) ||
     (NULL == CU_add_test(pSuite, "ejdb_test3_5", ejdb_test3_5)) ||
     (NULL == CU_add_test(pSuite, "ejdb_test3_6", ejdb_test3_6)) ||
-    (NULL == CU_add_test(pSuite, "ejdb_test3_7", ejdb_test3_7))
+    (NULL == CU_add_test(pSuite, "ejdb_test3_7", ejdb_test3_7)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_8", ejdb_test3_8)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_9", ejdb_test3_9)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_10", ejdb_test3_10)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_11", ejdb_test3_11)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_12", ejdb_test3_12)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_13", ejdb_test3_13)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_14", ejdb_test3_14)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_15", ejdb_test3_15)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_16", ejdb_test3_16)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_17", ejdb_test3_17)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_18", ejdb_test3_18)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_19", ejdb_test3_19)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_20", ejdb_test3_20)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_21", ejdb_test3_21)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_22", ejdb_test3_22)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_23", ejdb_test3_23)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_24", ejdb_test3_24)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_25", ejdb_test3_25)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_26", ejdb_test3_26)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_27", ejdb_test3_27)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_28", ejdb_test3_28)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_29", ejdb_test3_29)) ||
+    (NULL == CU_add_test(pSuite, "ejdb_test3_30", ejdb_test3_30))
   ) {
     CU_cleanup_registry();
     return CU_get_error();
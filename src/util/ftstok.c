@@ -0,0 +1,157 @@
+#include "ftstok.h"
+#include "utf8proc.h"
+#include <stdint.h>
+
+#define FTSTOK_SEP  0 // Separator
+#define FTSTOK_WORD 1 // Part of word
+#define FTSTOK_IDEO 2 // Standalone ideograph term
+
+static int _ftstok_cp_class(int32_t cp) {
+  if (cp < 0x80) {
+    if (cp < 0) return FTSTOK_SEP;
+    return ((cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z'))
+           ? FTSTOK_WORD : FTSTOK_SEP;
+  }
+  if (cp < 0xC0) {
+    return (cp == 0xAA || cp == 0xB5 || cp == 0xBA) ? FTSTOK_WORD : FTSTOK_SEP;
+  }
+  if (cp == 0xD7 || cp == 0xF7) {
+    return FTSTOK_SEP;
+  }
+  if ((cp >= 0x2000 && cp <= 0x2BFF)      // Punctuation, arrows, math and technical symbols
+      || (cp >= 0x2E00 && cp <= 0x2E7F)   // Supplemental punctuation
+      || (cp >= 0x3000 && cp <= 0x303F)   // CJK symbols and punctuation
+      || (cp >= 0xD800 && cp <= 0xF8FF)   // Surrogates, private use area
+      || (cp >= 0xFE10 && cp <= 0xFE6F)   // Vertical forms, CJK compatibility forms, small forms
+      || (cp >= 0xFF00 && cp <= 0xFF0F)   // Fullwidth punctuation
+      || (cp >= 0xFF1A && cp <= 0xFF20)
+      || (cp >= 0xFF3B && cp <= 0xFF40)
+      || (cp >= 0xFF5B && cp <= 0xFF65)
+      || (cp >= 0xFFF0 && cp <= 0xFFFF)   // Specials
+      || (cp >= 0x1F000 && cp <= 0x1FAFF) // Emoji and pictographs
+     ) {
+    return FTSTOK_SEP;
+  }
+  if ((cp >= 0x2E80 && cp <= 0x2FDF)      // CJK radicals
+      || (cp >= 0x3040 && cp <= 0x9FFF)   // Kana, CJK ideographs
+      || (cp >= 0xF900 && cp <= 0xFAFF)   // CJK compatibility ideographs
+      || (cp >= 0x20000 && cp <= 0x3FFFF)) {
+    return FTSTOK_IDEO;
+  }
+  return FTSTOK_WORD;
+}
+
+/**
+ * Simple case folding of Latin, Greek and Cyrillic alphabets
+ * along with mapping of fullwidth ASCII forms.
+ */
+static int32_t _ftstok_fold(int32_t cp) {
+  if (cp < 0x80) {
+    return (cp >= 'A' && cp <= 'Z') ? cp + 32 : cp;
+  }
+  if (cp < 0x100) {
+    return (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) ? cp + 32 : cp;
+  }
+  if (cp < 0x180) {
+    if ((cp < 0x138 && cp != 0x130) || (cp >= 0x14A && cp < 0x178)) {
+      return cp | 1;
+    } else if ((cp >= 0x139 && cp < 0x149) || (cp >= 0x179 && cp < 0x17F)) {
+      return (cp & 1) ? cp + 1 : cp;
+    } else if (cp == 0x178) {
+      return 0xFF;
+    }
+    return cp;
+  }
+  if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) {
+    return cp + 32;
+  }
+  if (cp == 0x3C2) { // Final sigma
+    return 0x3C3;
+  }
+  if (cp >= 0x400 && cp < 0x410) {
+    return cp + 80;
+  }
+  if (cp >= 0x410 && cp < 0x430) {
+    return cp + 32;
+  }
+  if (cp >= 0xFF10 && cp <= 0xFF19) {
+    return '0' + (cp - 0xFF10);
+  }
+  if (cp >= 0xFF21 && cp <= 0xFF3A) {
+    return 'a' + (cp - 0xFF21);
+  }
+  if (cp >= 0xFF41 && cp <= 0xFF5A) {
+    return 'a' + (cp - 0xFF41);
+  }
+  return cp;
+}
+
+size_t ftstok_casefold(const char *str, size_t len, char *out) {
+  const uint8_t *rp = (const uint8_t *) str, *ep = rp + len;
+  uint8_t *wp = (uint8_t *) out;
+  while (rp < ep) {
+    if (*rp < 0x80) { // Fast path for ASCII
+      *wp++ = (*rp >= 'A' && *rp <= 'Z') ? *rp + 32 : *rp;
+      ++rp;
+      continue;
+    }
+    utf8proc_int32_t cp;
+    utf8proc_ssize_t sz = utf8proc_iterate(rp, ep - rp, &cp);
+    if (sz < 1) {
+      *wp++ = *rp++;
+      continue;
+    }
+    wp += utf8proc_encode_char(_ftstok_fold(cp), wp);
+    rp += sz;
+  }
+  *wp = '\0';
+  return wp - (uint8_t *) out;
+}
+
+void ftstok_tokenize(const char *text, size_t len, FTSTOK_VISITOR visitor, void *op) {
+  char buf[FTSTOK_MAX_TERM_LEN + 1];
+  const uint8_t *rp = (const uint8_t *) text, *ep = rp + len;
+  bool overflow = false;
+  FTSTOK tok = {
+    .term = buf
+  };
+
+#define _FTSTOK_EMIT(end_)                                \
+  if (tok.len || overflow) {                              \
+    if (!overflow) {                                      \
+      buf[tok.len] = '\0';                                \
+      tok.end = (const char *) (end_);                    \
+      if (!visitor(&tok, op)) return;                     \
+    }                                                     \
+    ++tok.pos;                                            \
+    tok.len = 0;                                          \
+    overflow = false;                                     \
+  }
+
+  while (rp < ep) {
+    utf8proc_int32_t cp;
+    utf8proc_ssize_t sz = utf8proc_iterate(rp, ep - rp, &cp);
+    if (sz < 1) {
+      cp = -1;
+      sz = 1;
+    }
+    int cls = _ftstok_cp_class(cp);
+    if (cls != FTSTOK_WORD) {
+      _FTSTOK_EMIT(rp);
+    }
+    if (cls != FTSTOK_SEP) {
+      if (tok.len + 4 > FTSTOK_MAX_TERM_LEN) {
+        overflow = true;
+      } else if (!overflow) {
+        tok.len += utf8proc_encode_char(_ftstok_fold(cp), (utf8proc_uint8_t *) buf + tok.len);
+      }
+    }
+    rp += sz;
+    if (cls == FTSTOK_IDEO) {
+      _FTSTOK_EMIT(rp);
+    }
+  }
+  _FTSTOK_EMIT(rp);
+
+#undef _FTSTOK_EMIT
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef FTSTOK_H
+#define FTSTOK_H
+
+/**************************************************************************************************
+ * EJDB2
+ *
+ * MIT License
+ *
+ * Copyright (c) 2012-2020 Softmotions Ltd <info@softmotions.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Maximal length in bytes of indexed term, longer words are skipped */
+#define FTSTOK_MAX_TERM_LEN 255
+
+/**
+ * @brief Case folds UTF-8 string using the same rules as `ftstok_tokenize()`.
+ *
+ * Folded string is never longer than source one.
+ * Invalid UTF-8 sequences are copied as is.
+ *
+ * @param str Source string
+ * @param len Source string length in bytes
+ * @param out Output buffer, at least `len + 1` bytes
+ * @return Length of zero terminated folded string
+ */
+size_t ftstok_casefold(const char *str, size_t len, char *out);
+
+/** Text token produced by `ftstok_tokenize()` */
+typedef struct FTSTOK {
+  const char *term;   /**< Case folded zero terminated term */
+  size_t len;         /**< Term length in bytes */
+  int pos;            /**< Ordinal position of term in text */
+  const char *end;    /**< Pointer to the first byte after term in source text */
+} FTSTOK;
+
+/**
+ * @brief Visitor of text tokens.
+ * @return `false` to stop tokenization.
+ */
+typedef bool (*FTSTOK_VISITOR)(const FTSTOK *tok, void *op);
+
+/**
+ * @brief Splits UTF-8 text into case folded terms.
+ *
+ * Words are the runs of letters and digits. Every CJK ideograph
+ * is a single term since these scripts have no word separators.
+ * Invalid UTF-8 sequences are treated as separators.
+ *
+ * @param text Text to tokenize, not necessarily zero terminated
+ * @param len Text length in bytes
+ * @param visitor Terms visitor
+ * @param op Opaque data passed to visitor
+ */
+void ftstok_tokenize(const char *text, size_t len, FTSTOK_VISITOR visitor, void *op);
+
+#endif
@@ -0,0 +1,199 @@
+#include "lzb.h"
+#include <string.h>
+
+#define LZB_MINMATCH     4
+#define LZB_LASTLITERALS 5  // The last bytes of block are always literals
+#define LZB_MFLIMIT      12 // The last match must start before this number of bytes from the end of block
+#define LZB_HASH_LOG     12
+#define LZB_SKIP_TRIGGER 6  // Increases search step after each 2^LZB_SKIP_TRIGGER failed probes
+
+// Positions below are offsets within virtual buffer built by dictionary followed by source data
+
+typedef struct {
+  const uint8_t *dict;
+  size_t dictlen;
+  const uint8_t *src;
+} LZBCTX;
+
+static inline uint8_t _lzb_byte(const LZBCTX *c, size_t pos) {
+  return pos < c->dictlen ? c->dict[pos] : c->src[pos - c->dictlen];
+}
+
+static inline uint32_t _lzb_read32(const LZBCTX *c, size_t pos) {
+  uint32_t v;
+  if (pos >= c->dictlen) {
+    memcpy(&v, c->src + pos - c->dictlen, sizeof(v));
+  } else if (pos + sizeof(v) <= c->dictlen) {
+    memcpy(&v, c->dict + pos, sizeof(v));
+  } else {
+    uint8_t b[sizeof(v)];
+    for (size_t i = 0; i < sizeof(v); ++i) {
+      b[i] = _lzb_byte(c, pos + i);
+    }
+    memcpy(&v, b, sizeof(v));
+  }
+  return v;
+}
+
+static inline uint32_t _lzb_hash(uint32_t v) {
+  return (v * 2654435761U) >> (32 - LZB_HASH_LOG);
+}
+
+static size_t _lzb_match_len(const LZBCTX *c, size_t ref, size_t pos, size_t limit) {
+  size_t len = 0;
+  const uint8_t *sp = c->src - c->dictlen;
+  while (ref + len < c->dictlen && pos + len < limit) {
+    if (c->dict[ref + len] != sp[pos + len]) {
+      return len;
+    }
+    ++len;
+  }
+  while (pos + len < limit && sp[ref + len] == sp[pos + len]) {
+    ++len;
+  }
+  return len;
+}
+
+static uint8_t *_lzb_write_len(uint8_t *op, size_t len) {
+  while (len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = (uint8_t) len;
+  return op;
+}
+
+static uint8_t *_lzb_write_seq(const LZBCTX *c, uint8_t *op, size_t anchor, size_t litlen,
+                               size_t offset, size_t mlen) {
+  uint8_t *token = op++;
+  if (litlen >= 15) {
+    *token = 15 << 4;
+    op = _lzb_write_len(op, litlen - 15);
+  } else {
+    *token = (uint8_t) (litlen << 4);
+  }
+  memcpy(op, c->src + anchor - c->dictlen, litlen);
+  op += litlen;
+  if (!mlen) { // Last literals
+    return op;
+  }
+  *op++ = (uint8_t) offset;
+  *op++ = (uint8_t) (offset >> 8);
+  mlen -= LZB_MINMATCH;
+  if (mlen >= 15) {
+    *token |= 15;
+    op = _lzb_write_len(op, mlen - 15);
+  } else {
+    *token |= (uint8_t) mlen;
+  }
+  return op;
+}
+
+size_t lzb_compress(const uint8_t *dict, size_t dictlen, const uint8_t *src, size_t srclen,
+                    uint8_t *dst, size_t dstcap) {
+  if (dstcap < LZB_COMPRESS_BOUND(srclen)) {
+    return 0;
+  }
+  if (dictlen > LZB_MAX_DISTANCE) {
+    dict += dictlen - LZB_MAX_DISTANCE;
+    dictlen = LZB_MAX_DISTANCE;
+  }
+  LZBCTX c = {
+    .dict = dict,
+    .dictlen = dict ? dictlen : 0,
+    .src = src
+  };
+  uint32_t htab[1 << LZB_HASH_LOG] = { 0 }; // Positions + 1
+  uint8_t *op = dst;
+  size_t end = c.dictlen + srclen, pos = c.dictlen, anchor = pos;
+
+  if (srclen >= LZB_MFLIMIT + 1) {
+    size_t mflimit = end - LZB_MFLIMIT, matchlimit = end - LZB_LASTLITERALS;
+    unsigned probes = 0;
+    for (size_t i = 0; i + LZB_MINMATCH <= c.dictlen; ++i) {
+      htab[_lzb_hash(_lzb_read32(&c, i))] = (uint32_t) i + 1;
+    }
+    while (pos < mflimit) {
+      uint32_t h = _lzb_hash(_lzb_read32(&c, pos));
+      size_t ref = htab[h];
+      htab[h] = (uint32_t) pos + 1;
+      if (ref-- && pos - ref <= LZB_MAX_DISTANCE) {
+        size_t mlen = _lzb_match_len(&c, ref, pos, matchlimit);
+        if (mlen >= LZB_MINMATCH) {
+          op = _lzb_write_seq(&c, op, anchor, pos - anchor, pos - ref, mlen);
+          pos += mlen;
+          anchor = pos;
+          probes = 0;
+          if (pos < mflimit) { // Keep position preceding next search
+            htab[_lzb_hash(_lzb_read32(&c, pos - 2))] = (uint32_t) (pos - 2) + 1;
+          }
+          continue;
+        }
+      }
+      pos += 1 + (probes++ >> LZB_SKIP_TRIGGER);
+    }
+  }
+  op = _lzb_write_seq(&c, op, anchor, end - anchor, 0, 0);
+  return op - dst;
+}
+
+ptrdiff_t lzb_decompress(const uint8_t *dict, size_t dictlen, const uint8_t *src, size_t srclen,
+                         uint8_t *dst, size_t dstcap) {
+  const uint8_t *ip = src, *iend = src + srclen;
+  uint8_t *op = dst, *oend = dst + dstcap;
+  if (!dict) {
+    dictlen = 0;
+  }
+  while (ip < iend) {
+    size_t len, offset;
+    uint8_t token = *ip++;
+    // Literals
+    len = token >> 4;
+    if (len == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) return -1;
+        b = *ip++;
+        len += b;
+      } while (b == 255);
+    }
+    if (len > (size_t) (iend - ip) || len > (size_t) (oend - op)) {
+      return -1;
+    }
+    memcpy(op, ip, len);
+    op += len;
+    ip += len;
+    if (ip == iend) { // Last literals
+      break;
+    }
+    // Match
+    if (iend - ip < 2) return -1;
+    offset = ip[0] | ((size_t) ip[1] << 8);
+    ip += 2;
+    len = token & 15;
+    if (len == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) return -1;
+        b = *ip++;
+        len += b;
+      } while (b == 255);
+    }
+    len += LZB_MINMATCH;
+    if (!offset || offset > (size_t) (op - dst) + dictlen || len > (size_t) (oend - op)) {
+      return -1;
+    }
+    if (offset > (size_t) (op - dst)) { // Match starts in dictionary
+      size_t back = offset - (op - dst);
+      const uint8_t *mp = dict + dictlen - back;
+      size_t n = back < len ? back : len;
+      memcpy(op, mp, n);
+      op += n;
+      len -= n;
+    }
+    for (const uint8_t *mp = op - offset; len; --len) { // Overlapped copy
+      *op++ = *mp++;
+    }
+  }
+  return op - dst;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#ifndef LZB_H
+#define LZB_H
+
+/**************************************************************************************************
+ * EJDB2
+ *
+ * MIT License
+ *
+ * Copyright (c) 2012-2020 Softmotions Ltd <info@softmotions.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *************************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Block compression compatible with LZ4 block format.
+ *
+ * Optional dictionary acts as data preceding compressed block,
+ * matches may refer up to 64K bytes back into dictionary.
+ * The same dictionary must be used to decompress the block.
+ */
+
+/** Maximal distance of match, only the last bytes of larger dictionaries are used */
+#define LZB_MAX_DISTANCE 0xFFFFU
+
+/** Worst case size of compressed block for `len` bytes of input data */
+#define LZB_COMPRESS_BOUND(len_) ((len_) + (len_) / 255 + 16)
+
+/**
+ * @brief Compresses `src` into `dst` buffer.
+ *
+ * @param dict    Optional dictionary. Can be zero.
+ * @param dictlen Dictionary length.
+ * @param src     Source data.
+ * @param srclen  Source data length.
+ * @param dst     Output buffer of at least `LZB_COMPRESS_BOUND(srclen)` bytes.
+ * @param dstcap  Size of output buffer.
+ * @return Length of compressed block or zero if `dst` is too small.
+ */
+size_t lzb_compress(const uint8_t *dict, size_t dictlen, const uint8_t *src, size_t srclen,
+                    uint8_t *dst, size_t dstcap);
+
+/**
+ * @brief Decompresses `src` block into `dst` buffer.
+ *
+ * @param dict    Dictionary used to compress block. Can be zero.
+ * @param dictlen Dictionary length.
+ * @param src     Compressed block.
+ * @param srclen  Compressed block length.
+ * @param dst     Output buffer.
+ * @param dstcap  Size of output buffer.
+ * @return Length of decompressed data or `-1` if block is malformed or `dst` is too small.
+ */
+ptrdiff_t lzb_decompress(const uint8_t *dict, size_t dictlen, const uint8_t *src, size_t srclen,
+                         uint8_t *dst, size_t dstcap);
+
+#endif